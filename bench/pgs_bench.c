@@ -0,0 +1,392 @@
+#include "types.h"
+#include "key.h"
+#include <stdio.h>
+#include <time.h>
+
+/*!
+  \file
+  \brief Microbenchmarks of the geometry core library
+
+  Times the hot kernels on synthetic inputs and reports the time and
+  the count of allocations per call. Build and run it with
+  <tt>make USE_PGXS=1 bench</tt>. A name given as argument runs only
+  the benchmarks whose names start with it.
+*/
+
+
+/*!
+  \brief minimal running time of a benchmark in nanoseconds
+*/
+#define BENCH_MIN_NS   200000000.0
+
+/*!
+  \brief count of different inputs of a benchmark
+*/
+#define BENCH_NINPUT   64
+
+
+/*!
+  \brief count of allocations
+*/
+static uint64 bench_nalloc = 0;
+
+/*!
+  \brief count of allocated bytes
+*/
+static uint64 bench_nbytes = 0;
+
+/*!
+  \brief keeps the compiler from removing the results
+*/
+static volatile float8 bench_sink = 0.0;
+
+
+  /*!
+    \brief allocation hook counting the calls
+    \param size size in bytes
+    \return pointer to memory
+  */
+  static void * bench_alloc ( size_t size )
+  {
+    bench_nalloc++;
+    bench_nbytes += size;
+    return malloc ( size ? size : 1 );
+  }
+
+  /*!
+    \brief reallocation hook counting the calls
+    \param ptr  pointer to memory
+    \param size new size in bytes
+    \return pointer to memory
+  */
+  static void * bench_realloc ( void * ptr, size_t size )
+  {
+    bench_nalloc++;
+    bench_nbytes += size;
+    return realloc ( ptr, size ? size : 1 );
+  }
+
+  /*!
+    \brief current time
+    \return time in nanoseconds
+  */
+  static float8 bench_now ( void )
+  {
+    struct timespec ts;
+    clock_gettime ( CLOCK_MONOTONIC, &ts );
+    return ( float8 ) ts.tv_sec * 1.0e9 + ( float8 ) ts.tv_nsec;
+  }
+
+  /*!
+    \brief returns a random number between 0 and 1
+    \return random number
+  */
+  static float8 bench_rand ( void )
+  {
+    return ( float8 ) rand ( ) / ( float8 ) RAND_MAX;
+  }
+
+  /*!
+    \brief returns a random point, equally distributed on the sphere
+    \param p pointer to point
+    \return pointer to point
+  */
+  static SPoint * bench_rand_point ( SPoint * p )
+  {
+    p->lng = PID * bench_rand ( );
+    p->lat = asin ( 2.0 * bench_rand ( ) - 1.0 );
+    return p;
+  }
+
+  /*!
+    \brief Creates a nearly regular polygon around a center
+    \param c   center of polygon
+    \param r   radius in radians
+    \param n   count of vertices
+    \return pointer to polygon
+  */
+  static SPOLY * bench_make_poly ( const SPoint * c, float8 r, int32 n )
+  {
+    SPoint  * v = ( SPoint * ) malloc ( sizeof ( SPoint ) * n );
+    SPOLY   * poly;
+    int32     i;
+
+    for ( i = 0; i < n; i++ ){
+      v[i].lng = c->lng + r * cos ( PID * i / n ) / cos ( c->lat );
+      v[i].lat = c->lat + r * sin ( PID * i / n );
+      spoint_check ( &v[i] );
+    }
+    poly = spherepoly_from_array ( v, n );
+    free ( v );
+    return poly;
+  }
+
+
+/*!
+  \brief the inputs of all benchmarks
+*/
+static struct {
+  SPoint     pt[BENCH_NINPUT];     //!< random points
+  SPoint     near[BENCH_NINPUT];   //!< points near the polygon center
+  SLine      line[BENCH_NINPUT];   //!< random lines up to 20 degrees
+  SCIRCLE    circle[BENCH_NINPUT]; //!< random circles up to 5 degrees
+  SELLIPSE   ell[BENCH_NINPUT];    //!< random ellipses up to 5 degrees
+  SPOLY    * poly;                 //!< the polygon of the current benchmark
+  SPACKED  * packed;               //!< the packed polygon of the current benchmark
+  int32    * keys[1024];           //!< keys for picksplit
+  int32      nkeys;                //!< count of keys for picksplit
+} in;
+
+
+/*!
+  \brief A benchmark case runs its kernel n times
+*/
+typedef void ( * bench_fn ) ( int64 n );
+
+
+  static void bench_spoint_dist ( int64 n )
+  {
+    int64  i;
+    float8 s = 0.0;
+    for ( i = 0; i < n; i++ ){
+      s += spoint_dist ( &in.pt[i % BENCH_NINPUT], &in.pt[( i + 1 ) % BENCH_NINPUT] );
+    }
+    bench_sink += s;
+  }
+
+  static void bench_spoly_contains_point ( int64 n )
+  {
+    int64  i;
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      s += spoly_contains_point ( in.poly, &in.near[i % BENCH_NINPUT] );
+    }
+    bench_sink += s;
+  }
+
+  static void bench_sline_sline_pos ( int64 n )
+  {
+    int64  i;
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      s += sline_sline_pos ( &in.line[i % BENCH_NINPUT], &in.line[( i + 1 ) % BENCH_NINPUT] );
+    }
+    bench_sink += s;
+  }
+
+  static void bench_sellipse_ellipse_pos ( int64 n )
+  {
+    int64  i;
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      s += sellipse_ellipse_pos ( &in.ell[i % BENCH_NINPUT], &in.ell[( i + 1 ) % BENCH_NINPUT] );
+    }
+    bench_sink += s;
+  }
+
+  static void bench_point_gen_key ( int64 n )
+  {
+    int64  i;
+    int32  k[6];
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      s += spherepoint_gen_key ( k, &in.pt[i % BENCH_NINPUT] )[0];
+    }
+    bench_sink += s;
+  }
+
+  static void bench_circle_gen_key ( int64 n )
+  {
+    int64  i;
+    int32  k[6];
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      s += spherecircle_gen_key ( k, &in.circle[i % BENCH_NINPUT] )[0];
+    }
+    bench_sink += s;
+  }
+
+  static void bench_ellipse_gen_key ( int64 n )
+  {
+    int64  i;
+    int32  k[6];
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      s += sphereellipse_gen_key ( k, &in.ell[i % BENCH_NINPUT] )[0];
+    }
+    bench_sink += s;
+  }
+
+  static void bench_line_gen_key ( int64 n )
+  {
+    int64  i;
+    int32  k[6];
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      s += sphereline_gen_key ( k, &in.line[i % BENCH_NINPUT] )[0];
+    }
+    bench_sink += s;
+  }
+
+  static void bench_poly_gen_key ( int64 n )
+  {
+    int64  i;
+    int32  k[6];
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      s += spherepoly_gen_key ( k, in.poly )[0];
+    }
+    bench_sink += s;
+  }
+
+  static void bench_poly_unpack ( int64 n )
+  {
+    int64  i;
+    SPOLY * poly;
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      poly = ( SPOLY * ) spherepoints_unpack ( in.packed );
+      s   += poly->npts;
+      pfree ( poly );
+    }
+    bench_sink += s;
+  }
+
+  static void bench_picksplit ( int64 n )
+  {
+    int64  i;
+    int32  left[1024], right[1024], kl[6], kr[6];
+    int32  nl, nr;
+    int32  s = 0;
+    for ( i = 0; i < n; i++ ){
+      spherekey_picksplit ( in.keys, in.nkeys, left, &nl, right, &nr, kl, kr );
+      s += nl;
+    }
+    bench_sink += s;
+  }
+
+
+  /*!
+    Runs a benchmark with growing counts of calls until it takes
+    BENCH_MIN_NS at least, and prints the time and the allocations
+    per call.
+    \brief runs and reports a benchmark
+    \param name   name of benchmark
+    \param fn     benchmark function
+    \param filter prefix of names to run, NULL runs all
+  */
+  static void bench_run ( const char * name, bench_fn fn, const char * filter )
+  {
+    int64  n = 1;
+    float8 t = 0.0;
+    uint64 na, nb;
+
+    if ( filter && strncmp ( name, filter, strlen ( filter ) ) != 0 ){
+      return;
+    }
+    fn ( 1 );
+    while ( TRUE ){
+      na = bench_nalloc;
+      nb = bench_nbytes;
+      t  = bench_now ( );
+      fn ( n );
+      t  = bench_now ( ) - t;
+      if ( t >= BENCH_MIN_NS || n >= ( ( int64 ) 1 << 40 ) ){
+        break;
+      }
+      /* aim at 1.2 times the minimal time, but grow 100 times at most */
+      n = ( t > 0.0 ) ? ( int64 ) ( n * Min ( 100.0, 1.2 * BENCH_MIN_NS / t ) ) + 1 : n * 100;
+    }
+    printf ( "%-32s %12.1f ns/op %8.2f allocs/op %10.1f B/op %12lld ops\n", name, t / n,
+             ( float8 ) ( bench_nalloc - na ) / n, ( float8 ) ( bench_nbytes - nb ) / n,
+             ( long long ) n );
+    fflush ( stdout );
+  }
+
+
+  int main ( int argc, char ** argv )
+  {
+    static const int32 npoly[]  = { 4, 16, 64, 256 };
+    static const int32 nsplit[] = { 100, 300 };
+    const char * filter = ( argc > 1 ) ? argv[1] : NULL;
+    SPoint  c, p;
+    char    name[64];
+    int32   i, j;
+
+    pgs_core_set_allocator ( bench_alloc, bench_realloc, NULL );
+    srand ( 4711 );
+
+    c.lng = 1.0;
+    c.lat = 0.5;
+    for ( i = 0; i < BENCH_NINPUT; i++ ){
+      bench_rand_point ( &in.pt[i] );
+      /* within twice the polygon radius, half of the points inside */
+      in.near[i].lng = c.lng + ( bench_rand ( ) - 0.5 ) * 0.2 / cos ( c.lat );
+      in.near[i].lat = c.lat + ( bench_rand ( ) - 0.5 ) * 0.2;
+      in.circle[i].center = in.pt[i];
+      in.circle[i].radius = bench_rand ( ) * 5.0 / RADIANS;
+      {
+        SPoint  e;
+        /* lines up to 20 degrees near the polygon center */
+        p.lng = c.lng + ( bench_rand ( ) - 0.5 ) * 0.3;
+        p.lat = c.lat + ( bench_rand ( ) - 0.5 ) * 0.3;
+        e.lng = p.lng + ( bench_rand ( ) - 0.5 ) * 20.0 / RADIANS;
+        e.lat = p.lat + ( bench_rand ( ) - 0.5 ) * 20.0 / RADIANS;
+        sline_from_points ( &in.line[i], &p, &e );
+      }
+      {
+        float8    r1 = bench_rand ( ) * 5.0 / RADIANS;
+        float8    r2 = bench_rand ( ) * r1;
+        SELLIPSE * e;
+        /* keep the pairs near each other so that they may overlap */
+        p.lng = c.lng + ( bench_rand ( ) - 0.5 ) * 0.1;
+        p.lat = c.lat + ( bench_rand ( ) - 0.5 ) * 0.1;
+        e = sellipse_in ( r1, r2, &p, bench_rand ( ) * PI );
+        in.ell[i] = *e;
+        pfree ( e );
+      }
+    }
+
+    bench_run ( "spoint_dist", bench_spoint_dist, filter );
+    for ( i = 0; i < ( int32 ) ( sizeof ( npoly ) / sizeof ( int32 ) ); i++ ){
+      in.poly = bench_make_poly ( &c, 0.1, npoly[i] );
+      sprintf ( name, "spoly_contains_point/%d", npoly[i] );
+      bench_run ( name, bench_spoly_contains_point, filter );
+      pfree ( in.poly );
+    }
+    bench_run ( "sline_sline_pos", bench_sline_sline_pos, filter );
+    bench_run ( "sellipse_ellipse_pos", bench_sellipse_ellipse_pos, filter );
+    bench_run ( "gen_key/point", bench_point_gen_key, filter );
+    bench_run ( "gen_key/circle", bench_circle_gen_key, filter );
+    bench_run ( "gen_key/ellipse", bench_ellipse_gen_key, filter );
+    bench_run ( "gen_key/line", bench_line_gen_key, filter );
+    for ( i = 0; i < ( int32 ) ( sizeof ( npoly ) / sizeof ( int32 ) ); i++ ){
+      in.poly = bench_make_poly ( &c, 0.1, npoly[i] );
+      sprintf ( name, "gen_key/poly/%d", npoly[i] );
+      bench_run ( name, bench_poly_gen_key, filter );
+      /* the precision of 1 milliarcsecond */
+      in.packed = spherepoints_pack ( in.poly->p, in.poly->npts, 1.0 / ( RADIANS * 3600000.0 ) );
+      if ( in.packed ){
+        sprintf ( name, "unpack/poly/%d", npoly[i] );
+        bench_run ( name, bench_poly_unpack, filter );
+        pfree ( in.packed );
+      }
+      pfree ( in.poly );
+    }
+    for ( i = 0; i < ( int32 ) ( sizeof ( nsplit ) / sizeof ( int32 ) ); i++ ){
+      in.nkeys = nsplit[i];
+      for ( j = 0; j < in.nkeys; j++ ){
+        SCIRCLE sc;
+        bench_rand_point ( &sc.center );
+        sc.radius = bench_rand ( ) * 2.0 / RADIANS;
+        in.keys[j] = ( int32 * ) malloc ( KEYSIZE );
+        spherecircle_gen_key ( in.keys[j], &sc );
+      }
+      sprintf ( name, "picksplit/%d", in.nkeys );
+      bench_run ( name, bench_picksplit, filter );
+      for ( j = 0; j < in.nkeys; j++ ){
+        free ( in.keys[j] );
+      }
+    }
+    return 0;
+  }
@@ -0,0 +1,133 @@
+#include "types.h"
+#include <stdio.h>
+
+/*!
+  \file
+  \brief Consistency check of the geometry core library
+
+  The core library and the extension must give the same answers,
+  in particular for values near the precision EPSILON. The file
+  data/test_spherecheck.data holds points near the border of circles
+  and the result of spoint_in_circle computed by the core library.
+  sql/circle.sql checks the @ operator of the server against it, this
+  program checks the core library. Run it with
+  <tt>make USE_PGXS=1 corecheck</tt>. With the option -g it writes
+  new cases to stdout.
+*/
+
+
+/*!
+  \brief count of generated circles
+*/
+#define CHECK_NCIRCLE  100
+
+
+  /*!
+    \brief random number
+    \return value between 0 and 1
+  */
+  static float8 check_rand ( void )
+  {
+    return ( float8 ) rand ( ) / ( float8 ) RAND_MAX;
+  }
+
+  /*!
+    \brief writes one case
+    \param p point
+    \param c circle
+  */
+  static void check_write ( const SPoint * p, const SCIRCLE * c )
+  {
+    printf ( "(%.17g,%.17g)\t<(%.17g,%.17g),%.17g>\t%c\n",
+             p->lng, p->lat, c->center.lng, c->center.lat, c->radius,
+             spoint_in_circle ( p, c ) ? 't' : 'f' );
+  }
+
+  /*!
+    Writes points at distances from the border of the circles, which
+    are a bit larger and smaller than EPSILON.
+    \brief writes new cases
+  */
+  static void check_generate ( void )
+  {
+    static const float8 delta[] = { -1.0e-6, -2.0e-7, -2.0e-9, -5.0e-10,
+                                     5.0e-10, 2.0e-9, 2.0e-7, 1.0e-6 };
+    SCIRCLE c;
+    SPoint  p;
+    float8  d, az, slat;
+    int32   i, k;
+
+    /* the case of the review of the tolerance */
+    p.lng = 1.0885938797878758;
+    p.lat = 0.4007671982716258;
+    c.center.lng = 0.9999997093578867;
+    c.center.lat = 0.49836115123052144;
+    c.radius = 0.1260229769176043;
+    check_write ( &p, &c );
+
+    srand ( 4711 );
+    for ( i = 0; i < CHECK_NCIRCLE; i++ ){
+      c.center.lng = check_rand ( ) * PID;
+      c.center.lat = asin ( 2.0 * check_rand ( ) - 1.0 );
+      c.radius     = check_rand ( ) * PIH;
+      for ( k = 0; k < ( int32 ) ( sizeof ( delta ) / sizeof ( float8 ) ); k++ ){
+        d    = c.radius + delta[k];
+        az   = check_rand ( ) * PID;
+        slat = sin ( c.center.lat ) * cos ( d ) + cos ( c.center.lat ) * sin ( d ) * cos ( az );
+        p.lat = asin ( slat );
+        p.lng = c.center.lng + atan2 ( sin ( az ) * sin ( d ) * cos ( c.center.lat ),
+                                       cos ( d ) - sin ( c.center.lat ) * slat );
+        spoint_check ( &p );
+        check_write ( &p, &c );
+      }
+    }
+  }
+
+  /*!
+    \brief checks the cases of a file
+    \param name file name
+    \return count of differences, -1 on errors
+  */
+  static int32 check_file ( const char * name )
+  {
+    FILE  * f = fopen ( name, "r" );
+    SCIRCLE c;
+    SPoint  p;
+    char    res;
+    int32   n = 0, ndiff = 0;
+
+    if ( f == NULL ){
+      perror ( name );
+      return -1;
+    }
+    while ( fscanf ( f, " (%lf,%lf) <(%lf,%lf),%lf> %c", &p.lng, &p.lat,
+                     &c.center.lng, &c.center.lat, &c.radius, &res ) == 6 ){
+      n++;
+      if ( spoint_in_circle ( &p, &c ) != ( res == 't' ) ){
+        printf ( "line %d: spoint_in_circle differs\n", n );
+        ndiff++;
+      }
+    }
+    if ( ! feof ( f ) || n == 0 ){
+      printf ( "%s: invalid line %d\n", name, n + 1 );
+      ndiff = -1;
+    }
+    fclose ( f );
+    if ( ndiff == 0 ){
+      printf ( "%s: %d cases ok\n", name, n );
+    }
+    return ndiff;
+  }
+
+  int main ( int argc, char ** argv )
+  {
+    if ( argc == 2 && strcmp ( argv[1], "-g" ) == 0 ){
+      check_generate ( );
+      return 0;
+    }
+    if ( argc != 2 ){
+      fprintf ( stderr, "usage: %s -g | file\n", argv[0] );
+      return 2;
+    }
+    return ( check_file ( argv[1] ) == 0 ) ? 0 : 1;
+  }
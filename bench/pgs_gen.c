@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+/*!
+  \file
+  \brief Generator of large synthetic catalogs for the SQL benchmarks
+
+  Writes rows of spherical points, circles or polygons in the text
+  format of COPY to stdout. A part of the objects is grouped in
+  clusters of different sizes and densities, the rest is equally
+  distributed on the sphere. The same arguments always give the same
+  data. Several processes may write parts of a large catalog at once,
+  the clusters are the same in all parts:
+
+  <tt>pgs_gen point 250000000 1 1 & pgs_gen point 250000000 1 250000001</tt>
+
+  The C generator needs no PostgreSQL headers, so it is built without
+  the core library.
+*/
+
+
+#define GEN_PI   3.14159265358979323846    //!< pi
+#define GEN_PID  6.28318530717958647692    //!< 2*pi
+#define GEN_DEG  0.01745329251994329577    //!< pi/180
+
+/*!
+  \brief share of objects in clusters
+*/
+#define GEN_CLUSTERED  0.7
+
+/*!
+  \brief the type of generated objects
+*/
+typedef enum {
+  GEN_POINT   = 0 , //!< spoint
+  GEN_CIRCLE  = 1 , //!< scircle
+  GEN_POLYGON = 2   //!< spoly
+} gen_type;
+
+/*!
+  \brief a cluster of objects
+*/
+typedef struct {
+  double  lng,   //!< longitude of center
+          lat,   //!< latitude of center
+          sigma; //!< dispersion in radians
+} gen_cluster;
+
+/*!
+  \brief state of the random generator
+*/
+static uint64_t gen_state = 0;
+
+
+  /*!
+    \brief returns the next random number ( splitmix64 )
+    \return random number
+  */
+  static uint64_t gen_next ( void )
+  {
+    uint64_t z = ( gen_state += 0x9E3779B97F4A7C15ULL );
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+    return z ^ ( z >> 31 );
+  }
+
+  /*!
+    \brief returns a random number in [0,1)
+    \return random number
+  */
+  static double gen_rand ( void )
+  {
+    return ( double ) ( gen_next ( ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+  }
+
+  /*!
+    \brief returns a normal distributed random number
+    \return random number
+  */
+  static double gen_gauss ( void )
+  {
+    double u = 1.0 - gen_rand ( );
+    return sqrt ( -2.0 * log ( u ) ) * cos ( GEN_PID * gen_rand ( ) );
+  }
+
+  /*!
+    \brief returns a random position, equally distributed on the sphere
+    \param lng longitude
+    \param lat latitude
+  */
+  static void gen_uniform ( double * lng, double * lat )
+  {
+    *lng = GEN_PID * gen_rand ( );
+    *lat = asin ( 2.0 * gen_rand ( ) - 1.0 );
+  }
+
+  /*!
+    Moves a position by dx along the parallel and by dy along the
+    meridian in the tangent plane and projects it back to the sphere,
+    so that there are no problems at the poles.
+    \brief offsets a position
+    \param lng longitude of position and result
+    \param lat latitude of position and result
+    \param dx  offset in radians
+    \param dy  offset in radians
+  */
+  static void gen_offset ( double * lng, double * lat, double dx, double dy )
+  {
+    double sl = sin ( *lng ), cl = cos ( *lng );
+    double sb = sin ( *lat ), cb = cos ( *lat );
+    double x  = cb * cl - dx * sl - dy * sb * cl;
+    double y  = cb * sl + dx * cl - dy * sb * sl;
+    double z  = sb + dy * cb;
+    double r  = sqrt ( x * x + y * y + z * z );
+    *lng = atan2 ( y, x );
+    if ( *lng < 0.0 ){
+      *lng += GEN_PID;
+    }
+    *lat = asin ( z / r );
+  }
+
+
+  /*!
+    \brief prints the usage
+    \param name name of program
+  */
+  static void gen_usage ( const char * name )
+  {
+    fprintf ( stderr,
+      "usage: %s point|circle|polygon <count> [seed [first id [clusters]]]\n\n"
+      "Writes <count> rows \"id<TAB>object\" for COPY to stdout, the ids\n"
+      "start at <first id> ( default 1 ). %.0f%% of the objects are in\n"
+      "<clusters> clusters ( default 1000 ) with dispersions from 0.05 to\n"
+      "2 degrees and sizes following Zipf's law, the others are equally\n"
+      "distributed. Circles have radii from 1 arc second to 1 degree,\n"
+      "polygons 4 to 12 vertices and sizes from 0.01 to 1 degree.\n",
+      name, GEN_CLUSTERED * 100.0 );
+  }
+
+
+  int main ( int argc, char ** argv )
+  {
+    gen_type      type;
+    long long     count, first = 1, i;
+    unsigned long seed = 1;
+    int           nclusters = 1000;
+    gen_cluster * cl;
+    double      * cum;
+    double        lng, lat, r;
+    int           k, lo, hi, n;
+
+    if ( argc < 3 ){
+      gen_usage ( argv[0] );
+      return 1;
+    }
+    if ( strcmp ( argv[1], "point" ) == 0 ){
+      type = GEN_POINT;
+    } else if ( strcmp ( argv[1], "circle" ) == 0 ){
+      type = GEN_CIRCLE;
+    } else if ( strcmp ( argv[1], "polygon" ) == 0 ){
+      type = GEN_POLYGON;
+    } else {
+      gen_usage ( argv[0] );
+      return 1;
+    }
+    count = atoll ( argv[2] );
+    if ( argc > 3 ) seed      = strtoul ( argv[3], NULL, 10 );
+    if ( argc > 4 ) first     = atoll ( argv[4] );
+    if ( argc > 5 ) nclusters = atoi ( argv[5] );
+    if ( nclusters < 1 ){
+      nclusters = 1;
+    }
+
+    /* the clusters depend on the seed only */
+    gen_state = seed;
+    cl  = ( gen_cluster * ) malloc ( sizeof ( gen_cluster ) * nclusters );
+    cum = ( double * ) malloc ( sizeof ( double ) * nclusters );
+    for ( k = 0; k < nclusters; k++ ){
+      gen_uniform ( &cl[k].lng, &cl[k].lat );
+      cl[k].sigma = 0.05 * GEN_DEG * pow ( 40.0, gen_rand ( ) );
+      cum[k] = ( ( k > 0 ) ? cum[k - 1] : 0.0 ) + 1.0 / ( k + 1 );
+    }
+
+    /* the objects depend on the seed and the first id */
+    gen_state = seed * 0x2545F4914F6CDD1DULL + ( uint64_t ) first;
+    setvbuf ( stdout, NULL, _IOFBF, 1 << 20 );
+
+    for ( i = first; i < first + count; i++ ){
+      if ( gen_rand ( ) < GEN_CLUSTERED ){
+        /* binary search of cluster by its weight */
+        r  = gen_rand ( ) * cum[nclusters - 1];
+        lo = 0;
+        hi = nclusters - 1;
+        while ( lo < hi ){
+          k = ( lo + hi ) / 2;
+          if ( cum[k] < r ) lo = k + 1; else hi = k;
+        }
+        lng = cl[lo].lng;
+        lat = cl[lo].lat;
+        gen_offset ( &lng, &lat, gen_gauss ( ) * cl[lo].sigma, gen_gauss ( ) * cl[lo].sigma );
+      } else {
+        gen_uniform ( &lng, &lat );
+      }
+
+      switch ( type ){
+        case GEN_POINT:
+          printf ( "%lld\t(%.10f,%.10f)\n", i, lng, lat );
+          break;
+        case GEN_CIRCLE:
+          r = GEN_DEG / 3600.0 * pow ( 3600.0, gen_rand ( ) );
+          printf ( "%lld\t<(%.10f,%.10f),%.10f>\n", i, lng, lat, r );
+          break;
+        case GEN_POLYGON:
+          /* star shaped, so that the edges do not cross */
+          n = 4 + ( int ) ( gen_rand ( ) * 9.0 );
+          r = 0.01 * GEN_DEG * pow ( 100.0, gen_rand ( ) );
+          printf ( "%lld\t{", i );
+          for ( k = 0; k < n; k++ ){
+            double a   = GEN_PID * ( k + 0.8 * gen_rand ( ) ) / n;
+            double rk  = r * ( 0.6 + 0.4 * gen_rand ( ) );
+            double vl  = lng, vb = lat;
+            gen_offset ( &vl, &vb, rk * cos ( a ), rk * sin ( a ) );
+            printf ( ( k > 0 ) ? ",(%.10f,%.10f)" : "(%.10f,%.10f)", vl, vb );
+          }
+          printf ( "}\n" );
+          break;
+      }
+    }
+
+    free ( cl );
+    free ( cum );
+    return ( fflush ( stdout ) == 0 ) ? 0 : 1;
+  }
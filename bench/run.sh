@@ -0,0 +1,117 @@
+#!/bin/sh
+#
+# End-to-end SQL benchmarks of pgSphere, see "SQL benchmarks" in the
+# installation chapter of the documentation.
+#
+# Loads synthetic catalogs written by bench/pgs_gen with COPY and runs
+# the pgbench scripts of bench/sql with and without spatial indexes.
+# The results are appended to $OUT/results.csv:
+#
+#   script,index,clients,transactions,tps,p50_ms,p90_ms,p99_ms,max_ms
+#
+# Settings by environment variables, the defaults in brackets:
+#
+#   PGDATABASE etc.  connection of psql and pgbench
+#   NPOINT    points of bench_point           [10000000]
+#   NCIRCLE   circles of bench_circle         [1000000]
+#   NPOLY     polygons of bench_poly          [100000]
+#   PARTS     parallel generators and COPYs   [4]
+#   SEED      seed of the catalogs            [1]
+#   CLIENTS   pgbench clients                 [4]
+#   DURATION  seconds per pgbench run         [60]
+#   SCRIPTS   pgbench scripts to run          [cone poly knn xmatch]
+#             the script "copy" loads a file by COPY on the server, so
+#             the server must run on this host and the user needs the
+#             role pg_read_server_files
+#   NOINDEX   run without indexes, if set to 1; the sequential scans
+#             are slow on large catalogs      [0]
+#   LOAD      create and load the tables      [1]
+#   OUT       directory of results            [bench/results]
+
+set -e
+
+BENCH=`dirname "$0"`
+NPOINT=${NPOINT:-10000000}
+NCIRCLE=${NCIRCLE:-1000000}
+NPOLY=${NPOLY:-100000}
+PARTS=${PARTS:-4}
+SEED=${SEED:-1}
+CLIENTS=${CLIENTS:-4}
+DURATION=${DURATION:-60}
+SCRIPTS=${SCRIPTS:-"cone poly knn xmatch"}
+NOINDEX=${NOINDEX:-0}
+LOAD=${LOAD:-1}
+OUT=${OUT:-$BENCH/results}
+GEN=$BENCH/pgs_gen
+
+mkdir -p "$OUT"
+[ -f "$OUT/results.csv" ] || \
+  echo "script,index,clients,transactions,tps,p50_ms,p90_ms,p99_ms,max_ms" > "$OUT/results.csv"
+
+now() {
+  date +%s.%N
+}
+
+# load TABLE TYPE COUNT: loads COUNT objects with PARTS parallel COPYs
+# and prints the rows per second
+load() {
+  start=`now`
+  part=0
+  while [ $part -lt $PARTS ]; do
+    first=`expr $3 / $PARTS \* $part + 1`
+    if [ $part -eq `expr $PARTS - 1` ]; then
+      n=`expr $3 - $first + 1`
+    else
+      n=`expr $3 / $PARTS`
+    fi
+    "$GEN" $2 $n $SEED $first | psql -q -X -c "COPY $1 FROM STDIN" &
+    part=`expr $part + 1`
+  done
+  wait
+  end=`now`
+  echo "$1: $3 rows" `echo "$start $end $3" | awk '{ printf( "in %.1f s, %.0f rows/s", $2 - $1, $3 / ( $2 - $1 ) ) }'`
+}
+
+# run SCRIPT INDEX: runs a pgbench script and appends the throughput
+# and the latency percentiles of the transaction log to the results
+run() {
+  rm -f "$OUT/$1_$2".log*
+  pgbench -n -c $CLIENTS -j $CLIENTS -T $DURATION \
+    -D npoint=$NPOINT -D ncircle=$NCIRCLE -D npoly=$NPOLY -D copyfile="'$COPYFILE'" \
+    -f "$BENCH/sql/$1.pgbench" -l --log-prefix="$OUT/$1_$2.log" \
+    > "$OUT/$1_$2.out" 2>&1
+  tps=`sed -n 's/^tps = \([0-9.]*\).*/\1/p' "$OUT/$1_$2.out" | head -1`
+  # the third column is the latency in microseconds
+  cat "$OUT/$1_$2".log* | awk '{ print $3 }' | sort -n | awk -v script=$1 \
+    -v idx=$2 -v clients=$CLIENTS -v tps=$tps '
+    { v[NR] = $1 }
+    END {
+      if ( NR == 0 ) { printf( "%s,%s,%d,0,0,,,,\n", script, idx, clients ); exit; }
+      printf( "%s,%s,%d,%d,%.1f,%.3f,%.3f,%.3f,%.3f\n", script, idx, clients, NR, tps,
+              v[int(NR*0.50)+1]/1000.0, v[int(NR*0.90)+1]/1000.0,
+              v[int(NR*0.99)+1]/1000.0, v[NR]/1000.0 );
+    }' | tee -a "$OUT/results.csv"
+}
+
+if [ "$LOAD" = "1" ]; then
+  psql -q -X -f "$BENCH/sql/schema.sql"
+  load bench_point  point   $NPOINT
+  load bench_circle circle  $NCIRCLE
+  load bench_poly   polygon $NPOLY
+fi
+
+COPYFILE=`cd "$OUT" && pwd`/copy.data
+"$GEN" point 10000 $SEED > "$COPYFILE"
+
+psql -q -X -f "$BENCH/sql/index.sql"
+for s in $SCRIPTS; do
+  run $s index
+done
+
+if [ "$NOINDEX" = "1" ]; then
+  psql -q -X -f "$BENCH/sql/noindex.sql"
+  for s in $SCRIPTS; do
+    run $s noindex
+  done
+  psql -q -X -f "$BENCH/sql/index.sql"
+fi
@@ -0,0 +1,5 @@
+-- spatial indexes of the SQL benchmarks
+CREATE INDEX IF NOT EXISTS bench_point_idx  ON bench_point  USING gist ( p );
+CREATE INDEX IF NOT EXISTS bench_circle_idx ON bench_circle USING gist ( c );
+CREATE INDEX IF NOT EXISTS bench_poly_idx   ON bench_poly   USING gist ( p );
+VACUUM ANALYZE bench_point, bench_circle, bench_poly;
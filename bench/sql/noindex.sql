@@ -0,0 +1,4 @@
+-- removes the spatial indexes, the primary keys are used to pick
+-- the search centers and stay
+DROP INDEX IF EXISTS bench_point_idx, bench_circle_idx, bench_poly_idx;
+VACUUM ANALYZE bench_point, bench_circle, bench_poly;
@@ -0,0 +1,6 @@
+-- tables of the SQL benchmarks, see bench/run.sh
+DROP TABLE IF EXISTS bench_point, bench_circle, bench_poly, bench_copy;
+CREATE TABLE bench_point  ( id int8 PRIMARY KEY, p spoint  );
+CREATE TABLE bench_circle ( id int8 PRIMARY KEY, c scircle );
+CREATE TABLE bench_poly   ( id int8 PRIMARY KEY, p spoly   );
+CREATE UNLOGGED TABLE bench_copy ( id int8, p spoint );
@@ -4,6 +4,8 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
   PG_FUNCTION_INFO_V1(spherebox_in);
+  PG_FUNCTION_INFO_V1(spherebox_recv);
+  PG_FUNCTION_INFO_V1(spherebox_send);
   PG_FUNCTION_INFO_V1(spherebox_in_from_points);
   PG_FUNCTION_INFO_V1(spherebox_sw);
   PG_FUNCTION_INFO_V1(spherebox_ne);
@@ -75,6 +77,12 @@
   PG_FUNCTION_INFO_V1(spherebox_cont_box_com_neg);
   PG_FUNCTION_INFO_V1(spherebox_overlap_box);
   PG_FUNCTION_INFO_V1(spherebox_overlap_box_neg);
+  PG_FUNCTION_INFO_V1(spherebox_bound_add_point);
+  PG_FUNCTION_INFO_V1(spherebox_bound_add_box);
+  PG_FUNCTION_INFO_V1(spherebox_bound_combine);
+  PG_FUNCTION_INFO_V1(spherebox_bound_serialize);
+  PG_FUNCTION_INFO_V1(spherebox_bound_deserialize);
+  PG_FUNCTION_INFO_V1(spherebox_bound_finalize);
 
 #endif
 
@@ -85,7 +93,7 @@
     \brief Checks the box (input)
     \param box pointer to spherical box
   */
-  static void sbox_check ( SBOX * box )
+  PGS_KERNEL void sbox_check ( SBOX * box )
   {
     if ( FPgt( box->sw.lat, box->ne.lat ) )
     {
@@ -126,7 +134,7 @@
     \param sb pointer to a box
     \return relationship as a \link PGS_BOX_CIRCLE_REL int8 value \endlink (\ref  PGS_BOX_CIRCLE_REL )
   */
-  static int8 sbox_circle_pos ( const SCIRCLE * sc , const SBOX * sb )
+  PGS_KERNEL int8 sbox_circle_pos ( const SCIRCLE * sc , const SBOX * sb )
   {
     if ( FPlt( ( sc->center.lat + sc->radius ), sb->sw.lat ) ){
       return PGS_BOX_CIRCLE_AVOID;
@@ -172,10 +180,10 @@
          ( ( sc->center.lat - sc->radius ) >= sb->sw.lat );
       bool bcc = sbox_cont_point ( sb, &sc->center ) ;
       bool ccb = FALSE;
-      static int8 pw, pe;
-      static SLine   bw, be ; // west and east boundary
-      static SPoint  bc;
-      static SPoint p1,p2 ;
+      int8 pw, pe;
+      SLine   bw, be ; // west and east boundary
+      SPoint  bc;
+      SPoint p1,p2 ;
 
       //center
       sbox_center ( &bc, sb );
@@ -245,11 +253,11 @@
   static int8 sbox_line_pos ( const SLine * sl , const SBOX * sb )
   {
 
-    static SPoint p1,p2, pbg, ped ;
-    static SPoint lc[4] ;
-    static int8 pw, pe, lcn, lcs ;
-    static SLine bw, be;
-    static float8 minlat, maxlat ;
+    SPoint p1,p2, pbg, ped ;
+    SPoint lc[4] ;
+    int8 pw, pe, lcn, lcs ;
+    SLine bw, be;
+    float8 minlat, maxlat ;
 
     sline_begin( &pbg, sl );
     sline_end  ( &ped, sl );
@@ -366,8 +374,8 @@
 
     if ( pw && pe )
     {
-       static SPoint sp;
-       static int i ;
+       SPoint sp;
+       int i ;
 
        for ( i=0; i<lcn ; i++ )
        {
@@ -416,12 +424,12 @@
     \param box  pointer to box
     \return relationship as a \link PGS_BOX_PATH_REL int8 value \endlink (\ref PGS_BOX_PATH_REL )
   */
-  static int8  sbox_path_pos ( const SPATH * path , const SBOX * box )
+  PGS_KERNEL int8  sbox_path_pos ( const SPATH * path , const SBOX * box )
   {
-     static int8    pos;
-     static int32     i;
-     static SLine    sl;
-     static int32     n;
+     int8    pos;
+     int32     i;
+     SLine    sl;
+     int32     n;
      static const int8 sb_in = ( 1 << PGS_BOX_CONT_LINE  );
      static const int8 sb_ov = ( 1 << PGS_BOX_LINE_OVER  );
      static const int8 sb_os = ( 1 << PGS_BOX_LINE_AVOID );
@@ -465,7 +473,7 @@
     \param box  pointer to box
     \return relationship as a \link PGS_BOX_POLY_REL int8 value \endlink (\ref PGS_BOX_POLY_REL )
   */
-  static int8  sbox_poly_pos ( const SPOLY * poly, const SBOX * box )
+  PGS_KERNEL int8  sbox_poly_pos ( const SPOLY * poly, const SBOX * box )
   {
   
      int8    pos = 0;
@@ -520,12 +528,12 @@
     \param box pointer to a box
     \return relationship as a \link PGS_BOX_ELLIPSE_REL int8 value \endlink (\ref  PGS_BOX_ELLIPSE_REL )
   */
-  static int8 sbox_ellipse_pos ( const SELLIPSE * ell , const SBOX * box )
+  PGS_KERNEL int8 sbox_ellipse_pos ( const SELLIPSE * ell , const SBOX * box )
   {
-    static SCIRCLE sco, sci;
-    static SPoint ec ;
-    static int8 pw, pe, po, pi;
-    static SLine bw, be; 
+    SCIRCLE sco, sci;
+    SPoint ec ;
+    int8 pw, pe, po, pi;
+    SLine bw, be; 
 
     if ( spoint_eq( &box->sw, &box->ne) ){
       bool scp = sellipse_cont_point ( ell , &box->sw );
@@ -646,7 +654,7 @@
       return PGS_BOX_ELLIPSE_AVOID;
 
     } else {
-      static SPoint p1, p2 ;
+      SPoint p1, p2 ;
 
       // create east/west boundaries
       p1.lat = box->sw.lat;
@@ -682,12 +690,12 @@
     \param recheck if true, swap b1 and b2
     \return relationship as a \link PGS_BOX_REL int8 value \endlink (\ref  PGS_BOX_REL )
   */
-  static int8 sbox_box_pos ( const SBOX * b1 , const SBOX * b2 , bool recheck)
+  PGS_KERNEL int8 sbox_box_pos ( const SBOX * b1 , const SBOX * b2 , bool recheck)
   {
-    static SPoint p1,p2, bc ;
-    static int8  pw, pe;
-    static SLine bw, be;
-    static bool scp; 
+    SPoint p1,p2, bc ;
+    int8  pw, pe;
+    SLine bw, be;
+    bool scp; 
 
     if ( spoint_eq( &b2->sw, &b2->ne) ){
       scp = sbox_cont_point( b1, &b2->sw );
@@ -766,19 +774,15 @@
   }
 
 
+#ifndef PGS_CORE
   Datum  spherebox_in(PG_FUNCTION_ARGS)
   {
     SBOX * box = (SBOX *) MALLOC ( sizeof ( SBOX ) );
     char  * c  = PG_GETARG_CSTRING(0);
+    SParseBuffer * pb = sphere_parse ( c );
 
-    void sphere_yyparse( void );
-
-    init_buffer ( c );
-    sphere_yyparse() ;
-
-    if ( ! get_box ( &box->sw.lng, &box->sw.lat, &box->ne.lng, &box->ne.lat ) ){
+    if ( ! get_box ( pb, &box->sw.lng, &box->sw.lat, &box->ne.lng, &box->ne.lat ) ){
 
-      reset_buffer();
       FREE( box );
       elog ( ERROR , "spherebox_in: wrong data type" );
       PG_RETURN_NULL();
@@ -787,12 +791,37 @@
     spoint_check ( &box->sw );
     spoint_check ( &box->ne );
     sbox_check( box );
-    reset_buffer();
+    free_buffer ( pb );
+
+    PG_RETURN_POINTER( box );
+  }
+
+
+  Datum  spherebox_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SBOX     * box = ( SBOX * ) MALLOC ( sizeof ( SBOX ) );
+
+    spoint_getmsg ( &box->sw, buf );
+    spoint_getmsg ( &box->ne, buf );
+    sbox_check( box );
 
     PG_RETURN_POINTER( box );
   }
 
 
+  Datum  spherebox_send(PG_FUNCTION_ARGS)
+  {
+    SBOX     * box = ( SBOX * ) PG_GETARG_POINTER(0);
+    StringInfoData buf;
+
+    pq_begintypsend ( &buf );
+    spoint_sendmsg ( &buf, &box->sw );
+    spoint_sendmsg ( &buf, &box->ne );
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
+
+
   Datum  spherebox_in_from_points(PG_FUNCTION_ARGS)
   {
     SBOX    * box = (SBOX *) MALLOC ( sizeof ( SBOX ) );
@@ -1321,3 +1350,214 @@
     SBOX   * box2 = ( SBOX  * ) PG_GETARG_POINTER ( 1 ) ;
     PG_RETURN_BOOL ( sbox_box_pos ( box1, box2, FALSE ) ==  PGS_BOX_AVOID );
   }
+#endif
+
+
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    The transition state of the bounding box aggregate. The
+    longitude range is an arc from \a lng eastwards with the
+    length \a width. It is the whole circle, if \a width is
+    not less than 360 degrees.
+    \brief bounding box state
+  */
+  typedef struct {
+    float8    minlat;  //!< minimal latitude
+    float8    maxlat;  //!< maximal latitude
+    float8    lng;     //!< west end of longitude range
+    float8    width;   //!< length of longitude range, negative if not set
+    int64     n;       //!< count of added objects
+  } SBoxBound;
+
+  /*!
+    Enlarges the longitude range of the state to the shortest arc
+    containing itself and the given arc. The shortest arc covering
+    two arcs starts at the west end of one of them.
+    \brief adds a longitude range to the bounding box state
+    \param b     pointer to state
+    \param lng   west end of longitude range
+    \param width length of longitude range
+  */
+  static void sbox_bound_add_lng ( SBoxBound * b, float8 lng, float8 width )
+  {
+    float8 o, w1, w2;
+
+    if ( b->width < 0.0 ){
+      b->lng   = lng;
+      b->width = width;
+      return;
+    }
+    if ( b->width >= PID ){
+      return;
+    }
+    if ( width >= PID ){
+      b->width = PID;
+      return;
+    }
+
+    // starting at b->lng
+    o  = lng - b->lng;
+    if ( o < 0.0 ) o += PID;
+    w1 = max ( b->width, o + width );
+    // starting at lng
+    o  = b->lng - lng;
+    if ( o < 0.0 ) o += PID;
+    w2 = max ( width, o + b->width );
+
+    if ( w1 <= w2 ){
+      b->width = w1;
+    } else {
+      b->lng   = lng;
+      b->width = w2;
+    }
+    if ( b->width >= PID ){
+      b->width = PID;
+    }
+  }
+
+  /*!
+    \brief adds a latitude range to the bounding box state
+  */
+  static void sbox_bound_add_lat ( SBoxBound * b, float8 minlat, float8 maxlat )
+  {
+    if ( b->n++ == 0 ){
+      b->minlat = minlat;
+      b->maxlat = maxlat;
+    } else {
+      b->minlat = min ( b->minlat, minlat );
+      b->maxlat = max ( b->maxlat, maxlat );
+    }
+  }
+
+  /*!
+    \brief returns the bounding box state, creates it if it does not exist
+  */
+  static SBoxBound * sbox_bound_state ( FunctionCallInfo fcinfo, const char * fname )
+  {
+    SBoxBound * b;
+
+    if ( ! PG_ARGISNULL ( 0 ) ){
+      return ( SBoxBound * ) PG_GETARG_POINTER ( 0 );
+    }
+    b = ( SBoxBound * ) MemoryContextAllocZero ( pgs_agg_context ( fcinfo, fname ), sizeof ( SBoxBound ) );
+    b->width = -1.0;
+    return b;
+  }
+
+
+#ifndef PGS_CORE
+  Datum  spherebox_bound_add_point(PG_FUNCTION_ARGS)
+  {
+    SBoxBound * b = sbox_bound_state ( fcinfo, "spherebox_bound_add_point" );
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      SPoint * p = ( SPoint * ) PG_GETARG_POINTER ( 1 );
+      sbox_bound_add_lat ( b, p->lat, p->lat );
+      // the longitude of a pole is meaningless
+      if ( FPne ( fabs ( p->lat ), PIH ) ){
+        sbox_bound_add_lng ( b, p->lng, 0.0 );
+      }
+    }
+    PG_RETURN_POINTER ( b );
+  }
+
+
+  Datum  spherebox_bound_add_box(PG_FUNCTION_ARGS)
+  {
+    SBoxBound * b = sbox_bound_state ( fcinfo, "spherebox_bound_add_box" );
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      SBOX * box = ( SBOX * ) PG_GETARG_POINTER ( 1 );
+      float8 w   = box->ne.lng - box->sw.lng;
+      if ( w < 0.0 ) w += PID;
+      sbox_bound_add_lat ( b, box->sw.lat, box->ne.lat );
+      sbox_bound_add_lng ( b, box->sw.lng, w );
+    }
+    PG_RETURN_POINTER ( b );
+  }
+
+
+  Datum  spherebox_bound_combine(PG_FUNCTION_ARGS)
+  {
+    SBoxBound * b = sbox_bound_state ( fcinfo, "spherebox_bound_combine" );
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      SBoxBound * b2 = ( SBoxBound * ) PG_GETARG_POINTER ( 1 );
+      if ( b2->n > 0 ){
+        sbox_bound_add_lat ( b, b2->minlat, b2->maxlat );
+        b->n += b2->n - 1;
+      }
+      if ( b2->width >= 0.0 ){
+        sbox_bound_add_lng ( b, b2->lng, b2->width );
+      }
+    }
+    PG_RETURN_POINTER ( b );
+  }
+
+
+  Datum  spherebox_bound_serialize(PG_FUNCTION_ARGS)
+  {
+    SBoxBound    * b = ( SBoxBound * ) PG_GETARG_POINTER ( 0 );
+    StringInfoData buf;
+
+    pq_begintypsend ( &buf );
+    pq_sendfloat8 ( &buf, b->minlat );
+    pq_sendfloat8 ( &buf, b->maxlat );
+    pq_sendfloat8 ( &buf, b->lng );
+    pq_sendfloat8 ( &buf, b->width );
+    pq_sendint64  ( &buf, b->n );
+    PG_RETURN_BYTEA_P ( pq_endtypsend ( &buf ) );
+  }
+
+
+  Datum  spherebox_bound_deserialize(PG_FUNCTION_ARGS)
+  {
+    bytea        * s = PG_GETARG_BYTEA_P ( 0 );
+    SBoxBound    * b = ( SBoxBound * ) palloc ( sizeof ( SBoxBound ) );
+    StringInfoData buf;
+
+    buf.data   = VARDATA ( s );
+    buf.len    = VARSIZE ( s ) - VARHDRSZ;
+    buf.maxlen = buf.len;
+    buf.cursor = 0;
+    b->minlat = pq_getmsgfloat8 ( &buf );
+    b->maxlat = pq_getmsgfloat8 ( &buf );
+    b->lng    = pq_getmsgfloat8 ( &buf );
+    b->width  = pq_getmsgfloat8 ( &buf );
+    b->n      = pq_getmsgint64  ( &buf );
+    pq_getmsgend ( &buf );
+    PG_RETURN_POINTER ( b );
+  }
+
+
+  Datum  spherebox_bound_finalize(PG_FUNCTION_ARGS)
+  {
+    SBoxBound * b = ( SBoxBound * ) PG_GETARG_POINTER ( 0 );
+    SBOX      * box;
+
+    if ( b->n == 0 ){
+      PG_RETURN_NULL ( );
+    }
+    box = ( SBOX * ) MALLOC ( sizeof ( SBOX ) );
+    box->sw.lat = b->minlat;
+    box->ne.lat = b->maxlat;
+    if ( b->width < 0.0 ){
+      // poles only
+      box->sw.lng = box->ne.lng = 0.0;
+    } else if ( b->width >= PID ){
+      box->sw.lng = 0.0;
+      box->ne.lng = PID;
+    } else {
+      box->sw.lng = b->lng;
+      box->ne.lng = b->lng + b->width;
+      if ( box->ne.lng >= PID ){
+        box->ne.lng -= PID;
+      }
+    }
+    sbox_check ( box );
+    PG_RETURN_POINTER ( box );
+  }
+#endif
+
+#endif
@@ -117,6 +117,20 @@ typedef struct
   */
   Datum  spherebox_in(PG_FUNCTION_ARGS);
 
+  /*!
+    \brief binary input function of spherical box
+    \return spherical box datum
+    \note PostgreSQL function
+  */
+  Datum  spherebox_recv(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief binary output function of spherical box
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  spherebox_send(PG_FUNCTION_ARGS);
+
   /*!
     The first point is the south-west position,
     the second the north-east position.
@@ -618,6 +632,72 @@ typedef struct
   */
   Datum spherebox_overlap_box_neg(PG_FUNCTION_ARGS);
 
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    \brief adds a point to the state of sbox_bound aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum spherebox_bound_add_point(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief adds a box to the state of sbox_bound aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum spherebox_bound_add_box(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief combines two states of sbox_bound aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum spherebox_bound_combine(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief serializes the state of sbox_bound aggregate
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum spherebox_bound_serialize(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief deserializes the state of sbox_bound aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum spherebox_bound_deserialize(PG_FUNCTION_ARGS);
+
+  /*!
+    The longitude range of the box is the shortest one found by
+    adding the objects one by one, so it may be larger than the
+    shortest possible range if the objects spread over more than
+    180 degrees of longitude.
+    \brief final function of sbox_bound aggregate
+    \return spherical box datum
+    \note PostgreSQL function
+  */
+  Datum spherebox_bound_finalize(PG_FUNCTION_ARGS);
+
+#endif
+
+
+
+#ifdef PGS_CORE
+
+  /*
+    Kernels of box.c, which are static in the extension. See
+    PGS_KERNEL and the documentation of the definitions.
+  */
+  void  sbox_check ( SBOX * box );
+  int8  sbox_circle_pos ( const SCIRCLE * sc , const SBOX * sb );
+  int8  sbox_path_pos ( const SPATH * path , const SBOX * box );
+  int8  sbox_poly_pos ( const SPOLY * poly, const SBOX * box );
+  int8  sbox_ellipse_pos ( const SELLIPSE * ell , const SBOX * box );
+  int8  sbox_box_pos ( const SBOX * b1 , const SBOX * b2 , bool recheck );
+
+#endif
 
 
 #endif
@@ -9,6 +9,8 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
   PG_FUNCTION_INFO_V1(spherecircle_in);
+  PG_FUNCTION_INFO_V1(spherecircle_recv);
+  PG_FUNCTION_INFO_V1(spherecircle_send);
   PG_FUNCTION_INFO_V1(spherecircle_equal);
   PG_FUNCTION_INFO_V1(spherecircle_equal_neg);
   PG_FUNCTION_INFO_V1(spherecircle_distance);
@@ -18,6 +20,8 @@
   PG_FUNCTION_INFO_V1(spherepoint_in_circle_neg);
   PG_FUNCTION_INFO_V1(spherepoint_in_circle_com);
   PG_FUNCTION_INFO_V1(spherepoint_in_circle_com_neg);
+  PG_FUNCTION_INFO_V1(spherecircle_select_points);
+  PG_FUNCTION_INFO_V1(spherecircle_count_points);
   PG_FUNCTION_INFO_V1(spherecircle_in_circle);
   PG_FUNCTION_INFO_V1(spherecircle_in_circle_neg);
   PG_FUNCTION_INFO_V1(spherecircle_in_circle_com);
@@ -32,6 +36,13 @@
   PG_FUNCTION_INFO_V1(spherecircle_circ);
   PG_FUNCTION_INFO_V1(spheretrans_circle);
   PG_FUNCTION_INFO_V1(spheretrans_circle_inverse);
+  PG_FUNCTION_INFO_V1(spherecircle_bound_add_point);
+  PG_FUNCTION_INFO_V1(spherecircle_bound_add_circle);
+  PG_FUNCTION_INFO_V1(spherecircle_bound_combine);
+  PG_FUNCTION_INFO_V1(spherecircle_bound_serialize);
+  PG_FUNCTION_INFO_V1(spherecircle_bound_deserialize);
+  PG_FUNCTION_INFO_V1(spherecircle_bound_finalize);
+  PG_FUNCTION_INFO_V1(spherecircle_enclosing_finalize);
 
 #endif
 
@@ -60,21 +71,22 @@
     return out;
   }
 
+#ifndef PGS_CORE
   Datum  spherecircle_in(PG_FUNCTION_ARGS)
   {
     SCIRCLE  * c  = ( SCIRCLE * ) MALLOC ( sizeof ( SCIRCLE ) ) ;
     char     * s  = PG_GETARG_CSTRING(0);
     double lng, lat, radius ;
+    SParseBuffer * pb = NULL ;
 
-    void sphere_yyparse( void );
-
-    init_buffer ( s );
-    sphere_yyparse();
-    if ( get_circle( &lng, &lat, &radius ) ){
+    // plain "<(lng,lat),radius>" input does not need the parser
+    if ( ! parse_fast_circle ( s, &lng, &lat, &radius ) ){
+      pb = sphere_parse ( s );
+    }
+    if ( ! pb || get_circle( pb, &lng, &lat, &radius ) ){
       c->center.lng  = lng;
       c->center.lat  = lat;
       c->radius      = radius;
-      reset_buffer();
       /*
         It's important to allow circles with radius 90deg!!      
       */
@@ -88,14 +100,47 @@
       }
       spoint_check ( &c->center );
     } else {
-      reset_buffer();
       FREE( c );
       c = NULL;
       elog ( ERROR , "spherecircle_in: parse error" );
     }
+    if ( pb ){
+      free_buffer ( pb );
+    }
+    PG_RETURN_POINTER( c );
+  }
+
+  Datum  spherecircle_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SCIRCLE  * c   = ( SCIRCLE * ) MALLOC ( sizeof ( SCIRCLE ) ) ;
+
+    spoint_getmsg ( &c->center, buf );
+    c->radius = pgs_getmsgfloat8 ( buf );
+    if ( c->radius < 0.0 ){
+      FREE( c );
+      elog ( ERROR , "spherecircle_recv: radius must be not negative" );
+      PG_RETURN_NULL();
+    } else if ( FPgt(c->radius,PIH) ){
+      FREE( c );
+      elog ( ERROR , "spherecircle_recv: radius must be not greater than 90 degrees" );
+      PG_RETURN_NULL();
+    } else if ( FPeq(c->radius,PIH) ){
+      c->radius = PIH;
+    }
     PG_RETURN_POINTER( c );
   }
 
+  Datum  spherecircle_send(PG_FUNCTION_ARGS)
+  {
+    SCIRCLE  * c  = ( SCIRCLE * ) PG_GETARG_POINTER(0);
+    StringInfoData buf;
+    pq_begintypsend ( &buf );
+    spoint_sendmsg ( &buf, &c->center );
+    pq_sendfloat8 ( &buf, c->radius );
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
+
   Datum  spherecircle_equal(PG_FUNCTION_ARGS)
   {
     SCIRCLE  * c1 =  ( SCIRCLE * )  PG_GETARG_POINTER ( 0 ) ;
@@ -177,6 +222,84 @@
     PG_RETURN_BOOL ( ! spoint_in_circle ( p, c ) );
   }
 
+  /*!
+    Compares squared chord lengths, so there is no trigonometric
+    function per point. The radius gets the same tolerance as in
+    spoint_in_circle.
+    \brief finds the points of an array inside a circle
+    \param c   pointer to circle
+    \param arr array of spherical points
+    \param idx pointer to array of positions of points inside, or NULL
+    \return count of points inside
+  */
+  static int32 scircle_select_points ( const SCIRCLE * c, ArrayType * arr, int32 ** idx )
+  {
+    float8   * v, * d;
+    float8     r = c->radius + EPSILON;
+    float8     lim;
+    Vector3D   cv;
+    int32      i, n, k = 0;
+
+    v = spoint_array_vectors ( arr, &n );
+    if ( idx ){
+      *idx = NULL;
+    }
+    if ( n == 0 ){
+      return 0;
+    }
+    spoint_vector3d ( &cv, &c->center );
+    d = ( float8 * ) MALLOC ( sizeof ( float8 ) * n );
+    vector3d_dist2_batch ( d, &cv, v, v + n, v + 2*n, n );
+    lim = ( r >= PI ) ? 4.0 : sqr ( 2.0 * sin ( r / 2.0 ) );
+
+    if ( idx ){
+      *idx = ( int32 * ) MALLOC ( sizeof ( int32 ) * n );
+      for ( i = 0; i < n; i++ ){
+        if ( d[i] <= lim ){
+          ( *idx )[k++] = i;
+        }
+      }
+    } else {
+      for ( i = 0; i < n; i++ ){
+        k += ( d[i] <= lim );
+      }
+    }
+    FREE ( d );
+    FREE ( v );
+    return k;
+  }
+
+  Datum spherecircle_select_points (PG_FUNCTION_ARGS)
+  {
+    ArrayType * arr = PG_GETARG_ARRAYTYPE_P ( 0 );
+    SCIRCLE   * c   = ( SCIRCLE * ) PG_GETARG_POINTER ( 1 ) ;
+    int32     * idx;
+    int32       i, k, lb;
+    Datum     * elems;
+    ArrayType * result;
+
+    k = scircle_select_points ( c, arr, &idx );
+    if ( k == 0 ){
+      PG_RETURN_ARRAYTYPE_P ( construct_empty_array ( INT4OID ) );
+    }
+    lb    = ( ARR_NDIM ( arr ) == 1 ) ? ARR_LBOUND ( arr )[0] : 1;
+    elems = ( Datum * ) MALLOC ( sizeof ( Datum ) * k );
+    for ( i = 0; i < k; i++ ){
+      elems[i] = Int32GetDatum ( idx[i] + lb );
+    }
+    result = construct_array ( elems, k, INT4OID, sizeof ( int32 ), true, 'i' );
+    FREE ( elems );
+    FREE ( idx );
+    PG_RETURN_ARRAYTYPE_P ( result );
+  }
+
+  Datum spherecircle_count_points (PG_FUNCTION_ARGS)
+  {
+    ArrayType * arr = PG_GETARG_ARRAYTYPE_P ( 0 );
+    SCIRCLE   * c   = ( SCIRCLE * ) PG_GETARG_POINTER ( 1 ) ;
+    PG_RETURN_INT32 ( scircle_select_points ( c, arr, NULL ) );
+  }
+
   Datum spherecircle_in_circle (PG_FUNCTION_ARGS)
   {
     SCIRCLE  * c1 =  ( SCIRCLE * ) PG_GETARG_POINTER ( 0 ) ;
@@ -338,3 +461,353 @@
                        sc, PointerGetDatum(&tmp) );
     PG_RETURN_DATUM( ret );
   }
+#endif
+
+
+  /*!
+    \brief angle between two unit vectors, exact for small angles too
+  */
+  static float8 vector3d_angle ( const Vector3D * a, const Vector3D * b )
+  {
+    Vector3D cr;
+    vector3d_cross ( &cr, a, b );
+    return atan2 ( vector3d_length ( &cr ), vector3d_scalar ( ( Vector3D * ) a, ( Vector3D * ) b ) );
+  }
+
+  /*!
+    \brief smallest circle with two points on its border
+  */
+  static void scircle_enclosing_2 ( Vector3D * center, float8 * radius, const Vector3D * a, const Vector3D * b )
+  {
+    float8 l;
+
+    center->x = a->x + b->x;
+    center->y = a->y + b->y;
+    center->z = a->z + b->z;
+    l = vector3d_length ( center );
+    if ( l < EPSILON ){
+      // antipodes, the circle is a half sphere around any perpendicular
+      Vector3D e = { 0.0, 0.0, 0.0 };
+      if ( fabs ( a->x ) <= fabs ( a->y ) && fabs ( a->x ) <= fabs ( a->z ) ){
+        e.x = 1.0;
+      } else if ( fabs ( a->y ) <= fabs ( a->z ) ){
+        e.y = 1.0;
+      } else {
+        e.z = 1.0;
+      }
+      vector3d_cross ( center, a, &e );
+      l = vector3d_length ( center );
+    }
+    center->x /= l;
+    center->y /= l;
+    center->z /= l;
+    *radius = vector3d_angle ( center, a );
+  }
+
+  /*!
+    \brief smallest circle with three points on its border
+  */
+  static void scircle_enclosing_3 ( Vector3D * center, float8 * radius, const Vector3D * a, const Vector3D * b, const Vector3D * c )
+  {
+    Vector3D  u, v;
+    float8    l;
+
+    // the normal of the plane through all three points
+    u.x = b->x - a->x;
+    u.y = b->y - a->y;
+    u.z = b->z - a->z;
+    v.x = c->x - a->x;
+    v.y = c->y - a->y;
+    v.z = c->z - a->z;
+    vector3d_cross ( center, &u, &v );
+    l = vector3d_length ( center );
+    if ( l < EPSILON * EPSILON ){
+      scircle_enclosing_2 ( center, radius, a, ( vector3d_angle ( a, b ) > vector3d_angle ( a, c ) ) ? b : c );
+      return;
+    }
+    if ( vector3d_scalar ( center, ( Vector3D * ) a ) < 0.0 ){
+      l = -l;
+    }
+    center->x /= l;
+    center->y /= l;
+    center->z /= l;
+    *radius = vector3d_angle ( center, a );
+  }
+
+
+  bool scircle_min_enclosing ( Vector3D * center, float8 * radius, Vector3D * v, int32 n )
+  {
+    int32     i, j, k;
+    uint32    rnd = 2463534242U;
+    Vector3D  tmp;
+
+    if ( n < 1 ){
+      return FALSE;
+    }
+
+    // a random order makes the expected run time linear
+    for ( i=n-1; i>0; i-- ){
+      rnd ^= rnd << 13;
+      rnd ^= rnd >> 17;
+      rnd ^= rnd << 5;
+      j    = rnd % ( i + 1 );
+      tmp  = v[i];
+      v[i] = v[j];
+      v[j] = tmp;
+    }
+
+    *center = v[0];
+    *radius = 0.0;
+    for ( i=1; i<n; i++ ){
+      if ( vector3d_angle ( center, &v[i] ) <= *radius ){
+        continue;
+      }
+      *center = v[i];
+      *radius = 0.0;
+      for ( j=0; j<i; j++ ){
+        if ( vector3d_angle ( center, &v[j] ) <= *radius ){
+          continue;
+        }
+        scircle_enclosing_2 ( center, radius, &v[i], &v[j] );
+        for ( k=0; k<j; k++ ){
+          if ( vector3d_angle ( center, &v[k] ) <= *radius ){
+            continue;
+          }
+          scircle_enclosing_3 ( center, radius, &v[i], &v[j], &v[k] );
+        }
+      }
+    }
+
+    // the radius is the largest distance, so no point is outside by rounding
+    for ( i=0; i<n; i++ ){
+      float8 a = vector3d_angle ( center, &v[i] );
+      if ( a > *radius ){
+        *radius = a;
+      }
+    }
+    // the result is only valid, if all points fit into a hemisphere
+    if ( FPgt ( *radius, PIH ) ){
+      return FALSE;
+    }
+    return TRUE;
+  }
+
+
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    The transition state of the bounding circle aggregate. The
+    radius may grow up to 180 degrees, the whole sphere.
+    \brief bounding circle state
+  */
+  typedef struct {
+    Vector3D  center;  //!< unit vector of the center
+    float8    radius;  //!< radius in radians
+    int64     n;       //!< count of added objects
+  } SCircleBound;
+
+  /*!
+    Enlarges the bounding circle to the smallest circle containing
+    itself and the given circle. The new center is on the great
+    circle through both centers.
+    \brief adds a circle to the bounding circle state
+    \param b      pointer to state
+    \param center unit vector of circle center
+    \param radius radius of circle
+  */
+  static void scircle_bound_add ( SCircleBound * b, const Vector3D * center, float8 radius )
+  {
+    Vector3D  cr, u;
+    float8    s, d, r, t;
+
+    if ( b->n++ == 0 ){
+      b->center = *center;
+      b->radius = radius;
+      return;
+    }
+    if ( b->radius >= PI ){
+      return;
+    }
+
+    vector3d_cross ( &cr, &b->center, center );
+    s = vector3d_length ( &cr );
+    d = atan2 ( s, vector3d_scalar ( &b->center, ( Vector3D * ) center ) );
+
+    if ( d + radius <= b->radius ){
+      return;
+    }
+    if ( d + b->radius <= radius ){
+      b->center = *center;
+      b->radius = radius;
+      return;
+    }
+
+    r = ( d + b->radius + radius ) / 2.0;
+    if ( r >= PI ){
+      b->radius = PI;
+      return;
+    }
+
+    // u is perpendicular to the old center towards the new one
+    if ( s < EPSILON ){
+      // antipodal centers, any great circle through both will do
+      Vector3D e = { 0.0, 0.0, 0.0 };
+      if ( fabs ( b->center.x ) <= fabs ( b->center.y ) && fabs ( b->center.x ) <= fabs ( b->center.z ) ){
+        e.x = 1.0;
+      } else if ( fabs ( b->center.y ) <= fabs ( b->center.z ) ){
+        e.y = 1.0;
+      } else {
+        e.z = 1.0;
+      }
+      vector3d_cross ( &cr, &b->center, &e );
+      s = vector3d_length ( &cr );
+    }
+    vector3d_cross ( &u, &cr, &b->center );
+    u.x /= s;
+    u.y /= s;
+    u.z /= s;
+
+    t = r - b->radius;
+    b->center.x = cos ( t ) * b->center.x + sin ( t ) * u.x;
+    b->center.y = cos ( t ) * b->center.y + sin ( t ) * u.y;
+    b->center.z = cos ( t ) * b->center.z + sin ( t ) * u.z;
+    s = vector3d_length ( &b->center );
+    b->center.x /= s;
+    b->center.y /= s;
+    b->center.z /= s;
+    b->radius = r;
+  }
+
+  /*!
+    \brief returns the bounding circle state, creates it if it does not exist
+  */
+  static SCircleBound * scircle_bound_state ( FunctionCallInfo fcinfo, const char * fname )
+  {
+    if ( ! PG_ARGISNULL ( 0 ) ){
+      return ( SCircleBound * ) PG_GETARG_POINTER ( 0 );
+    }
+    return ( SCircleBound * ) MemoryContextAllocZero ( pgs_agg_context ( fcinfo, fname ), sizeof ( SCircleBound ) );
+  }
+
+
+#ifndef PGS_CORE
+  Datum  spherecircle_bound_add_point(PG_FUNCTION_ARGS)
+  {
+    SCircleBound * b = scircle_bound_state ( fcinfo, "spherecircle_bound_add_point" );
+    Vector3D       v;
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      spoint_vector3d ( &v, ( SPoint * ) PG_GETARG_POINTER ( 1 ) );
+      scircle_bound_add ( b, &v, 0.0 );
+    }
+    PG_RETURN_POINTER ( b );
+  }
+
+
+  Datum  spherecircle_bound_add_circle(PG_FUNCTION_ARGS)
+  {
+    SCircleBound * b = scircle_bound_state ( fcinfo, "spherecircle_bound_add_circle" );
+    Vector3D       v;
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      SCIRCLE * c = ( SCIRCLE * ) PG_GETARG_POINTER ( 1 );
+      spoint_vector3d ( &v, &c->center );
+      scircle_bound_add ( b, &v, c->radius );
+    }
+    PG_RETURN_POINTER ( b );
+  }
+
+
+  Datum  spherecircle_bound_combine(PG_FUNCTION_ARGS)
+  {
+    SCircleBound * b = scircle_bound_state ( fcinfo, "spherecircle_bound_combine" );
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      SCircleBound * b2 = ( SCircleBound * ) PG_GETARG_POINTER ( 1 );
+      if ( b2->n > 0 ){
+        scircle_bound_add ( b, &b2->center, b2->radius );
+        b->n += b2->n - 1;
+      }
+    }
+    PG_RETURN_POINTER ( b );
+  }
+
+
+  Datum  spherecircle_bound_serialize(PG_FUNCTION_ARGS)
+  {
+    SCircleBound * b = ( SCircleBound * ) PG_GETARG_POINTER ( 0 );
+    StringInfoData buf;
+
+    pq_begintypsend ( &buf );
+    pq_sendfloat8 ( &buf, b->center.x );
+    pq_sendfloat8 ( &buf, b->center.y );
+    pq_sendfloat8 ( &buf, b->center.z );
+    pq_sendfloat8 ( &buf, b->radius );
+    pq_sendint64  ( &buf, b->n );
+    PG_RETURN_BYTEA_P ( pq_endtypsend ( &buf ) );
+  }
+
+
+  Datum  spherecircle_bound_deserialize(PG_FUNCTION_ARGS)
+  {
+    bytea        * s = PG_GETARG_BYTEA_P ( 0 );
+    SCircleBound * b = ( SCircleBound * ) palloc ( sizeof ( SCircleBound ) );
+    StringInfoData buf;
+
+    buf.data   = VARDATA ( s );
+    buf.len    = VARSIZE ( s ) - VARHDRSZ;
+    buf.maxlen = buf.len;
+    buf.cursor = 0;
+    b->center.x = pq_getmsgfloat8 ( &buf );
+    b->center.y = pq_getmsgfloat8 ( &buf );
+    b->center.z = pq_getmsgfloat8 ( &buf );
+    b->radius   = pq_getmsgfloat8 ( &buf );
+    b->n        = pq_getmsgint64  ( &buf );
+    pq_getmsgend ( &buf );
+    PG_RETURN_POINTER ( b );
+  }
+
+
+  Datum  spherecircle_bound_finalize(PG_FUNCTION_ARGS)
+  {
+    SCircleBound * b = ( SCircleBound * ) PG_GETARG_POINTER ( 0 );
+    SCIRCLE      * c;
+
+    // a circle must not be larger than a hemisphere
+    if ( b->n == 0 || FPgt ( b->radius, PIH ) ){
+      PG_RETURN_NULL ( );
+    }
+    c = ( SCIRCLE * ) MALLOC ( sizeof ( SCIRCLE ) );
+    vector3d_spoint ( &c->center, &b->center );
+    c->radius = ( b->radius > PIH ) ? PIH : b->radius;
+    PG_RETURN_POINTER ( c );
+  }
+
+
+  Datum  spherecircle_enclosing_finalize(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf = ( SPointBuffer * ) PG_GETARG_POINTER ( 0 );
+    SCIRCLE      * c;
+    Vector3D     * v, center;
+    float8         radius;
+    int32          i;
+
+    v = ( Vector3D * ) palloc ( sizeof ( Vector3D ) * buf->npts );
+    for ( i=0; i<buf->npts; i++ ){
+      spoint_vector3d ( &v[i], &buf->p[i] );
+    }
+    if ( ! scircle_min_enclosing ( &center, &radius, v, buf->npts ) ){
+      elog ( NOTICE , "scircle_enclosing(spoint): points do not fit into a hemisphere" );
+      pfree ( v );
+      PG_RETURN_NULL ( );
+    }
+    pfree ( v );
+
+    c = ( SCIRCLE * ) MALLOC ( sizeof ( SCIRCLE ) );
+    vector3d_spoint ( &c->center, &center );
+    c->radius = ( radius > PIH ) ? PIH : radius;
+    PG_RETURN_POINTER ( c );
+  }
+#endif
+
+#endif
@@ -49,6 +49,20 @@
   */
   Datum  spherecircle_in                 (PG_FUNCTION_ARGS);
 
+  /*!
+    \brief binary input function of spherical circle
+    \return spherical circle datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_recv               (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief binary output function of spherical circle
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_send               (PG_FUNCTION_ARGS);
+
   /*!
     Checks whether two circles are equal.
     \brief equality of two circles
@@ -122,6 +136,20 @@
   */
   Datum  spherepoint_in_circle_com_neg   (PG_FUNCTION_ARGS);
 
+  /*!
+    \brief returns the subscripts of array points inside a circle
+    \return int4 array datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_select_points      (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief counts the array points inside a circle
+    \return int4 datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_count_points       (PG_FUNCTION_ARGS);
+
   /*!
     \brief Checks whether circle is contained by other circle
     \return boolean datum
@@ -227,6 +255,77 @@
   */
   Datum  spheretrans_circle_inverse      (PG_FUNCTION_ARGS);
 
+  /*!
+    Computes the smallest circle containing all points with
+    Welzl's algorithm. The points are shuffled first, so the
+    expected run time is linear.
+    \brief smallest circle containing points
+    \param center pointer to unit vector of resulting circle center
+    \param radius pointer to resulting radius
+    \param v array of unit vectors, gets reordered
+    \param n count of vectors
+    \return false, if there are no points or they do not fit into a hemisphere
+  */
+  bool scircle_min_enclosing ( Vector3D * center, float8 * radius, Vector3D * v, int32 n );
+
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    \brief adds a point to the state of scircle_bound aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_bound_add_point    (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief adds a circle to the state of scircle_bound aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_bound_add_circle   (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief combines two states of scircle_bound aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_bound_combine      (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief serializes the state of scircle_bound aggregate
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_bound_serialize    (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief deserializes the state of scircle_bound aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_bound_deserialize  (PG_FUNCTION_ARGS);
+
+  /*!
+    The bounding circle contains all input objects, but it is not
+    the smallest one in general. The result is NULL, if the radius
+    would be larger than 90 degrees.
+    \brief final function of scircle_bound aggregate
+    \return spherical circle datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_bound_finalize     (PG_FUNCTION_ARGS);
+
+  /*!
+    The result is the smallest circle containing all points, or
+    NULL, if the points do not fit into a hemisphere.
+    \brief final function of scircle_enclosing aggregate
+    \return spherical circle datum
+    \note PostgreSQL function
+  */
+  Datum  spherecircle_enclosing_finalize (PG_FUNCTION_ARGS);
+
+#endif
+
 
 
 #endif
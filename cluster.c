@@ -0,0 +1,395 @@
+#include "cluster.h"
+#include "executor/spi.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "utils/hsearch.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/tuplestore.h"
+
+/*!
+  \file
+  \brief Clustering of spherical points
+*/
+
+
+#if PG_VERSION_NUM >= 80400
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  PG_FUNCTION_INFO_V1(spherepoint_fof);
+
+#endif
+
+/*!
+  \brief count of rows fetched from cursor at once
+*/
+#define FOF_FETCH_ROWS  1000
+
+  /*!
+    A point of the sweep. Points which are not in the sweep band
+    anymore stay allocated until their cluster is written out.
+    \brief node of friends-of-friends sweep
+  */
+  typedef struct {
+    int64     id;       //!< row id
+    int64     minid;    //!< smallest row id of cluster, root only
+    int64     size;     //!< count of cluster members, root only
+    Vector3D  v;        //!< unit vector of point
+    float8    lat;      //!< latitude of point
+    int32     parent;   //!< parent in union-find forest, next free node if unused
+    int32     member;   //!< next member of the same cluster ( circular list )
+    int32     cell;     //!< next point in the same grid cell
+    int32     band;     //!< next point in the sweep band
+    int32     nband;    //!< count of cluster members in the sweep band, root only
+  } FofNode;
+
+  /*!
+    \brief key of a grid cell of unit vectors
+  */
+  typedef struct {
+    int64     ix;       //!< cell index of x value
+    int64     iy;       //!< cell index of y value
+    int64     iz;       //!< cell index of z value
+  } FofCellKey;
+
+  /*!
+    The points of a cell are ordered by latitude, so the sweep
+    removes them from the head.
+    \brief grid cell of unit vectors
+  */
+  typedef struct {
+    FofCellKey key;     //!< hash key, must be first
+    int32      head;    //!< first point of the cell
+    int32      tail;    //!< last point of the cell
+  } FofCell;
+
+  /*!
+    \brief state of friends-of-friends sweep
+  */
+  typedef struct {
+    FofNode         * n;        //!< array of nodes
+    int32             nalloc;   //!< count of allocated nodes
+    int32             nused;    //!< count of nodes ever used
+    int32             free;     //!< first free node or -1
+    int32             head;     //!< first ( lowest ) point of the sweep band
+    int32             tail;     //!< last point of the sweep band
+    HTAB            * grid;     //!< grid cells of points in the sweep band
+    float8            ll;       //!< linking length in radians
+    float8            chord2;   //!< square of chord length of linking length
+    float8            cellsize; //!< edge length of grid cells
+    Tuplestorestate * out;      //!< result rows
+    TupleDesc         desc;     //!< result row descriptor
+  } FofState;
+
+
+  /*!
+    \brief returns the root of a node, halves the path
+  */
+  static int32 fof_find ( FofState * s, int32 i )
+  {
+    FofNode * n = s->n;
+    while ( n[i].parent != i ){
+      n[i].parent = n[n[i].parent].parent;
+      i = n[i].parent;
+    }
+    return i;
+  }
+
+
+  /*!
+    \brief joins the clusters of two nodes
+  */
+  static void fof_union ( FofState * s, int32 a, int32 b )
+  {
+    FofNode * n = s->n;
+    int32     t;
+
+    a = fof_find ( s, a );
+    b = fof_find ( s, b );
+    if ( a == b ){
+      return;
+    }
+    if ( n[a].size < n[b].size ){
+      t = a;
+      a = b;
+      b = t;
+    }
+    n[b].parent  = a;
+    n[a].size   += n[b].size;
+    n[a].nband  += n[b].nband;
+    if ( n[b].minid < n[a].minid ){
+      n[a].minid = n[b].minid;
+    }
+    // splice circular member lists
+    t           = n[a].member;
+    n[a].member = n[b].member;
+    n[b].member = t;
+  }
+
+
+  /*!
+    \brief returns the grid cell key of a unit vector
+  */
+  static void fof_cell_key ( FofState * s, FofCellKey * key, const Vector3D * v )
+  {
+    memset ( (void*) key, 0, sizeof ( FofCellKey ) );
+    key->ix = ( int64 ) floor ( v->x / s->cellsize );
+    key->iy = ( int64 ) floor ( v->y / s->cellsize );
+    key->iz = ( int64 ) floor ( v->z / s->cellsize );
+  }
+
+
+  /*!
+    \brief writes all members of a cluster and frees their nodes
+  */
+  static void fof_emit ( FofState * s, int32 root )
+  {
+    FofNode * n = s->n;
+    Datum     values[2];
+    bool      nulls[2] = { false, false };
+    int32     i, next;
+
+    values[1] = Int64GetDatum ( n[root].minid );
+    i = root;
+    do {
+      values[0] = Int64GetDatum ( n[i].id );
+      tuplestore_putvalues ( s->out, s->desc, values, nulls );
+      next        = n[i].member;
+      n[i].parent = s->free;
+      s->free     = i;
+      i           = next;
+    } while ( i != root );
+  }
+
+
+  /*!
+    \brief removes the lowest point from the sweep band
+  */
+  static void fof_remove ( FofState * s )
+  {
+    FofNode    * n = s->n;
+    int32        i = s->head;
+    int32        root;
+    FofCellKey   key;
+    FofCell    * c;
+
+    s->head = n[i].band;
+    if ( s->head < 0 ){
+      s->tail = -1;
+    }
+
+    fof_cell_key ( s, &key, &n[i].v );
+    c = ( FofCell * ) hash_search ( s->grid, (void*) &key, HASH_FIND, NULL );
+    if ( c == NULL || c->head != i ){
+      elog ( ERROR , "spoint_fof: corrupted sweep grid" );
+    }
+    c->head = n[i].cell;
+    if ( c->head < 0 ){
+      hash_search ( s->grid, (void*) &key, HASH_REMOVE, NULL );
+    }
+
+    root = fof_find ( s, i );
+    if ( --n[root].nband == 0 ){
+      fof_emit ( s, root );
+    }
+  }
+
+
+  /*!
+    \brief adds a point to the sweep and links it to its friends
+  */
+  static void fof_add ( FofState * s, int64 id, const SPoint * p )
+  {
+    FofNode    * n;
+    int32        i, k;
+    int          dx, dy, dz;
+    FofCellKey   key, nkey;
+    FofCell    * c;
+    bool         found;
+
+    // points below the band can not be linked anymore
+    while ( s->head >= 0 && s->n[s->head].lat < p->lat - s->ll ){
+      fof_remove ( s );
+    }
+
+    if ( s->free >= 0 ){
+      i       = s->free;
+      s->free = s->n[i].parent;
+    } else {
+      if ( s->nused == s->nalloc ){
+        if ( s->nalloc >= ( int32 ) ( MaxAllocSize / sizeof ( FofNode ) / 2 ) ){
+          elog ( ERROR , "spoint_fof: too many points in open clusters" );
+        }
+        s->nalloc *= 2;
+        s->n = ( FofNode * ) repalloc ( s->n, sizeof ( FofNode ) * s->nalloc );
+      }
+      i = s->nused++;
+    }
+    n = s->n;
+    n[i].id     = id;
+    n[i].minid  = id;
+    n[i].size   = 1;
+    n[i].lat    = p->lat;
+    n[i].parent = i;
+    n[i].member = i;
+    n[i].cell   = -1;
+    n[i].band   = -1;
+    n[i].nband  = 1;
+    spoint_vector3d ( &n[i].v, p );
+
+    fof_cell_key ( s, &key, &n[i].v );
+    for ( dx=-1; dx<=1; dx++ ){
+      for ( dy=-1; dy<=1; dy++ ){
+        for ( dz=-1; dz<=1; dz++ ){
+          nkey     = key;
+          nkey.ix += dx;
+          nkey.iy += dy;
+          nkey.iz += dz;
+          c = ( FofCell * ) hash_search ( s->grid, (void*) &nkey, HASH_FIND, NULL );
+          if ( c == NULL ){
+            continue;
+          }
+          for ( k=c->head; k>=0; k=n[k].cell ){
+            float8 d2 = sqr ( n[k].v.x - n[i].v.x ) + sqr ( n[k].v.y - n[i].v.y ) + sqr ( n[k].v.z - n[i].v.z );
+            if ( d2 <= s->chord2 ){
+              fof_union ( s, i, k );
+            }
+          }
+        }
+      }
+    }
+
+    c = ( FofCell * ) hash_search ( s->grid, (void*) &key, HASH_ENTER, &found );
+    if ( found ){
+      n[c->tail].cell = i;
+    } else {
+      c->head = i;
+    }
+    c->tail = i;
+
+    if ( s->tail >= 0 ){
+      n[s->tail].band = i;
+    } else {
+      s->head = i;
+    }
+    s->tail = i;
+  }
+
+
+  Datum  spherepoint_fof(PG_FUNCTION_ARGS)
+  {
+    ReturnSetInfo * rsinfo = ( ReturnSetInfo * ) fcinfo->resultinfo;
+    char          * query  = text_to_cstring ( PG_GETARG_TEXT_PP ( 0 ) );
+    float8          ll     = PG_GETARG_FLOAT8 ( 1 );
+    MemoryContext   fofctx, oldctx;
+    FofState        s;
+    HASHCTL         hctl;
+    StringInfoData  sql;
+    SPIPlanPtr      plan;
+    Portal          portal;
+    TupleDesc       desc;
+    char          * nsp;
+    uint64          j;
+
+    if ( rsinfo == NULL || ! IsA ( rsinfo, ReturnSetInfo ) ||
+         ( rsinfo->allowedModes & SFRM_Materialize ) == 0 ){
+      elog ( ERROR , "spoint_fof: set-valued function called in context that cannot accept a set" );
+    }
+    if ( ! ( ll > 0.0 ) || ll >= PI ){
+      elog ( ERROR , "spoint_fof: linking length must be between 0 and 180 degrees" );
+    }
+    // smaller lengths make the grid cells empty or too many for int64 keys
+    if ( ll < EPSILON ){
+      elog ( ERROR , "spoint_fof: linking length must be at least %g", EPSILON );
+    }
+    if ( get_call_result_type ( fcinfo, NULL, &desc ) != TYPEFUNC_COMPOSITE ){
+      elog ( ERROR , "spoint_fof: return type must be a row type" );
+    }
+
+    oldctx  = MemoryContextSwitchTo ( rsinfo->econtext->ecxt_per_query_memory );
+    s.desc  = CreateTupleDescCopy ( desc );
+    s.out   = tuplestore_begin_heap ( false, false, work_mem );
+    MemoryContextSwitchTo ( oldctx );
+
+    fofctx = AllocSetContextCreate ( CurrentMemoryContext, "spoint_fof",
+                                     ALLOCSET_DEFAULT_MINSIZE,
+                                     ALLOCSET_DEFAULT_INITSIZE,
+                                     ALLOCSET_DEFAULT_MAXSIZE );
+    s.ll       = ll;
+    s.chord2   = sqr ( 2.0 * sin ( ll / 2.0 ) );
+    s.cellsize = sqrt ( s.chord2 );
+    s.nalloc   = 1024;
+    s.nused    = 0;
+    s.free     = -1;
+    s.head     = -1;
+    s.tail     = -1;
+    s.n        = ( FofNode * ) MemoryContextAlloc ( fofctx, sizeof ( FofNode ) * s.nalloc );
+
+    memset ( (void*) &hctl, 0, sizeof ( HASHCTL ) );
+    hctl.keysize   = sizeof ( FofCellKey );
+    hctl.entrysize = sizeof ( FofCell );
+    hctl.hcxt      = fofctx;
+#if PG_VERSION_NUM >= 90500
+    s.grid = hash_create ( "spoint_fof grid", 1024, &hctl, HASH_ELEM | HASH_BLOBS | HASH_CONTEXT );
+#else
+    hctl.hash      = tag_hash;
+    s.grid = hash_create ( "spoint_fof grid", 1024, &hctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT );
+#endif
+
+    // read the points in the order of latitude
+    nsp = get_namespace_name ( get_func_namespace ( fcinfo->flinfo->fn_oid ) );
+    initStringInfo ( &sql );
+    appendStringInfo ( &sql,
+      "SELECT q.id::int8, q.p FROM ( %s ) AS q ( id, p ) WHERE q.p IS NOT NULL ORDER BY %s.lat ( q.p )",
+      query, quote_identifier ( nsp ) );
+
+    if ( SPI_connect ( ) != SPI_OK_CONNECT ){
+      elog ( ERROR , "spoint_fof: SPI_connect failed" );
+    }
+    plan = SPI_prepare ( sql.data, 0, NULL );
+    if ( plan == NULL ){
+      elog ( ERROR , "spoint_fof: cannot prepare query: %s", SPI_result_code_string ( SPI_result ) );
+    }
+    portal = SPI_cursor_open ( NULL, plan, NULL, NULL, true );
+    if ( strcmp ( SPI_gettype ( portal->tupDesc, 2 ), "spoint" ) != 0 ){
+      elog ( ERROR , "spoint_fof: second column of query must be of type spoint" );
+    }
+
+    for ( ;; ){
+      SPI_cursor_fetch ( portal, true, FOF_FETCH_ROWS );
+      if ( SPI_processed == 0 ){
+        break;
+      }
+      oldctx = MemoryContextSwitchTo ( fofctx );
+      for ( j=0; j<SPI_processed; j++ ){
+        HeapTuple  tup = SPI_tuptable->vals[j];
+        bool       isnull;
+        Datum      id, p;
+
+        id = SPI_getbinval ( tup, SPI_tuptable->tupdesc, 1, &isnull );
+        if ( isnull ){
+          elog ( ERROR , "spoint_fof: row id must not be NULL" );
+        }
+        p  = SPI_getbinval ( tup, SPI_tuptable->tupdesc, 2, &isnull );
+        fof_add ( &s, DatumGetInt64 ( id ), ( SPoint * ) DatumGetPointer ( p ) );
+      }
+      MemoryContextSwitchTo ( oldctx );
+      SPI_freetuptable ( SPI_tuptable );
+      CHECK_FOR_INTERRUPTS ( );
+    }
+    SPI_cursor_close ( portal );
+    SPI_finish ( );
+
+    while ( s.head >= 0 ){
+      fof_remove ( &s );
+    }
+    MemoryContextDelete ( fofctx );
+
+    rsinfo->returnMode = SFRM_Materialize;
+    rsinfo->setResult  = s.out;
+    rsinfo->setDesc    = s.desc;
+    return ( Datum ) 0;
+  }
+
+#endif
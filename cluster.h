@@ -0,0 +1,36 @@
+#ifndef __PGS_CLUSTER_H__
+#define __PGS_CLUSTER_H__
+
+#include "point.h"
+
+/*!
+  \file
+  \brief Clustering of spherical points
+*/
+
+
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    Groups the points returned by a query into friends-of-friends
+    clusters: two points are in the same cluster, if there is a
+    chain of points between them with distances up to the linking
+    length. The query must return a row id and a spherical point.
+
+    The points are read in the order of latitude. A zone sweep
+    keeps only the points of the last band of the linking length
+    in a grid of unit vectors, and a union-find forest joins the
+    clusters. A cluster is written out as soon as none of its points
+    is in the band anymore, so memory does not depend on the count
+    of rows.
+    \brief friends-of-friends clustering of spherical points
+    \return set of ( row id, cluster id ), the cluster id is the
+    smallest row id of the cluster
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_fof(PG_FUNCTION_ARGS);
+
+#endif
+
+
+#endif
@@ -0,0 +1,673 @@
+#include "dtoa.h"
+#include "dtoa_table.h"
+
+/*!
+  \file
+  \brief Conversion of double values to text
+
+  The shortest round trip representation is computed with the
+  algorithm of Ulf Adams, "Ryu: fast float-to-string conversion",
+  PLDI 2018. Output with a given precision starts from these
+  digits. Only if they do not determine the rounded result (ties,
+  more digits than a double holds, subnormal values), the exact
+  decimal expansion of the value is used. The results are the
+  same as those of sprintf with round-to-nearest.
+*/
+
+#define DTOA_MANTISSA_BITS  52    //!< mantissa bits of a double
+#define DTOA_EXPONENT_BITS  11    //!< exponent bits of a double
+#define DTOA_BIAS           1023  //!< exponent bias of a double
+
+/*!
+  \brief number of significant digits a double always holds
+*/
+#define DTOA_SAFE_DIGITS    15
+
+/*!
+  \brief maximum number of exact decimal digits of a double
+*/
+#define DTOA_EXACT_DIGITS   800
+
+/*!
+  \brief words of the big integer used for exact digits
+*/
+#define DTOA_BIG_WORDS      84
+
+/*!
+  The digits are stored without leading and trailing zeros. The
+  value is 0.d[0]d[1]...d[nd-1] * 10^(exp+1), that means, the first
+  digit is at the position 10^exp. nd is zero for a zero value.
+  \brief decimal digits of a double
+*/
+typedef struct {
+  char  *  d    ; //!< digits as characters
+  int      nd   ; //!< number of digits
+  int      exp  ; //!< decimal exponent of the first digit
+} DtoaDigits;
+
+
+  /*!
+    \brief bit length of 5^e
+  */
+  static int dtoa_pow5bits ( int e )
+  {
+    return ( int ) ( ( ( uint32 ) e * 1217359 ) >> 19 ) + 1;
+  }
+
+  /*!
+    \brief floor( log10( 2^e ) )
+  */
+  static int dtoa_log10pow2 ( int e )
+  {
+    return ( int ) ( ( ( uint32 ) e * 78913 ) >> 18 );
+  }
+
+  /*!
+    \brief floor( log10( 5^e ) )
+  */
+  static int dtoa_log10pow5 ( int e )
+  {
+    return ( int ) ( ( ( uint32 ) e * 732923 ) >> 20 );
+  }
+
+  /*!
+    \brief true, if v is a multiple of 5^p
+  */
+  static bool dtoa_multiple_of_pow5 ( uint64 v, int p )
+  {
+    int count = 0;
+    while ( v % 5 == 0 ){
+      v /= 5;
+      count++;
+    }
+    return ( count >= p );
+  }
+
+  /*!
+    \brief true, if v is a multiple of 2^p
+  */
+  static bool dtoa_multiple_of_pow2 ( uint64 v, int p )
+  {
+    return ( v & ( ( UINT64CONST(1) << p ) - 1 ) ) == 0;
+  }
+
+  /*!
+    \brief ( m * mul ) >> j, mul is a 128 bit value, 64 < j < 128
+  */
+  static uint64 dtoa_mulshift ( uint64 m, const uint64 * mul, int j )
+  {
+#ifdef HAVE_INT128
+    uint128 b0 = ( uint128 ) m * mul[0];
+    uint128 b2 = ( uint128 ) m * mul[1];
+    return ( uint64 ) ( ( ( b0 >> 64 ) + b2 ) >> ( j - 64 ) );
+#else
+    uint64 a[2], b[2];
+    uint64 lo, mid1, mid2, hi, carry;
+    uint64 b0hi, b2lo, b2hi, sum;
+    int    i, dist;
+
+    /* two 64x64 -> 128 bit products from 32 bit halves */
+    for ( i = 0; i < 2; i++ ){
+      uint64 ml = m & 0xFFFFFFFF, mh = m >> 32;
+      uint64 nl = mul[i] & 0xFFFFFFFF, nh = mul[i] >> 32;
+      lo    = ml * nl;
+      mid1  = mh * nl;
+      mid2  = ml * nh;
+      hi    = mh * nh;
+      carry = ( lo >> 32 ) + ( mid1 & 0xFFFFFFFF ) + ( mid2 & 0xFFFFFFFF );
+      a[i]  = ( carry << 32 ) | ( lo & 0xFFFFFFFF );
+      b[i]  = hi + ( mid1 >> 32 ) + ( mid2 >> 32 ) + ( carry >> 32 );
+    }
+    b0hi = b[0];
+    b2lo = a[1];
+    b2hi = b[1];
+    sum  = b0hi + b2lo;
+    if ( sum < b0hi ){
+      b2hi++;
+    }
+    dist = j - 64;
+    return ( b2hi << ( 64 - dist ) ) | ( sum >> dist );
+#endif
+  }
+
+  /*!
+    \brief number of decimal digits of v ( v < 10^17 )
+  */
+  static int dtoa_length ( uint64 v )
+  {
+    int    n = 1;
+    uint64 p = 10;
+    while ( n < 17 && v >= p ){
+      p *= 10;
+      n++;
+    }
+    return n;
+  }
+
+  /*!
+    Computes the shortest decimal output*10^exp in the rounding
+    interval of the double given by its IEEE mantissa and exponent
+    bits. Among the shortest values the one nearest to the double
+    is chosen.
+    \brief Ryu shortest decimal of a finite, nonzero double
+    \param ieee_m mantissa bits
+    \param ieee_e exponent bits
+    \param exp    pointer to decimal exponent of result
+    \return the decimal digits as integer
+  */
+  static uint64 dtoa_shortest_decimal ( uint64 ieee_m, uint32 ieee_e, int * exp )
+  {
+    int     e2, e10, q, k, i, j;
+    uint64  m2, mv, vr, vp, vm, output;
+    uint32  mmshift;
+    bool    even, vm_tz = false, vr_tz = false;
+    int     removed = 0;
+    int     last_removed = 0;
+
+    if ( ieee_e == 0 ){
+      e2 = 1 - DTOA_BIAS - DTOA_MANTISSA_BITS - 2;
+      m2 = ieee_m;
+    } else {
+      e2 = ( int ) ieee_e - DTOA_BIAS - DTOA_MANTISSA_BITS - 2;
+      m2 = ( UINT64CONST(1) << DTOA_MANTISSA_BITS ) | ieee_m;
+    }
+    even    = ( m2 & 1 ) == 0;
+    mv      = 4 * m2;
+    mmshift = ( ieee_m != 0 || ieee_e <= 1 ) ? 1 : 0;
+
+    /* interval [vm, vp] around vr in a decimal power base */
+    if ( e2 >= 0 ){
+      q   = dtoa_log10pow2 ( e2 ) - ( e2 > 3 );
+      e10 = q;
+      k   = DTOA_POW5_INV_BITCOUNT + dtoa_pow5bits ( q ) - 1;
+      i   = -e2 + q + k;
+      vr  = dtoa_mulshift ( 4 * m2, dtoa_pow5_inv_split[q], i );
+      vp  = dtoa_mulshift ( 4 * m2 + 2, dtoa_pow5_inv_split[q], i );
+      vm  = dtoa_mulshift ( 4 * m2 - 1 - mmshift, dtoa_pow5_inv_split[q], i );
+      if ( q <= 21 ){
+        if ( mv % 5 == 0 ){
+          vr_tz = dtoa_multiple_of_pow5 ( mv, q );
+        } else if ( even ){
+          vm_tz = dtoa_multiple_of_pow5 ( mv - 1 - mmshift, q );
+        } else if ( dtoa_multiple_of_pow5 ( mv + 2, q ) ){
+          vp--;
+        }
+      }
+    } else {
+      q   = dtoa_log10pow5 ( -e2 ) - ( -e2 > 1 );
+      e10 = q + e2;
+      i   = -e2 - q;
+      k   = dtoa_pow5bits ( i ) - DTOA_POW5_BITCOUNT;
+      j   = q - k;
+      vr  = dtoa_mulshift ( 4 * m2, dtoa_pow5_split[i], j );
+      vp  = dtoa_mulshift ( 4 * m2 + 2, dtoa_pow5_split[i], j );
+      vm  = dtoa_mulshift ( 4 * m2 - 1 - mmshift, dtoa_pow5_split[i], j );
+      if ( q <= 1 ){
+        vr_tz = true;
+        if ( even ){
+          vm_tz = ( mmshift == 1 );
+        } else {
+          vp--;
+        }
+      } else if ( q < 63 ){
+        vr_tz = dtoa_multiple_of_pow2 ( mv, q );
+      }
+    }
+
+    /* remove digits as long as the interval allows it */
+    if ( vm_tz || vr_tz ){
+      while ( vp / 10 > vm / 10 ){
+        vm_tz &= ( vm % 10 == 0 );
+        vr_tz &= ( last_removed == 0 );
+        last_removed = ( int ) ( vr % 10 );
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        removed++;
+      }
+      if ( vm_tz ){
+        while ( vm % 10 == 0 ){
+          vr_tz &= ( last_removed == 0 );
+          last_removed = ( int ) ( vr % 10 );
+          vr /= 10;
+          vp /= 10;
+          vm /= 10;
+          removed++;
+        }
+      }
+      if ( vr_tz && last_removed == 5 && vr % 2 == 0 ){
+        /* exact tie, round to even */
+        last_removed = 4;
+      }
+      output = vr + ( ( vr == vm && ( !even || !vm_tz ) ) || last_removed >= 5 );
+    } else {
+      bool round_up = false;
+      while ( vp / 10 > vm / 10 ){
+        round_up = ( vr % 10 >= 5 );
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        removed++;
+      }
+      output = vr + ( vr == vm || round_up );
+    }
+    *exp = e10 + removed;
+    return output;
+  }
+
+  /*!
+    \brief shortest digits of a finite, nonzero double
+    \param ieee_m mantissa bits
+    \param ieee_e exponent bits
+    \param dd     pointer to result, dd->d must hold 17 digits
+  */
+  static void dtoa_shortest_digits ( uint64 ieee_m, uint32 ieee_e, DtoaDigits * dd )
+  {
+    int    exp, n, i;
+    uint64 output = dtoa_shortest_decimal ( ieee_m, ieee_e, &exp );
+
+    while ( output % 10 == 0 ){
+      output /= 10;
+      exp++;
+    }
+    n = dtoa_length ( output );
+    for ( i = n - 1; i >= 0; i-- ){
+      dd->d[i] = '0' + ( char ) ( output % 10 );
+      output  /= 10;
+    }
+    dd->nd  = n;
+    dd->exp = exp + n - 1;
+  }
+
+  /*!
+    Computes all decimal digits of m*2^e2 with big integer
+    arithmetic. A double has at most 767 significant digits.
+    \brief exact decimal digits of a finite, nonzero double
+    \param m  integer mantissa
+    \param e2 binary exponent
+    \param dd pointer to result, dd->d must hold DTOA_EXACT_DIGITS digits
+  */
+  static void dtoa_exact_digits ( uint64 m, int e2, DtoaDigits * dd )
+  {
+    uint32  big[DTOA_BIG_WORDS];
+    uint32  chunk[DTOA_BIG_WORDS * 10 / 9 + 2];
+    int     n = 0, nc = 0, i, k, nd;
+    uint64  t;
+
+    big[n++] = ( uint32 ) m;
+    if ( m >> 32 ){
+      big[n++] = ( uint32 ) ( m >> 32 );
+    }
+
+    if ( e2 >= 0 ){
+      /* shift left by e2 bits */
+      int words = e2 / 32, bits = e2 % 32;
+      if ( bits > 0 ){
+        uint32 carry = 0;
+        for ( i = 0; i < n; i++ ){
+          t      = ( ( uint64 ) big[i] << bits ) | carry;
+          big[i] = ( uint32 ) t;
+          carry  = ( uint32 ) ( t >> 32 );
+        }
+        if ( carry ){
+          big[n++] = carry;
+        }
+      }
+      if ( words > 0 ){
+        memmove ( &big[words], &big[0], n * sizeof ( uint32 ) );
+        memset ( &big[0], 0, words * sizeof ( uint32 ) );
+        n += words;
+      }
+    } else {
+      /* multiply with 5^-e2, the value is big * 10^e2 */
+      k = -e2;
+      while ( k > 0 ){
+        uint32 f = 1;
+        uint32 carry = 0;
+        for ( i = 0; i < 13 && k > 0; i++, k-- ){
+          f *= 5;
+        }
+        for ( i = 0; i < n; i++ ){
+          t      = ( uint64 ) big[i] * f + carry;
+          big[i] = ( uint32 ) t;
+          carry  = ( uint32 ) ( t >> 32 );
+        }
+        if ( carry ){
+          big[n++] = carry;
+        }
+      }
+    }
+
+    /* convert to base 10^9, least significant chunk first */
+    while ( n > 0 ){
+      uint64 rem = 0;
+      for ( i = n - 1; i >= 0; i-- ){
+        t      = ( rem << 32 ) | big[i];
+        big[i] = ( uint32 ) ( t / 1000000000 );
+        rem    = t % 1000000000;
+      }
+      chunk[nc++] = ( uint32 ) rem;
+      while ( n > 0 && big[n - 1] == 0 ){
+        n--;
+      }
+    }
+
+    /* most significant chunk without leading zeros */
+    nd = 0;
+    {
+      char   tmp[10];
+      int    l = 0;
+      uint32 c = chunk[nc - 1];
+      while ( c > 0 ){
+        tmp[l++] = '0' + ( char ) ( c % 10 );
+        c       /= 10;
+      }
+      while ( l > 0 ){
+        dd->d[nd++] = tmp[--l];
+      }
+    }
+    for ( i = nc - 2; i >= 0; i-- ){
+      uint32 c = chunk[i];
+      for ( k = 8; k >= 0; k-- ){
+        dd->d[nd + k] = '0' + ( char ) ( c % 10 );
+        c /= 10;
+      }
+      nd += 9;
+    }
+    dd->exp = nd - 1 + ( ( e2 < 0 ) ? e2 : 0 );
+    while ( nd > 0 && dd->d[nd - 1] == '0' ){
+      nd--;
+    }
+    dd->nd = nd;
+  }
+
+  /*!
+    Rounds to keep digits, to nearest with ties to even.
+    \brief rounds decimal digits
+    \param dd   pointer to digits
+    \param keep number of digits to keep, may be less than one
+  */
+  static void dtoa_round ( DtoaDigits * dd, int keep )
+  {
+    bool up;
+    int  i;
+
+    if ( keep >= dd->nd ){
+      return;
+    }
+    if ( keep < 0 ){
+      dd->nd = 0;
+      return;
+    }
+    if ( keep == 0 ){
+      up = ( dd->d[0] > '5' || ( dd->d[0] == '5' && dd->nd > 1 ) );
+    } else {
+      up = ( dd->d[keep] > '5' ||
+             ( dd->d[keep] == '5' &&
+               ( dd->nd > keep + 1 || ( ( dd->d[keep - 1] - '0' ) & 1 ) ) ) );
+    }
+    dd->nd = keep;
+    if ( up ){
+      for ( i = keep - 1; i >= 0; i-- ){
+        if ( dd->d[i] == '9' ){
+          dd->d[i] = '0';
+        } else {
+          dd->d[i]++;
+          break;
+        }
+      }
+      if ( i < 0 ){
+        dd->d[0] = '1';
+        dd->nd   = 1;
+        dd->exp++;
+      }
+    }
+    while ( dd->nd > 0 && dd->d[dd->nd - 1] == '0' ){
+      dd->nd--;
+    }
+  }
+
+  /*!
+    Sets the digits of v rounded to keep digits. keep is computed
+    from the exponent of the value by keep_fn. The shortest digits are
+    used if they determine the result, the exact ones otherwise.
+    \brief rounded digits of a finite, nonzero double
+    \param v     the value
+    \param dd    pointer to result, dd->d must hold DTOA_EXACT_DIGITS digits
+    \param prec  precision
+    \param fixed if true, prec counts decimals, otherwise significant digits
+  */
+  static void dtoa_rounded_digits ( double v, DtoaDigits * dd, int prec, bool fixed )
+  {
+    uint64  bits, ieee_m;
+    uint32  ieee_e;
+    int     keep;
+    bool    exact = false;
+
+    memcpy ( &bits, &v, sizeof ( double ) );
+    ieee_m = bits & ( ( UINT64CONST(1) << DTOA_MANTISSA_BITS ) - 1 );
+    ieee_e = ( uint32 ) ( bits >> DTOA_MANTISSA_BITS ) & ( ( 1u << DTOA_EXPONENT_BITS ) - 1 );
+
+    if ( ieee_e == 0 ){
+      /* subnormal values have less precision than the shortest digits suggest */
+      exact = true;
+    } else {
+      dtoa_shortest_digits ( ieee_m, ieee_e, dd );
+      keep = ( fixed ) ? ( dd->exp + 1 + prec ) : prec;
+      if ( keep >= dd->nd ){
+        exact = ( keep > DTOA_SAFE_DIGITS );
+      } else {
+        exact = ( keep == dd->nd - 1 && dd->d[keep] == '5' );
+      }
+    }
+
+    if ( exact ){
+      if ( ieee_e == 0 ){
+        dtoa_exact_digits ( ieee_m, 1 - DTOA_BIAS - DTOA_MANTISSA_BITS, dd );
+      } else {
+        dtoa_exact_digits ( ( UINT64CONST(1) << DTOA_MANTISSA_BITS ) | ieee_m,
+                            ( int ) ieee_e - DTOA_BIAS - DTOA_MANTISSA_BITS, dd );
+      }
+    }
+    keep = ( fixed ) ? ( dd->exp + 1 + prec ) : prec;
+    dtoa_round ( dd, keep );
+  }
+
+  /*!
+    \brief writes nan or inf
+    \return length of written text, zero if v is finite
+  */
+  static int dtoa_special ( double v, char * buf )
+  {
+    int n = 0;
+    if ( isnan ( v ) ){
+      if ( signbit ( v ) ){
+        buf[n++] = '-';
+      }
+      memcpy ( &buf[n], "nan", 4 );
+      return n + 3;
+    }
+    if ( isinf ( v ) ){
+      if ( v < 0 ){
+        buf[n++] = '-';
+      }
+      memcpy ( &buf[n], "inf", 4 );
+      return n + 3;
+    }
+    return 0;
+  }
+
+  /*!
+    Writes the digits like "%g" does after removing trailing zeros.
+    Exponential notation is used if the exponent is less than -4
+    or not less than prec.
+    \brief writes digits in "%g" style
+    \return length of written text
+  */
+  static int dtoa_write_g ( char * buf, bool neg, const DtoaDigits * dd, int prec )
+  {
+    char * p = buf;
+    int    x = dd->exp, i;
+
+    if ( neg ){
+      *p++ = '-';
+    }
+    if ( dd->nd == 0 ){
+      *p++ = '0';
+    } else if ( x < -4 || x >= prec ){
+      *p++ = dd->d[0];
+      if ( dd->nd > 1 ){
+        *p++ = '.';
+        memcpy ( p, &dd->d[1], dd->nd - 1 );
+        p += dd->nd - 1;
+      }
+      *p++ = 'e';
+      if ( x < 0 ){
+        *p++ = '-';
+        x    = -x;
+      } else {
+        *p++ = '+';
+      }
+      if ( x >= 100 ){
+        *p++ = '0' + x / 100;
+        x   %= 100;
+      }
+      *p++ = '0' + x / 10;
+      *p++ = '0' + x % 10;
+    } else if ( x < 0 ){
+      *p++ = '0';
+      *p++ = '.';
+      for ( i = x + 1; i < 0; i++ ){
+        *p++ = '0';
+      }
+      memcpy ( p, dd->d, dd->nd );
+      p += dd->nd;
+    } else {
+      for ( i = 0; i <= x; i++ ){
+        *p++ = ( i < dd->nd ) ? dd->d[i] : '0';
+      }
+      if ( dd->nd > x + 1 ){
+        *p++ = '.';
+        memcpy ( p, &dd->d[x + 1], dd->nd - x - 1 );
+        p += dd->nd - x - 1;
+      }
+    }
+    *p = '\0';
+    return ( int ) ( p - buf );
+  }
+
+
+  int pgs_dtoa_shortest ( double v, char * buf )
+  {
+    char        digits[17];
+    DtoaDigits  dd;
+    uint64      bits;
+    int         n = dtoa_special ( v, buf );
+
+    if ( n > 0 ){
+      return n;
+    }
+    dd.d  = digits;
+    dd.nd = 0;
+    dd.exp = 0;
+    if ( v != 0.0 ){
+      memcpy ( &bits, &v, sizeof ( double ) );
+      dtoa_shortest_digits (
+        bits & ( ( UINT64CONST(1) << DTOA_MANTISSA_BITS ) - 1 ),
+        ( uint32 ) ( bits >> DTOA_MANTISSA_BITS ) & ( ( 1u << DTOA_EXPONENT_BITS ) - 1 ),
+        &dd
+      );
+    }
+    return dtoa_write_g ( buf, ( signbit ( v ) != 0 ), &dd, DTOA_SAFE_DIGITS );
+  }
+
+
+  int pgs_dtoa_g ( double v, int prec, char * buf )
+  {
+    char        digits[DTOA_EXACT_DIGITS];
+    DtoaDigits  dd;
+    int         n = dtoa_special ( v, buf );
+
+    if ( n > 0 ){
+      return n;
+    }
+    if ( prec < 1 ){
+      prec = 1;
+    }
+    if ( prec > DTOA_MAX_PRECISION ){
+      prec = DTOA_MAX_PRECISION;
+    }
+    dd.d  = digits;
+    dd.nd = 0;
+    dd.exp = 0;
+    if ( v != 0.0 ){
+      dtoa_rounded_digits ( v, &dd, prec, false );
+    }
+    return dtoa_write_g ( buf, ( signbit ( v ) != 0 ), &dd, prec );
+  }
+
+
+  int pgs_dtoa_f ( double v, int width, int prec, bool zero, char * buf )
+  {
+    char        digits[DTOA_EXACT_DIGITS];
+    char        tmp[DTOA_BUFLEN];
+    DtoaDigits  dd;
+    char      * p = tmp;
+    int         n, i, pad;
+    bool        neg = ( signbit ( v ) != 0 );
+
+    if ( prec < 0 ){
+      prec = 0;
+    }
+    if ( prec > DTOA_MAX_PRECISION ){
+      prec = DTOA_MAX_PRECISION;
+    }
+    n = dtoa_special ( v, tmp );
+    if ( n > 0 ){
+      zero = false;
+      neg  = false;
+      p   += n;
+    } else {
+      dd.d  = digits;
+      dd.nd = 0;
+      dd.exp = 0;
+      if ( v != 0.0 ){
+        dtoa_rounded_digits ( v, &dd, prec, true );
+      }
+      if ( dd.nd == 0 || dd.exp < 0 ){
+        *p++ = '0';
+      } else {
+        for ( i = 0; i <= dd.exp; i++ ){
+          *p++ = ( i < dd.nd ) ? dd.d[i] : '0';
+        }
+      }
+      if ( prec > 0 ){
+        *p++ = '.';
+        for ( i = 1; i <= prec; i++ ){
+          int k = dd.exp + i;
+          *p++ = ( dd.nd > 0 && k >= 0 && k < dd.nd ) ? dd.d[k] : '0';
+        }
+      }
+    }
+    n   = ( int ) ( p - tmp );
+    pad = width - n - ( neg ? 1 : 0 );
+
+    p = buf;
+    if ( !zero ){
+      for ( i = 0; i < pad; i++ ){
+        *p++ = ' ';
+      }
+    }
+    if ( neg ){
+      *p++ = '-';
+    }
+    if ( zero ){
+      for ( i = 0; i < pad; i++ ){
+        *p++ = '0';
+      }
+    }
+    memcpy ( p, tmp, n );
+    p += n;
+    *p = '\0';
+    return ( int ) ( p - buf );
+  }
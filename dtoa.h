@@ -0,0 +1,63 @@
+#ifndef __PGS_DTOA_H__
+#define __PGS_DTOA_H__
+
+#include "pg_sphere.h"
+
+/*!
+  \file
+  \brief Conversion of double values to text
+*/
+
+/*!
+  Large enough for any double written by the functions below with
+  a precision up to DTOA_MAX_PRECISION, including the terminating
+  zero.
+  \brief buffer size of a formatted double
+*/
+#define DTOA_BUFLEN        352
+
+/*!
+  \brief maximum precision of pgs_dtoa_g and pgs_dtoa_f
+*/
+#define DTOA_MAX_PRECISION 24
+
+/*!
+  \brief maximum length of a double written by pgs_dtoa_shortest or
+  pgs_dtoa_g, including the terminating zero
+*/
+#define DTOA_SHORT_BUFLEN  32
+
+
+/*!
+  Writes the shortest decimal representation that reads back
+  as the same double value. Values with a decimal exponent
+  from -4 to 14 are written in fixed notation, all others in
+  exponential notation as "%g" does.
+  \brief writes the shortest round trip text of a double
+  \param v   the value
+  \param buf output buffer of at least DTOA_SHORT_BUFLEN bytes
+  \return length of the written text without terminating zero
+*/
+int pgs_dtoa_shortest ( double v, char * buf );
+
+/*!
+  \brief writes a double like sprintf's "%.*g"
+  \param v    the value
+  \param prec number of significant digits ( 1 .. DTOA_MAX_PRECISION )
+  \param buf  output buffer of at least DTOA_BUFLEN bytes
+  \return length of the written text without terminating zero
+*/
+int pgs_dtoa_g ( double v, int prec, char * buf );
+
+/*!
+  \brief writes a double like sprintf's "%*.*f" or "%0*.*f"
+  \param v     the value
+  \param width minimum field width
+  \param prec  number of decimals ( 0 .. DTOA_MAX_PRECISION )
+  \param zero  if true, pad with leading zeros instead of blanks
+  \param buf   output buffer of at least max(width+1,DTOA_BUFLEN) bytes
+  \return length of the written text without terminating zero
+*/
+int pgs_dtoa_f ( double v, int width, int prec, bool zero, char * buf );
+
+#endif
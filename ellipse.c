@@ -1,4 +1,5 @@
 #include "ellipse.h"
+#include "stats.h"
 
 /*!
   \file
@@ -9,6 +10,8 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
   PG_FUNCTION_INFO_V1(sphereellipse_in);
+  PG_FUNCTION_INFO_V1(sphereellipse_recv);
+  PG_FUNCTION_INFO_V1(sphereellipse_send);
   PG_FUNCTION_INFO_V1(sphereellipse_infunc);
   PG_FUNCTION_INFO_V1(sphereellipse_incl);
   PG_FUNCTION_INFO_V1(sphereellipse_rad1);
@@ -76,7 +79,7 @@
   */
   static SELLIPSE * sellipse_check ( SELLIPSE * e )
   {
-    static SPoint sp;
+    SPoint sp;
     sp.lng    = e->phi    ;
     spoint_check ( &sp )  ;
     if ( sp.lng < PI ){
@@ -104,7 +107,7 @@
   */
   static SCIRCLE * sellipse_circle( SCIRCLE * sc, const SELLIPSE * e )
   {
-    static SPoint sp ;
+    SPoint sp ;
     sellipse_center( &sp, e );
     memcpy( (void*) &sc->center, (void*) &sp, sizeof(SPoint) );
     sc->radius = e->rad[0];
@@ -121,7 +124,7 @@
     \note The largest axis length is choosen for large axis
     \return pointer to ellipse
   */
-  static SELLIPSE * sellipse_in( float8 r1, float8 r2, const SPoint * c, float8 inc )
+  PGS_KERNEL SELLIPSE * sellipse_in( float8 r1, float8 r2, const SPoint * c, float8 inc )
   {
     SELLIPSE  * e  = ( SELLIPSE * ) MALLOC ( sizeof ( SELLIPSE ) ) ;
     e->rad[0]      = max(r1,r2);
@@ -148,7 +151,7 @@
   */
   static float8  sellipse_dist ( float8 rada, float8 radb , float8 ang )
   {
-        static float8 e;
+        float8 e;
         e = ( 1 - sqr ( sin ( radb ) ) / sqr ( sin ( rada ) ) ) ;
         return ( asin ( sin ( radb ) / sqrt( 1 - e * sqr( cos(ang) ) ) ) );
   }
@@ -165,9 +168,9 @@
   */
   static float8  sellipse_point_dist ( const SELLIPSE * se, const SPoint * sp )
   {
-    static SEuler e ;
-    static SPoint p ;
-    static float8 dist,rad,ang ;
+    SEuler e ;
+    SPoint p ;
+    float8 dist,rad,ang ;
     
     sellipse_trans( &e , se );
     spheretrans_inv( &e );
@@ -203,9 +206,9 @@
   */
   static SELLIPSE  * euler_sellipse_trans ( SELLIPSE * out , const SELLIPSE * in , const SEuler * se )
   {
-    static SEuler et;
-    static SLine  sl[2];
-    static SPoint p[2];
+    SEuler et;
+    SLine  sl[2];
+    SPoint p[2];
 
     sellipse_trans ( &et , in );
     sl[0].length = PIH;
@@ -232,15 +235,240 @@
   }
 
 
+  /*!
+    \brief Boundary of an ellipse seen from the frame of a second ellipse
+  */
+  typedef struct {
+    SEulerMatrix m  ; //!< rotation matrix from first to second ellipse frame
+    float8  sa      ; //!< sine of major axis of first ellipse
+    float8  sb      ; //!< sine of minor axis of first ellipse
+    float8  ca      ; //!< squared cotangent of major axis of second ellipse
+    float8  cb      ; //!< squared cotangent of minor axis of second ellipse
+  } SELLIPSE_BOUND ;
+
+
+  /*!
+    \brief Sets up the boundary of first ellipse relative to second one
+    \param eb  pointer to result
+    \param se1 pointer to first ellipse
+    \param se2 pointer to second ellipse
+    \return pointer to result
+  */
+  static SELLIPSE_BOUND * sellipse_bound_init ( SELLIPSE_BOUND * eb, const SELLIPSE * se1, const SELLIPSE * se2 )
+  {
+    SEuler        et ;
+    SEulerMatrix  m[2] ;
+
+    seuler_matrix      ( &m[0], sellipse_trans ( &et, se1 ) );
+    seuler_matrix_inv  ( &m[1], sellipse_trans ( &et, se2 ) );
+    seuler_matrix_mult ( &eb->m, &m[1], &m[0] );
+    eb->sa = sin ( se1->rad[0] );
+    eb->sb = sin ( se1->rad[1] );
+    eb->ca = sqr ( cos ( se2->rad[0] ) / sin ( se2->rad[0] ) );
+    eb->cb = sqr ( cos ( se2->rad[1] ) / sin ( se2->rad[1] ) );
+    return eb;
+  }
+
+
+  /*!
+    \brief Returns the boundary point of first ellipse at given parameter
+    \param u   pointer to result vector in frame of first ellipse
+    \param du  pointer to derivative of result, may be NULL
+    \param eb  pointer to ellipse boundary
+    \param s   boundary parameter in radians
+    \return pointer to result vector
+  */
+  static Vector3D * sellipse_bound_point ( Vector3D * u, Vector3D * du, const SELLIPSE_BOUND * eb, float8 s )
+  {
+    float8 cs = cos ( s ) ;
+    float8 ss = sin ( s ) ;
+
+    u->y = eb->sa * cs ;
+    u->z = eb->sb * ss ;
+    u->x = sqrt ( 1.0 - sqr ( u->y ) - sqr ( u->z ) );
+    if ( du ){
+      du->x = ( sqr ( eb->sa ) - sqr ( eb->sb ) ) * ss * cs / u->x ;
+      du->y = - eb->sa * ss ;
+      du->z =   eb->sb * cs ;
+    }
+    return u;
+  }
+
+
+  /*!
+    \brief Measures how deep a boundary point of first ellipse lies
+           inside the second ellipse
+    \param eb    pointer to ellipse boundary
+    \param s     boundary parameter in radians
+    \param deriv pointer to derivative with respect to s
+    \return a value greater than zero, if the point is inside
+            the second ellipse
+  */
+  static float8 sellipse_bound_func ( const SELLIPSE_BOUND * eb, float8 s, float8 * deriv )
+  {
+    Vector3D  u, du, v, dv ;
+    float8    q ;
+
+    sellipse_bound_point ( &u, &du, eb, s );
+    euler_matrix_vector_trans ( &v , &u , &eb->m );
+    euler_matrix_vector_trans ( &dv, &du, &eb->m );
+    q = sqrt ( eb->ca * sqr ( v.y ) + eb->cb * sqr ( v.z ) );
+    if ( q > 0.0 ){
+      *deriv = dv.x - ( eb->ca * v.y * dv.y + eb->cb * v.z * dv.z ) / q ;
+    } else {
+      *deriv = dv.x ;
+    }
+    return ( v.x - q );
+  }
+
+
+  /*!
+    \brief Searches a local maximum of sellipse_bound_func using Brent's
+           method on its derivative
+    \param eb pointer to ellipse boundary
+    \param a  lower boundary parameter, derivative must be positive
+    \param fa derivative at a
+    \param b  upper boundary parameter, derivative must be negative
+    \param fb derivative at b
+    \return boundary parameter of local maximum
+    \note Since the bracket keeps its sign orientation, the result
+          is always a maximum and never a minimum.
+  */
+  static float8 sellipse_bound_max ( const SELLIPSE_BOUND * eb, float8 a, float8 fa, float8 b, float8 fb )
+  {
+    static const int maxiter = 64 ;
+    float8  c, fc, d, e, p, q, r, s, tol, xm, m1, m2 ;
+    int     i ;
+
+    c  = b ;
+    fc = fb ;
+    d  = e = b - a ;
+    for ( i=0; i<maxiter; i++ ){
+      PGS_STAT_INC ( PGS_STAT_SELLIPSE_POS_ITER );
+      if ( ( fb > 0.0 && fc > 0.0 ) || ( fb < 0.0 && fc < 0.0 ) ){
+        c  = a ;
+        fc = fa ;
+        d  = e = b - a ;
+      }
+      if ( fabs ( fc ) < fabs ( fb ) ){
+        a  = b  ; b  = c  ; c  = a  ;
+        fa = fb ; fb = fc ; fc = fa ;
+      }
+      tol = 2.0 * DBL_EPSILON * fabs ( b ) + 0.5 * EPSILON ;
+      xm  = 0.5 * ( c - b );
+      if ( fabs ( xm ) <= tol || fb == 0.0 ){
+        break;
+      }
+      if ( fabs ( e ) >= tol && fabs ( fa ) > fabs ( fb ) ){
+        // inverse quadratic interpolation or secant step
+        s = fb / fa ;
+        if ( a == c ){
+          p = 2.0 * xm * s ;
+          q = 1.0 - s ;
+        } else {
+          q = fa / fc ;
+          r = fb / fc ;
+          p = s * ( 2.0 * xm * q * ( q - r ) - ( b - a ) * ( r - 1.0 ) );
+          q = ( q - 1.0 ) * ( r - 1.0 ) * ( s - 1.0 );
+        }
+        if ( p > 0.0 ){
+          q = -q ;
+        }
+        p  = fabs ( p );
+        m1 = 3.0 * xm * q - fabs ( tol * q );
+        m2 = fabs ( e * q );
+        if ( 2.0 * p < ( ( m1 < m2 ) ? m1 : m2 ) ){
+          e = d ;
+          d = p / q ;
+        } else {
+          d = e = xm ;
+        }
+      } else {
+        // bisection
+        d = e = xm ;
+      }
+      a  = b ;
+      fa = fb ;
+      if ( fabs ( d ) > tol ){
+        b += d ;
+      } else {
+        b += ( xm > 0.0 ) ? tol : -tol ;
+      }
+      sellipse_bound_func ( eb, b, &fb );
+    }
+    return b;
+  }
+
+
+  /*!
+    \brief Checks whether the boundary of first ellipse overlaps the
+           second ellipse
+    \param se1 pointer to first ellipse
+    \param se2 pointer to second ellipse
+    \return true, if a boundary point of se1 is inside se2
+
+    The boundary of se1 is sampled at fixed steps beginning at the
+    position angle of the center of se2. Every local maximum of
+    sellipse_bound_func found between the samples is refined with
+    sellipse_bound_max. The candidates are checked using
+    sellipse_point_dist to keep the tolerance of the other
+    ellipse functions.
+  */
+  static bool sellipse_bound_over ( const SELLIPSE * se1, const SELLIPSE * se2 )
+  {
+    static const int nsteps = 32 ;
+    SELLIPSE_BOUND  eb ;
+    SEuler          et ;
+    SEulerMatrix    m ;
+    Vector3D        u, v ;
+    SPoint          sp ;
+    float8          s0, s[2], df[2], sm, dm ;
+    bool            cand ;
+    int             i ;
+
+    sellipse_bound_init ( &eb, se1, se2 );
+    seuler_matrix ( &m, sellipse_trans ( &et, se1 ) );
+
+    // center of se2 in frame of se1 is the first row of matrix
+    s0    = atan2 ( eb.m.m[0][2] / eb.sb , eb.m.m[0][1] / eb.sa );
+    s[0]  = s0 ;
+    df[0] = 0.0 ;
+
+    for ( i=0; i<=nsteps; i++ ){
+      PGS_STAT_INC ( PGS_STAT_SELLIPSE_POS_ITER );
+      s[1] = s0 + ( PID * i ) / nsteps ;
+      sm   = s[1] ;
+      cand = ( sellipse_bound_func ( &eb, s[1], &df[1] ) > 0.0 );
+      if ( !cand && df[0] > 0.0 && df[1] < 0.0 ){
+        sm   = sellipse_bound_max ( &eb, s[0], df[0], s[1], df[1] );
+        cand = ( sellipse_bound_func ( &eb, sm, &dm ) > 0.0 );
+      }
+      if ( cand ){
+        sellipse_bound_point ( &u, NULL, &eb, sm );
+        euler_matrix_vector_trans ( &v, &u, &m );
+        vector3d_spoint ( &sp, &v );
+        if ( sellipse_point_dist ( se2, &sp ) < 0.0 ){
+          return TRUE;
+        }
+      }
+      s[0]  = s[1] ;
+      df[0] = df[1] ;
+    }
+    return FALSE;
+  }
+
+
   /*!
     \brief Returns the relationship between two ellipses
     \param se1 pointer to first ellipse
     \param se2  pointer to second ellipse
     \return relationship as a \link PGS_ELLIPSE_ELLIPSE_REL int8 value \endlink (\ref PGS_ELLIPSE_ELLIPSE_REL )
   */
-  static int8 sellipse_ellipse_pos ( const SELLIPSE * se1 , const SELLIPSE * se2 )
+  PGS_KERNEL int8 sellipse_ellipse_pos ( const SELLIPSE * se1 , const SELLIPSE * se2 )
   {
-     static int8    r;
+     int8    r;
+
+     PGS_STAT_INC ( PGS_STAT_SELLIPSE_POS );
 
      // equality
      if ( sellipse_eq ( se1 , se2 ) )
@@ -251,7 +479,7 @@
      // se2 is circle or point
      if ( FPeq ( se2->rad[0], se2->rad[1] ) ) {
 
-       static SCIRCLE c;
+       SCIRCLE c;
        sellipse_circle( &c, se2 );
        r = sellipse_circle_pos ( se1 , &c );
 
@@ -269,7 +497,7 @@
 
      if ( FPeq ( se1->rad[0], se1->rad[1] ) ) {
 
-       static SCIRCLE c;
+       SCIRCLE c;
        sellipse_circle( &c, se1 );
        r = sellipse_circle_pos ( se2 , &c );
        switch ( r ){
@@ -285,7 +513,7 @@
      // se2 is line
 
      if ( FPzero ( se2->rad[1] ) ) {
-       static SLine  l;
+       SLine  l;
        sellipse_line( &l, se2 );
        r = sellipse_line_pos ( se1 , &l );
        switch ( r ){
@@ -300,7 +528,7 @@
      // se1 is line
 
      if ( FPzero ( se1->rad[1] ) ) {
-       static SLine  l;
+       SLine  l;
        sellipse_line( &l, se1 );
        r = sellipse_line_pos ( se2 , &l );
        switch ( r ){
@@ -316,8 +544,8 @@
 
      do {
 
-       static SPoint p1, p2 ;
-       static float8   dist ;
+       SPoint p1, p2 ;
+       float8   dist ;
 
        // check inner and outer circles
        sellipse_center( &p1, se1 );
@@ -334,111 +562,10 @@
 
        } else {
 
-         static SEuler       eul ;
-         static SELLIPSE etmp, e ;
-         static SPoint     sp[3] ;
-         static int            i ;
-         static float8   diff[3] ;
-         static float8      elng ;
-         static const int maxcntr = 100000;
-         static int         cntr ;
-
-       // transform se1 to north pol
-         sellipse_trans( &eul , se1 );
-         spheretrans_inv(&eul);
-         euler_sellipse_trans ( &etmp , se2 , &eul );
-
-         eul.phi     =   PIH  ;
-         eul.theta   =   PIH  ;
-         eul.psi     =     0  ;
-         eul.phi_a   =   EULER_AXIS_Z;
-         eul.theta_a =   EULER_AXIS_X;
-         eul.psi_a   =   EULER_AXIS_Z;
-         euler_sellipse_trans ( &e , &etmp , &eul );
-
-         etmp.rad[0]   = se1->rad[0] ;
-         etmp.rad[1]   = se1->rad[1] ;
-         etmp.phi      = 0.0 ;
-         etmp.theta    = -PIH;
-         etmp.psi      =  PIH;
-
-
-         // search for minimum distance
-
-         sp[0].lat = sp[2].lat = PIH - se1->rad[0] ;
-         sellipse_center( &sp[1], &e );
-
-         if ( FPeq(sp[1].lat,PIH) ){
-           elng = PIH;
-         } else {
-           elng      = sp[1].lng;
+         if ( sellipse_bound_over ( se1, se2 ) ){
+            return PGS_ELLIPSE_OVER ;
          }
-         if ( sin(elng) < 0 ){
-           sp[0].lng =    PI ;
-           sp[1].lng = 3*PIH ;
-           sp[2].lng =   PID  ;
-         } else {
-           sp[0].lng =   0.0 ;
-           sp[1].lng =   PIH ;
-           sp[2].lng =    PI ;
-         }
-         sp[1].lat = PIH - se1->rad[1] ;
-
-         cntr = 0;
-         do {
-
-           for ( i=0; i<3; i++ ){
-             diff[i] = sellipse_point_dist ( &e, &sp[i] );
-
-             if ( diff[i] < 0.0 ){
-                return  PGS_ELLIPSE_OVER ;
-             }
-
-           }
-           if ( diff[0] <= diff[1] && diff[1] <= diff[2] ){
-              memcpy( (void*) &sp[2], (void*) &sp[1], sizeof( SPoint ) );
-           } else
-           if ( diff[0] <= diff[2] && diff[2] <= diff[1] ){
-              if ( pgs_abs(sp[0].lng-elng) < pgs_abs(sp[2].lng-elng) ) {
-                  memcpy( (void*) &sp[2], (void*) &sp[1], sizeof( SPoint ) );
-              } else {
-                  memcpy( (void*) &sp[0], (void*) &sp[1], sizeof( SPoint ) );
-              }
-           } else
-           if ( diff[1] <= diff[0] && diff[0] <= diff[2] ){
-              memcpy( (void*) &sp[2], (void*) &sp[0], sizeof( SPoint ) );
-              memcpy( (void*) &sp[0], (void*) &sp[1], sizeof( SPoint ) );
-           } else
-           if ( diff[1] <= diff[2] && diff[2] <= diff[0] ){
-              memcpy( (void*) &sp[0], (void*) &sp[1], sizeof( SPoint ) );
-           } else
-           if ( diff[2] <= diff[0] && diff[0] <= diff[1] ){
-              if ( pgs_abs(sp[0].lng-elng) < pgs_abs(sp[2].lng-elng) ) {
-                  memcpy( (void*) &sp[2], (void*) &sp[1], sizeof( SPoint ) );
-              } else {
-                  memcpy( (void*) &sp[0], (void*) &sp[1], sizeof( SPoint ) );
-              }
-           } else
-           if ( diff[2] <= diff[1] && diff[1] <= diff[0] ){
-              memcpy( (void*) &sp[0], (void*) &sp[2], sizeof( SPoint ) );
-              memcpy( (void*) &sp[2], (void*) &sp[1], sizeof( SPoint ) );
-           }
-           if ( sp[2].lng < sp[0].lng ){
-              // switch here too
-              memcpy( (void*) &sp[1], (void*) &sp[0], sizeof( SPoint ) );
-              memcpy( (void*) &sp[0], (void*) &sp[2], sizeof( SPoint ) );
-              memcpy( (void*) &sp[2], (void*) &sp[1], sizeof( SPoint ) );
-           }
-           sp[1].lng = ( sp[0].lng + sp[2].lng )/ 2.0 ;
-           sp[1].lat = PIH - sellipse_dist ( etmp.rad[0], etmp.rad[1] , sp[1].lng );
-           cntr++;
-         } while ( cntr < maxcntr && ( ( sp[2].lng - sp[0].lng ) > FLT_EPSILON ) );
-         if ( cntr >= maxcntr ){
-           elog ( ERROR, "Bug found in pg_sphere function 'sellipse_ellipse_pos' ! \n Please report it to pg_sphere team.");
-         }
-         
-         sellipse_center( &sp[1], &e );
-         if ( sellipse_cont_point ( &etmp , &sp[1] ) ){
+         if ( sellipse_cont_point ( se1 , &p2 ) ){
             return PGS_ELLIPSE_CONT ;
          } else {
             return PGS_ELLIPSE_AVOID;
@@ -473,9 +600,9 @@
   SLine * sellipse_line( SLine * sl, const SELLIPSE * e )
   {
     if ( ! FPzero(e->rad[0]) ){
-      static SEuler se;
-      static SLine  slt;
-      static SPoint p[2];
+      SEuler se;
+      SLine  slt;
+      SPoint p[2];
       p[0].lat = p[1].lat = 0.0;
       p[0].lng = - e->rad[0];
       p[1].lng =   e->rad[0];
@@ -494,18 +621,18 @@
       return FALSE;
     } else
     if ( FPzero ( e1->rad[0] ) ){ // point
-      static SPoint p[2];
+      SPoint p[2];
       sellipse_center( &p[0], e1 );
       sellipse_center( &p[1], e2 );
       return spoint_eq ( &p[0], &p[1] );
     } else
     if ( FPeq ( e1->rad[0], e1->rad[1] ) ){ // circle
-      static SCIRCLE c[2];
+      SCIRCLE c[2];
       sellipse_circle( &c[0], e1 );
       sellipse_circle( &c[1], e2 );
       return scircle_eq ( &c[0], &c[1] );
     } else {
-      static  SEuler se[2] ;
+      SEuler se[2] ;
       sellipse_trans( &se[0], e1 );
       sellipse_trans( &se[1], e2 );
       return strans_eq ( &se[0], &se[1] );
@@ -576,8 +703,8 @@
 
     // ellipse is line
     if ( FPzero(se->rad[1]) ){
-      static SLine    l ;
-      static int8   res ;
+      SLine    l ;
+      int8   res ;
       sellipse_line( &l, se );
       res = sline_sline_pos( &l, sl );
       if (res == PGS_LINE_AVOID ){
@@ -734,8 +861,8 @@
     // ellipse is circle
     if ( FPeq(se->rad[0],se->rad[1]) ){
 
-      static SCIRCLE  tc ;
-      static float8 dist ;
+      SCIRCLE  tc ;
+      float8 dist ;
 
       sellipse_circle( &tc, se );
       if ( scircle_eq ( &tc, sc ) ){
@@ -757,8 +884,8 @@
 
     // ellipse is line
     if ( FPzero(se->rad[1]) ){
-      static SLine     l ;
-      static int8    res ;
+      SLine     l ;
+      int8    res ;
       sellipse_line( &l, se );
       res = sphereline_circle_pos ( &l , sc ) ;
       if (res == PGS_CIRCLE_LINE_AVOID ){
@@ -773,8 +900,8 @@
       // now ellipse is a real ellipse and 
       // circle is a real circle
 
-      static float8  dist ;
-      static SPoint     c ;
+      float8  dist ;
+      SPoint     c ;
       dist = spoint_dist ( &sc->center , sellipse_center( &c,se));
 
       if ( FPzero(dist) ){
@@ -789,9 +916,9 @@
 
       } else {
 
-        static SEuler     et ;
-        static SPoint      p ;
-        static float8   a, e ;
+        SEuler     et ;
+        SPoint      p ;
+        float8   a, e ;
         sellipse_trans( &et , se );
         spheretrans_inv ( &et );
         euler_spoint_trans ( &p, &sc->center, &et );
@@ -819,23 +946,56 @@
 
 
 
+#ifndef PGS_CORE
   Datum  sphereellipse_in(PG_FUNCTION_ARGS)
   {
     SELLIPSE  * e  = NULL ;
     char      * s  = PG_GETARG_CSTRING(0);
-    static SPoint p;
-    static double r1, r2, inc ;
+    SPoint      p;
+    double      r1, r2, inc ;
+    SParseBuffer * pb = sphere_parse ( s );
 
-    void sphere_yyparse( void );
-    init_buffer ( s );
-    sphere_yyparse();
-    if ( get_ellipse( &p.lng, &p.lat, &r1, &r2, &inc ) ){
+    if ( get_ellipse( pb, &p.lng, &p.lat, &r1, &r2, &inc ) ){
       e = sellipse_in( r1, r2, &p , inc );
-      reset_buffer();
+    } else {
+      elog ( ERROR , "sphereellipse_in: parse error" );
     }
+    free_buffer ( pb );
     PG_RETURN_POINTER( e );
   }
 
+  Datum sphereellipse_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo   buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SPoint       p;
+    float8       r1, r2, inc ;
+
+    r1  = pgs_getmsgfloat8 ( buf );
+    r2  = pgs_getmsgfloat8 ( buf );
+    spoint_getmsg ( &p, buf );
+    inc = pgs_getmsgfloat8 ( buf );
+    if ( r1 < 0.0 || r2 < 0.0 ){
+      elog ( ERROR , "sphereellipse_recv: radius must be not negative" );
+      PG_RETURN_NULL();
+    }
+    PG_RETURN_POINTER( sellipse_in( r1, r2, &p , inc ) );
+  }
+
+  Datum sphereellipse_send(PG_FUNCTION_ARGS)
+  {
+    SELLIPSE  * e  = ( SELLIPSE * ) PG_GETARG_POINTER(0);
+    SPoint      p;
+    StringInfoData buf;
+
+    sellipse_center ( &p, e );
+    pq_begintypsend ( &buf );
+    pq_sendfloat8 ( &buf, e->rad[0] );
+    pq_sendfloat8 ( &buf, e->rad[1] );
+    spoint_sendmsg ( &buf, &p );
+    pq_sendfloat8 ( &buf, e->phi );
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
+
   Datum sphereellipse_infunc (PG_FUNCTION_ARGS)
   {
     SPoint   * p   =  ( SPoint   * ) PG_GETARG_POINTER ( 0 ) ;
@@ -1176,4 +1336,5 @@
     euler_sellipse_trans ( out , e , &tmp );
     PG_RETURN_POINTER ( sellipse_check(out) );
   }
+#endif
 
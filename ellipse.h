@@ -130,6 +130,20 @@ typedef struct {
   */
   Datum sphereellipse_in              (PG_FUNCTION_ARGS);
 
+  /*!
+    \brief binary input function of spherical ellipse
+    \return spherical ellipse datum
+    \note PostgreSQL function
+  */
+  Datum sphereellipse_recv            (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief binary output function of spherical ellipse
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum sphereellipse_send            (PG_FUNCTION_ARGS);
+
   /*!
     \brief Input of spherical ellipse from center, axes and inclination
     \return spherical ellipse datum
@@ -433,4 +447,16 @@ typedef struct {
   */
   Datum spheretrans_ellipse_inv       (PG_FUNCTION_ARGS);
 
+#ifdef PGS_CORE
+
+  /*
+    Kernels of ellipse.c, which are static in the extension. See
+    PGS_KERNEL and the documentation of the definitions.
+  */
+  int8 sellipse_ellipse_pos ( const SELLIPSE * se1 , const SELLIPSE * se2 );
+  SELLIPSE * sellipse_in ( float8 r1, float8 r2, const SPoint * c, float8 inc );
+
+#endif
+
+
 #endif
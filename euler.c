@@ -9,6 +9,8 @@
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
   PG_FUNCTION_INFO_V1(spheretrans_in);
+  PG_FUNCTION_INFO_V1(spheretrans_recv);
+  PG_FUNCTION_INFO_V1(spheretrans_send);
   PG_FUNCTION_INFO_V1(spheretrans_from_float8);
   PG_FUNCTION_INFO_V1(spheretrans_from_float8_and_type);
   PG_FUNCTION_INFO_V1(spheretrans_equal);
@@ -27,12 +29,7 @@
 #endif
 
 
-  /**
-   * \brief Checks and modifies the Euler transformation
-   * \param e Euler transformation
-   * \return Euler transformation
-   */
-  static SEuler * spheretrans_check( SEuler * e ){
+  SEuler * spheretrans_check( SEuler * e ){
 
 	SPoint     sp[3];
 	sp[0].lat = sp[1].lat = sp[2].lat = 0.0;
@@ -50,19 +47,16 @@
   }
 
 
+#ifndef PGS_CORE
   Datum  spheretrans_in(PG_FUNCTION_ARGS)
   {
     SEuler   * se   = ( SEuler * ) MALLOC ( sizeof ( SEuler ) ) ;
     char      *  c  = PG_GETARG_CSTRING(0);
     unsigned char etype[3];
     int            i;
+    SParseBuffer * pb = sphere_parse ( c );
 
-    void sphere_yyparse( void );
-
-    init_buffer ( c );
-    sphere_yyparse();
-
-    if ( get_euler ( &se->phi, &se->theta, &se->psi, etype ) ){
+    if ( get_euler ( pb, &se->phi, &se->theta, &se->psi, etype ) ){
 
       for ( i=0; i<3; i++ ){
         switch ( i ){
@@ -73,16 +67,63 @@
       }
       spheretrans_check(se);
     } else {
-      reset_buffer();
       FREE( se );
       se = NULL;
       elog ( ERROR , "spheretrans_in: parse error" );
     }
-    reset_buffer();
+    free_buffer ( pb );
     PG_RETURN_POINTER( se );
   }
 
 
+  Datum  spheretrans_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SEuler   * se  = ( SEuler * ) MALLOC ( sizeof ( SEuler ) ) ;
+    unsigned char t = 0;
+    int            i;
+
+    se->phi   = pgs_getmsgfloat8 ( buf );
+    se->theta = pgs_getmsgfloat8 ( buf );
+    se->psi   = pgs_getmsgfloat8 ( buf );
+    for ( i=0; i<3; i++ ){
+      switch ( pq_getmsgbyte ( buf ) ){
+        case 'X': t = EULER_AXIS_X; break;
+        case 'Y': t = EULER_AXIS_Y; break;
+        case 'Z': t = EULER_AXIS_Z; break;
+        default : t = 0;
+      }
+      if ( t == 0 ){
+        FREE ( se );
+        elog ( ERROR , "spheretrans_recv: invalid axis format" );
+      }
+      switch ( i ){
+        case 0:  se->phi_a   = t; break;
+        case 1:  se->theta_a = t; break;
+        case 2:  se->psi_a   = t; break;
+      }
+    }
+    PG_RETURN_POINTER( spheretrans_check(se) );
+  }
+
+
+  Datum  spheretrans_send(PG_FUNCTION_ARGS)
+  {
+    SEuler   * se  = ( SEuler * ) PG_GETARG_POINTER(0);
+    static const char axes[4] = { '\0', 'X', 'Y', 'Z' };
+    StringInfoData buf;
+
+    pq_begintypsend ( &buf );
+    pq_sendfloat8 ( &buf, se->phi );
+    pq_sendfloat8 ( &buf, se->theta );
+    pq_sendfloat8 ( &buf, se->psi );
+    pq_sendbyte ( &buf, axes[se->phi_a] );
+    pq_sendbyte ( &buf, axes[se->theta_a] );
+    pq_sendbyte ( &buf, axes[se->psi_a] );
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
+
+
   Datum  spheretrans_from_float8 (PG_FUNCTION_ARGS)
   {
     SEuler  * se  = ( SEuler * ) MALLOC ( sizeof ( SEuler ) ) ;
@@ -132,6 +173,7 @@
     PG_RETURN_POINTER ( se );
 
   }
+#endif
 
   void seuler_set_zxz ( SEuler * se )
   {
@@ -143,7 +185,7 @@
 
   bool strans_eq ( const SEuler * e1, const SEuler * e2 )
   {
-    static SPoint in[2], p[4] ;
+    SPoint in[2], p[4] ;
 
     in[0].lng  = 0.0;
     in[0].lat  = 0.0;
@@ -159,6 +201,7 @@
   }
 
 
+#ifndef PGS_CORE
   Datum  spheretrans_equal(PG_FUNCTION_ARGS)
   {
     SEuler  * e1 =  ( SEuler * )  PG_GETARG_POINTER ( 0 ) ;
@@ -227,6 +270,7 @@
     PG_RETURN_BPCHAR_P(result);
 
   }
+#endif
 
   SEuler * spheretrans_inv ( SEuler * se )
   {
@@ -261,7 +305,7 @@
     ){
       memcpy( (void*) ret, (void*) se, sizeof( SEuler ) );
     } else {
-      static SEuler tmp;
+      SEuler tmp;
       tmp.psi   = 0.0;
       tmp.theta = 0.0;
       tmp.phi   = 0.0;
@@ -272,6 +316,7 @@
   }
 
 
+#ifndef PGS_CORE
   Datum  spheretrans_zxz(PG_FUNCTION_ARGS)
   {
     SEuler  * si  =  ( SEuler * )  PG_GETARG_POINTER ( 0 ) ;
@@ -295,11 +340,12 @@
     spheretrans_inverse ( ret , se );
     PG_RETURN_POINTER ( ret );
   }
+#endif
 
 
   SEuler * seuler_trans_zxz ( SEuler * out , const SEuler * in , const SEuler * se )
   {
-    static SPoint sp[4] ;
+    SPoint sp[4] ;
     sp[0].lng = 0.0;
     sp[0].lat = 0.0;
     sp[1].lng = PIH;
@@ -313,6 +359,7 @@
   }
 
 
+#ifndef PGS_CORE
   Datum  spheretrans_trans(PG_FUNCTION_ARGS)
   {
     SEuler  * se1  =  ( SEuler  * ) PG_GETARG_POINTER ( 0 ) ;
@@ -333,6 +380,7 @@
     seuler_trans_zxz  ( out , se1, &tmp );
     PG_RETURN_POINTER ( spheretrans_check(out) );
   }
+#endif
 
 
   SPoint  * euler_spoint_trans ( SPoint * out , const SPoint  * in , const SEuler * se )
@@ -344,6 +392,7 @@
     return out;
   }
 
+#ifndef PGS_CORE
   Datum  spheretrans_point(PG_FUNCTION_ARGS)
   {
     SPoint *  sp =  ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
@@ -367,6 +416,7 @@
                        sp, PointerGetDatum(&tmp) );
    PG_RETURN_DATUM( ret );
   }
+#endif
 
   /*!
     \brief transforms a spherical vector to a inverse Euler transformation
@@ -385,9 +435,9 @@
 
     } else {
 
-      static Vector3D vbeg,vend,vtmp;
-      static SPoint spt[2];
-      static SEuler set;
+      Vector3D vbeg,vend,vtmp;
+      SPoint spt[2];
+      SEuler set;
 
       spoint_vector3d ( &vbeg  , spb );
       spoint_vector3d ( &vend  , spe );
@@ -408,7 +458,7 @@
 
   bool spherevector_to_euler ( SEuler * se, const SPoint * spb , const SPoint * spe )
   {
-    static bool ret;
+    bool ret;
     ret = spherevector_to_euler_inv ( se, spb , spe );
     if( ret ){
     	spheretrans_inv ( se );
@@ -418,15 +468,126 @@
 
 
 
+  SEulerMatrix * seuler_matrix ( SEulerMatrix * m , const SEuler * se )
+  {
+    int            i ;
+    unsigned char  t = 0 ;
+    float8         a = 0.0 , sa , ca ;
+    SEulerMatrix   r , tmp ;
+
+    memset ( ( void * ) m, 0, sizeof ( SEulerMatrix ) );
+    for ( i=0; i<3; i++ ){
+      m->m[i][i] = 1.0 ;
+    }
+
+    for ( i=0; i<3; i++ )
+    {
+
+      switch ( i )
+      {
+        case 0 : a = se->phi   ; t = se->phi_a   ; break;
+        case 1 : a = se->theta ; t = se->theta_a ; break;
+        case 2 : a = se->psi   ; t = se->psi_a   ; break;
+      }
+
+      if ( FPzero( a ) )
+      {
+        continue ;
+      }
+
+      sa = sin(a);
+      ca = cos(a);
+
+      memset ( ( void * ) &r, 0, sizeof ( SEulerMatrix ) );
+      switch ( t )
+      {
+
+        case EULER_AXIS_X :
+              r.m[0][0] =  1.0 ;
+              r.m[1][1] =  ca  ; r.m[1][2] = -sa ;
+              r.m[2][1] =  sa  ; r.m[2][2] =  ca ;
+              break;
+        case EULER_AXIS_Y :
+              r.m[0][0] =  ca  ; r.m[0][2] =  sa ;
+              r.m[1][1] =  1.0 ;
+              r.m[2][0] = -sa  ; r.m[2][2] =  ca ;
+              break;
+        case EULER_AXIS_Z :
+              r.m[0][0] =  ca  ; r.m[0][1] = -sa ;
+              r.m[1][0] =  sa  ; r.m[1][1] =  ca ;
+              r.m[2][2] =  1.0 ;
+              break;
+
+      }
+      seuler_matrix_mult ( &tmp, &r, m );
+      memcpy ( ( void * ) m, ( void * ) &tmp, sizeof ( SEulerMatrix ) );
+
+    }
+    return m;
+  }
+
+
+  SEulerMatrix * seuler_matrix_inv ( SEulerMatrix * m , const SEuler * se )
+  {
+    SEulerMatrix   tmp ;
+    int            i , j ;
+
+    // inverse of rotation matrix is its transpose
+    seuler_matrix ( &tmp, se );
+    for ( i=0; i<3; i++ ){
+      for ( j=0; j<3; j++ ){
+        m->m[i][j] = tmp.m[j][i] ;
+      }
+    }
+    return m;
+  }
+
+
+  SEulerMatrix * seuler_matrix_mult ( SEulerMatrix * out , const SEulerMatrix * a , const SEulerMatrix * b )
+  {
+    int   i , j ;
+
+    for ( i=0; i<3; i++ ){
+      for ( j=0; j<3; j++ ){
+        out->m[i][j] = a->m[i][0] * b->m[0][j] +
+                       a->m[i][1] * b->m[1][j] +
+                       a->m[i][2] * b->m[2][j] ;
+      }
+    }
+    return out;
+  }
+
+
+  Vector3D * euler_matrix_vector_trans ( Vector3D * out , const Vector3D * in , const SEulerMatrix * m )
+  {
+    float8  x = in->x , y = in->y , z = in->z ;
+
+    out->x = m->m[0][0] * x + m->m[0][1] * y + m->m[0][2] * z ;
+    out->y = m->m[1][0] * x + m->m[1][1] * y + m->m[1][2] * z ;
+    out->z = m->m[2][0] * x + m->m[2][1] * y + m->m[2][2] * z ;
+    return out;
+  }
+
+
+  SPoint * euler_matrix_spoint_trans ( SPoint * out , const SPoint * in , const SEulerMatrix * m )
+  {
+    Vector3D v,o ;
+    spoint_vector3d ( &v , in );
+    euler_matrix_vector_trans ( &o , &v , m );
+    vector3d_spoint ( out , &o );
+    return out;
+  }
+
+
   Vector3D  * euler_vector_trans ( Vector3D  * out , const Vector3D  * in , const SEuler * se )
   {
-    static int     i ;
-    static unsigned char  t ;
-    static const double * a ;
-    static double  u[3], vr[3], sa , ca ;
+    int            i ;
+    unsigned char  t = 0 ;
+    float8         a = 0.0 , sa , ca ;
+    float8         u[3], vr[3] ;
 
-    t    = 0;
-    a    = NULL ;
+    // a single vector is rotated directly, that is cheaper than
+    // building the matrix
     u[0] = in->x;
     u[1] = in->y;
     u[2] = in->z;
@@ -436,18 +597,18 @@
 
       switch ( i )
       {
-        case 0 : a = &se->phi   ; t = se->phi_a   ; break;
-        case 1 : a = &se->theta ; t = se->theta_a ; break;
-        case 2 : a = &se->psi   ; t = se->psi_a   ; break;
+        case 0 : a = se->phi   ; t = se->phi_a   ; break;
+        case 1 : a = se->theta ; t = se->theta_a ; break;
+        case 2 : a = se->psi   ; t = se->psi_a   ; break;
       }
 
-      if ( FPzero( *a ) )
+      if ( FPzero( a ) )
       {
         continue ;
       }
 
-      sa = sin(*a);
-      ca = cos(*a);
+      sa = sin(a);
+      ca = cos(a);
 
       switch ( t )
       {
@@ -20,6 +20,16 @@
                         psi ; //!< third rotation angle
   } SEuler;
 
+  /*!
+    The rotation matrix of an Euler transformation. Use it if
+    many vectors have to be transformed by the same transformation,
+    the sine and cosine of the angles are calculated only once.
+    \brief Rotation matrix of an Euler transformation
+  */
+  typedef struct {
+    float8   m[3][3] ; //!< rotation matrix, a vector v is transformed to m*v
+  } SEulerMatrix;
+
 
   /*!
     \brief  transforms a spherical point
@@ -41,6 +51,14 @@
   */
   bool   spherevector_to_euler     ( SEuler * se, const SPoint * spb , const SPoint * spe );
 
+  /*!
+    Moves the rotation angles into the range [0,2pi)
+    \brief Checks and modifies the Euler transformation
+    \param e Euler transformation
+    \return Euler transformation
+  */
+  SEuler    * spheretrans_check         ( SEuler * e );
+
   /*!
     \brief sets the axes of transformation to ZXZ
     \param se pointer to Euler transformation
@@ -64,6 +82,50 @@
   */
   Vector3D  * euler_vector_trans ( Vector3D * out , const Vector3D  * in , const SEuler * se );
 
+  /*!
+    \brief Creates the rotation matrix of an Euler transformation
+    \param m  pointer to result matrix
+    \param se pointer to Euler transformation
+    \return pointer to result matrix
+  */
+  SEulerMatrix * seuler_matrix          ( SEulerMatrix * m , const SEuler * se );
+
+  /*!
+    \brief Creates the rotation matrix of an inverse Euler transformation
+    \param m  pointer to result matrix
+    \param se pointer to Euler transformation
+    \return pointer to result matrix
+  */
+  SEulerMatrix * seuler_matrix_inv      ( SEulerMatrix * m , const SEuler * se );
+
+  /*!
+    The result matrix transforms a vector first with b, then with a.
+    \brief Composes two rotation matrices
+    \param out pointer to result matrix
+    \param a   pointer to second transformation
+    \param b   pointer to first transformation
+    \return pointer to result matrix
+  */
+  SEulerMatrix * seuler_matrix_mult     ( SEulerMatrix * out , const SEulerMatrix * a , const SEulerMatrix * b );
+
+  /*!
+    \brief Transforms a vector using a rotation matrix
+    \param out pointer to result vector
+    \param in  pointer to input vector
+    \param m   pointer to rotation matrix
+    \return pointer to result vector
+  */
+  Vector3D     * euler_matrix_vector_trans ( Vector3D * out , const Vector3D * in , const SEulerMatrix * m );
+
+  /*!
+    \brief Transforms a spherical point using a rotation matrix
+    \param out pointer to transformed spherical point
+    \param in  pointer to spherical input point
+    \param m   pointer to rotation matrix
+    \return pointer to transformed spherical point
+  */
+  SPoint       * euler_matrix_spoint_trans ( SPoint * out , const SPoint * in , const SEulerMatrix * m );
+
   /*!
     \brief inverts an Euler transformation
     \param se_in pointer to input transformation
@@ -110,6 +172,20 @@
   */
   Datum  spheretrans_in               (PG_FUNCTION_ARGS);
 
+  /*!
+    \brief binary input function of Euler transformation
+    \return Euler transformation datum
+    \note PostgreSQL function
+  */
+  Datum  spheretrans_recv             (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief binary output function of Euler transformation
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  spheretrans_send             (PG_FUNCTION_ARGS);
+
   /*!
     Input of a Euler transformation with axis Z,X,Z from three angles
     (phi, theta, psi) in radians
@@ -0,0 +1,81 @@
+#!/usr/bin/perl
+
+#
+# gen_dtoa_table.pl: writes dtoa_table.h
+#
+# usage:
+#	gen_dtoa_table.pl > dtoa_table.h
+#
+# The tables hold the 125 most significant bits of 5^i and of 1/5^q
+# as used by the shortest double to text conversion in dtoa.c. The
+# inverse values are rounded up, the powers are rounded down.
+#
+
+use Math::BigInt;
+
+my $bits = 125;
+my $inv_size = 292;
+my $pow_size = 326;
+my $mask = Math::BigInt->new(1)->blsft(64)->bsub(1);
+
+sub split64 {
+	my $v = shift;
+	my $lo = $v->copy()->band($mask);
+	my $hi = $v->copy()->brsft(64);
+	return sprintf("{ UINT64CONST(%s), UINT64CONST(%s) }", $lo->bstr(), $hi->bstr());
+}
+
+print <<END ;
+#ifndef __PGS_DTOA_TABLE_H__
+#define __PGS_DTOA_TABLE_H__
+
+/*!
+  \\file
+  \\brief Power of five tables of shortest double output
+  \\note generated by gen_dtoa_table.pl, do not edit
+*/
+
+#define DTOA_POW5_INV_BITCOUNT $bits  //!< bits of the inverse powers of five
+#define DTOA_POW5_BITCOUNT     $bits  //!< bits of the powers of five
+#define DTOA_POW5_INV_SIZE     $inv_size  //!< entries of dtoa_pow5_inv_split
+#define DTOA_POW5_SIZE         $pow_size  //!< entries of dtoa_pow5_split
+
+/*!
+  \\brief 2^(bitlength(5^q)-1+DTOA_POW5_INV_BITCOUNT)/5^q + 1, low word first
+*/
+static const uint64 dtoa_pow5_inv_split[DTOA_POW5_INV_SIZE][2] = {
+END
+
+for (my $q = 0; $q < $inv_size; $q++) {
+	my $p = Math::BigInt->new(5)->bpow($q);
+	my $j = length($p->as_bin()) - 2 - 1 + $bits;
+	my $v = Math::BigInt->new(1)->blsft($j)->bdiv($p)->badd(1);
+	printf("  %s%s\n", split64($v), ($q < $inv_size - 1) ? "," : "");
+}
+
+print <<END ;
+};
+
+/*!
+  \\brief 5^i reduced or extended to DTOA_POW5_BITCOUNT bits, low word first
+*/
+static const uint64 dtoa_pow5_split[DTOA_POW5_SIZE][2] = {
+END
+
+for (my $i = 0; $i < $pow_size; $i++) {
+	my $p = Math::BigInt->new(5)->bpow($i);
+	my $len = length($p->as_bin()) - 2;
+	my $v;
+	if ($len >= $bits) {
+		$v = $p->copy()->brsft($len - $bits);
+	} else {
+		$v = $p->copy()->blsft($bits - $len);
+	}
+	printf("  %s%s\n", split64($v), ($i < $pow_size - 1) ? "," : "");
+}
+
+print <<END ;
+};
+
+#endif
+END
@@ -1,4 +1,19 @@
 #include "gist.h"
+#include "dtoa.h"
+#include "stats.h"
+#include "access/genam.h"
+#include "access/gist_private.h"
+#include "catalog/namespace.h"
+#include "catalog/pg_am.h"
+#include "catalog/pg_authid.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "storage/bufmgr.h"
+#include "utils/acl.h"
+#include "utils/lsyscache.h"
+#include "utils/rel.h"
+#include "utils/syscache.h"
+#include "utils/tuplestore.h"
 
 /*!
   \file
@@ -24,6 +39,8 @@
   PG_FUNCTION_INFO_V1(g_spherekey_decompress);
   PG_FUNCTION_INFO_V1(g_scircle_compress);
   PG_FUNCTION_INFO_V1(g_spoint_compress);
+  PG_FUNCTION_INFO_V1(g_spoint4_compress);
+  PG_FUNCTION_INFO_V1(g_spoint3_compress);
   PG_FUNCTION_INFO_V1(g_sline_compress);
   PG_FUNCTION_INFO_V1(g_spath_compress);
   PG_FUNCTION_INFO_V1(g_spoly_compress);
@@ -32,6 +49,8 @@
   PG_FUNCTION_INFO_V1(g_spherekey_union );
   PG_FUNCTION_INFO_V1(g_spherekey_same);
   PG_FUNCTION_INFO_V1(g_spoint_consistent);
+  PG_FUNCTION_INFO_V1(g_spoint4_consistent);
+  PG_FUNCTION_INFO_V1(g_spoint3_consistent);
   PG_FUNCTION_INFO_V1(g_scircle_consistent);
   PG_FUNCTION_INFO_V1(g_sline_consistent);
   PG_FUNCTION_INFO_V1(g_spath_consistent);
@@ -40,6 +59,9 @@
   PG_FUNCTION_INFO_V1(g_sbox_consistent);
   PG_FUNCTION_INFO_V1(g_spherekey_penalty);
   PG_FUNCTION_INFO_V1(g_spherekey_picksplit);
+#if PG_VERSION_NUM >= 100000
+  PG_FUNCTION_INFO_V1(g_spherekey_inspect);
+#endif
 
 #endif
 
@@ -53,7 +75,7 @@
   static uchar  spherekey_interleave ( const int32 * k1 ,  const int32 * k2 )
   {
     uchar          i ;
-    static char    tb;
+    char    tb;
 
     // i represents x,y,z
 
@@ -85,21 +107,6 @@
     return SCKEY_OVERLAP;
   }
 
-  /* gives the cube size of spherekey */
-  /*!
-    \brief Returns the Volume of a key ( cube )
-    \param v pointer to key
-    \return Volume
-  */
-  static double spherekey_size ( const int32 * v )
-  {
-    static const int32  ks =  MAXCVALUE ;
-    double d = ( ( double ) ( v[3] - v[0] ) )/ks 
-             * ( ( double ) ( v[4] - v[1] ) )/ks
-             * ( ( double ) ( v[5] - v[2] ) )/ks;
-    return d;
-  }
-
   Datum  spherekey_in(PG_FUNCTION_ARGS)
   {
     elog ( ERROR , "Not implemented!" );
@@ -111,18 +118,24 @@
 
     static const float8  ks =  (float8) MAXCVALUE ;
     int32 * k     =  ( int32 * ) PG_GETARG_POINTER ( 0 ) ;
-    char * buffer =  ( char  * ) MALLOC ( 1024 ) ;
-
-    sprintf( 
-      buffer,
-      "(%.9f,%.9f,%.9f),(%.9f,%.9f,%.9f)",
-      k[0]/ks,
-      k[1]/ks,
-      k[2]/ks,
-      k[3]/ks,
-      k[4]/ks,
-      k[5]/ks
-    );
+    /* |k/ks| < 2, so a value needs at most 12 characters */
+    char * buffer =  ( char  * ) MALLOC ( 6 * 12 + 10 ) ;
+    char   tmp[DTOA_BUFLEN];
+    char * p      =  buffer;
+    int    i, n;
+
+    for ( i = 0; i < 6; i++ ){
+      if ( i == 3 ){
+        *p++ = ')';
+        *p++ = ',';
+      }
+      *p++ = ( i % 3 == 0 ) ? '(' : ',';
+      n = pgs_dtoa_f ( k[i]/ks, 0, 9, false, tmp );
+      memcpy ( p, tmp, n );
+      p += n;
+    }
+    *p++ = ')';
+    *p   = '\0';
 
     PG_RETURN_CSTRING ( buffer ) ;
 
@@ -209,6 +222,16 @@
     PGS_COMPRESS( SPoint , spherepoint_gen_key, 0 )
   }
 
+  Datum g_spoint4_compress(PG_FUNCTION_ARGS)
+  {
+    PGS_COMPRESS( SPoint4 , spherepoint4_gen_key, 0 )
+  }
+
+  Datum g_spoint3_compress(PG_FUNCTION_ARGS)
+  {
+    PGS_COMPRESS( Vector3D , spherepoint3_gen_key, 0 )
+  }
+
   Datum g_sline_compress(PG_FUNCTION_ARGS)
   {
     PGS_COMPRESS( SLine , sphereline_gen_key, 0 )
@@ -270,7 +293,7 @@
     int32          *c1 = ( int32 * ) PG_GETARG_POINTER(0);
     int32          *c2 = ( int32 * ) PG_GETARG_POINTER(1);
     bool       *result = ( bool  * ) PG_GETARG_POINTER(2);
-    static int       i ;
+    int       i ;
  
     *result            = TRUE;
 
@@ -297,7 +320,10 @@
 */
 #define SCK_INTERLEAVE( type , genkey , dir ) do { \
   int32 * q = NULL ; \
-  if ( ! gq_cache_get_value ( PGS_TYPE_##type , query, &q ) ){ \
+  if ( gq_cache_get_value ( PGS_TYPE_##type , query, &q ) ){ \
+    PGS_STAT_INC ( PGS_STAT_GQ_CACHE_HIT ); \
+  } else { \
+    PGS_STAT_INC ( PGS_STAT_GQ_CACHE_MISS ); \
     q = ( int32 *) malloc ( KEYSIZE ); \
     genkey ( q, ( type * ) query ); \
     gq_cache_set_value ( PGS_TYPE_##type , query, q ) ; \
@@ -356,6 +382,7 @@
 
       }
 
+      PGS_STAT_GIST ( SPoint , strategy , GIST_LEAF ( entry ) , result );
       PG_RETURN_BOOL( result );
 
     }
@@ -363,6 +390,45 @@
   }
   
 
+  Datum g_spoint4_consistent(PG_FUNCTION_ARGS)
+  {
+    Datum   query = PG_GETARG_DATUM(1);
+    SPoint  sp;
+
+    /* only the equality has a compact point as query */
+    if ( PG_GETARG_UINT16(2) == 1 && DatumGetPointer(query) ){
+      spoint4_to_spoint ( &sp, ( SPoint4 * ) DatumGetPointer(query) );
+      query = PointerGetDatum ( &sp );
+    }
+#if PG_VERSION_NUM >= 80400
+    PG_RETURN_DATUM( DirectFunctionCall5 ( g_spoint_consistent, PG_GETARG_DATUM(0), query,
+                       PG_GETARG_DATUM(2), PG_GETARG_DATUM(3), PG_GETARG_DATUM(4) ) );
+#else
+    PG_RETURN_DATUM( DirectFunctionCall3 ( g_spoint_consistent, PG_GETARG_DATUM(0), query,
+                       PG_GETARG_DATUM(2) ) );
+#endif
+  }
+
+  Datum g_spoint3_consistent(PG_FUNCTION_ARGS)
+  {
+    Datum   query = PG_GETARG_DATUM(1);
+    SPoint  sp;
+
+    /* only the equality has a vector point as query */
+    if ( PG_GETARG_UINT16(2) == 1 && DatumGetPointer(query) ){
+      vector3d_spoint ( &sp, ( Vector3D * ) DatumGetPointer(query) );
+      query = PointerGetDatum ( &sp );
+    }
+#if PG_VERSION_NUM >= 80400
+    PG_RETURN_DATUM( DirectFunctionCall5 ( g_spoint_consistent, PG_GETARG_DATUM(0), query,
+                       PG_GETARG_DATUM(2), PG_GETARG_DATUM(3), PG_GETARG_DATUM(4) ) );
+#else
+    PG_RETURN_DATUM( DirectFunctionCall3 ( g_spoint_consistent, PG_GETARG_DATUM(0), query,
+                       PG_GETARG_DATUM(2) ) );
+#endif
+  }
+
+
   Datum g_scircle_consistent(PG_FUNCTION_ARGS)
   { 
     GISTENTRY          *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
@@ -416,6 +482,7 @@
           default : if ( i >  SCKEY_DISJ     )  result = TRUE; break;
         }
       }
+      PGS_STAT_GIST ( SCIRCLE , strategy , GIST_LEAF ( entry ) , result );
       PG_RETURN_BOOL( result );
     }
     PG_RETURN_BOOL(FALSE);
@@ -471,6 +538,7 @@
           default : if ( i >  SCKEY_DISJ     )  result = TRUE; break;
         }
       }
+      PGS_STAT_GIST ( SLine , strategy , GIST_LEAF ( entry ) , result );
       PG_RETURN_BOOL( result );
     }
     PG_RETURN_BOOL(FALSE);
@@ -525,6 +593,7 @@
           default : if ( i >  SCKEY_DISJ     )  result = TRUE; break;
         }
       }
+      PGS_STAT_GIST ( SPATH , strategy , GIST_LEAF ( entry ) , result );
       PG_RETURN_BOOL( result );
     }
     PG_RETURN_BOOL(FALSE);
@@ -583,6 +652,7 @@
           default : if ( i >  SCKEY_DISJ     )  result = TRUE; break;
         }
       }
+      PGS_STAT_GIST ( SPOLY , strategy , GIST_LEAF ( entry ) , result );
       PG_RETURN_BOOL( result );
     }
     PG_RETURN_BOOL(FALSE);
@@ -641,6 +711,7 @@
           default : if ( i >  SCKEY_DISJ     )  result = TRUE; break;
         }
       }
+      PGS_STAT_GIST ( SELLIPSE , strategy , GIST_LEAF ( entry ) , result );
       PG_RETURN_BOOL( result );
     }
     PG_RETURN_BOOL(FALSE);
@@ -699,6 +770,7 @@
           default : if ( i >  SCKEY_DISJ     )  result = TRUE; break;
         }
       }
+      PGS_STAT_GIST ( SBOX , strategy , GIST_LEAF ( entry ) , result );
       PG_RETURN_BOOL( result );
     }
     PG_RETURN_BOOL(FALSE);
@@ -714,7 +786,7 @@
     GISTENTRY  *newentry  = (GISTENTRY *) PG_GETARG_POINTER(1);
     float      *result    = (float *) PG_GETARG_POINTER(2);
     int32      *o         = (int32 *) DatumGetPointer( origentry->key );
-    static int32 n[6]     ;
+    int32 n[6]     ;
 
     if ( newentry == NULL ){
       PG_RETURN_POINTER( NULL );
@@ -738,23 +810,6 @@
   }
 
 
-#define WISH_F(a,b,c) (double)( -(double)(((a)-(b))*((a)-(b))*((a)-(b)))*(c) )
-
-  typedef struct
-  {
-        double      cost;
-        OffsetNumber pos;
-  } SPLITCOST;
-
-  static int
-  comparecost(const void *a, const void *b)
-  {
-    if (((SPLITCOST *) a)->cost == ((SPLITCOST *) b)->cost)
-         return 0;
-     else
-         return (((SPLITCOST *) a)->cost > ((SPLITCOST *) b)->cost) ? 1 : -1;
-  }
-
   Datum g_spherekey_picksplit(PG_FUNCTION_ARGS)
   {
     #ifdef GEVHDRSZ
@@ -763,140 +818,318 @@
       bytea              *entryvec = (bytea *) PG_GETARG_POINTER(0);
     #endif
     GIST_SPLITVEC  *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
-    OffsetNumber  i,j;
-    int32	*datum_alpha, *datum_beta;
-    int32	datum_l[6], datum_r[6];
-    int32	union_dl[6],union_dr[6];
-    int32	union_d[6], inter_d[6];
-    double	size_alpha, size_beta;
-    double	size_waste, waste=-1.0;
-    double      size_l, size_r;
-    int                     nbytes;
-    OffsetNumber	seed_1 = 0, seed_2 = 0;
-    OffsetNumber *left, *right;
-    OffsetNumber maxoff;
-    SPLITCOST  *costvector;
+    OffsetNumber    i, maxoff;
+    int32        ** keys;
+    int32         * left, * right;
+    int32         * datum_l, * datum_r;
+    int32           nleft, nright;
 
     #ifdef GEVHDRSZ
      maxoff  = entryvec->n - 1;
     #else
       maxoff = ((VARSIZE(entryvec) - VARHDRSZ) / sizeof(GISTENTRY)) - 1;
     #endif
-    nbytes = (maxoff + 2) * sizeof(OffsetNumber);
-    v->spl_left  = (OffsetNumber *) MALLOC(nbytes);
-    v->spl_right = (OffsetNumber *) MALLOC(nbytes);
-
-    for (i = FirstOffsetNumber; i < maxoff; i = OffsetNumberNext(i)) {
-	#ifdef GEVHDRSZ
-	 	datum_alpha = (int32 *) DatumGetPointer(entryvec->vector[i].key);
-	#else
-	 	datum_alpha = (int32 *) DatumGetPointer(((GISTENTRY *) VARDATA(entryvec))[i].key);
-	#endif
-	for (j = OffsetNumberNext(i); j <= maxoff; j = OffsetNumberNext(j)) {
-		#ifdef GEVHDRSZ
-		 	datum_beta = (int32 *) DatumGetPointer(entryvec->vector[j].key);
-		#else
-	 		datum_beta = (int32 *) DatumGetPointer(((GISTENTRY *) VARDATA(entryvec))[j].key);
-		#endif
-		memcpy( (void*)union_d, (void*)datum_alpha, KEYSIZE );
-		memcpy( (void*)inter_d, (void*)datum_alpha, KEYSIZE );
-		size_waste = spherekey_size( spherekey_union_two(union_d, datum_beta) ) - 
-			( (spherekey_inter_two( inter_d, datum_beta )) ? spherekey_size(inter_d) : 0 );
-		if (size_waste > waste) {
-			waste = size_waste;
-			seed_1 = i;
-			seed_2 = j;
-		}
-	}
-   }
-		 
-   left = v->spl_left;
-   v->spl_nleft = 0;
-   right = v->spl_right;
-   v->spl_nright = 0;
-   if (seed_1 == 0 || seed_2 == 0) {
-	seed_1 = 1;
-	seed_2 = 2;
-   }
-
-   #ifdef GEVHDRSZ
-     memcpy( (void*)datum_l, (void *) DatumGetPointer(entryvec->vector[seed_1].key), KEYSIZE );
-     memcpy( (void*)datum_r, (void *) DatumGetPointer(entryvec->vector[seed_2].key), KEYSIZE );
-   #else
-     memcpy( (void*)datum_l, (void *) DatumGetPointer(((GISTENTRY *) VARDATA(entryvec))[seed_1].key), KEYSIZE );
-     memcpy( (void*)datum_r, (void *) DatumGetPointer(((GISTENTRY *) VARDATA(entryvec))[seed_2].key), KEYSIZE );
-   #endif
-   size_l = spherekey_size(datum_l);
-   size_r = spherekey_size(datum_r);
-
-   costvector = (SPLITCOST *) MALLOC(sizeof(SPLITCOST) * maxoff);
-   for (i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i)) {
-	costvector[i - 1].pos = i;
-	#ifdef GEVHDRSZ
-	 	datum_alpha = (int32 *) DatumGetPointer(entryvec->vector[i].key);
-	#else
-	 	datum_alpha = (int32 *) DatumGetPointer(((GISTENTRY *) VARDATA(entryvec))[i].key);
-	#endif
-	memcpy( (void*)union_dl, (void*)datum_l, KEYSIZE );
-	spherekey_union_two(union_dl, datum_alpha );
-	memcpy( (void*)union_dr, (void*)datum_r, KEYSIZE );
-	spherekey_union_two(union_dr, datum_alpha );
-	costvector[i - 1].cost = pgs_abs( (spherekey_size(union_dl) - size_l) - (spherekey_size(union_dr) - size_r) );
-   }
-   qsort((void *) costvector, maxoff, sizeof(SPLITCOST), comparecost);
-
-   for (j = 0; j < maxoff; j++) {
-	i = costvector[j].pos;
-
-	if (i == seed_1) {
-		*left++ = i;
-		v->spl_nleft++;
-		continue;
-	} else if (i == seed_2) {
-		*right++ = i;
-		v->spl_nright++;
-		continue;
-	}
-
-	#ifdef GEVHDRSZ
-	 	datum_alpha = (int32 *) DatumGetPointer(entryvec->vector[i].key);
-	#else
-	 	datum_alpha = (int32 *) DatumGetPointer(((GISTENTRY *) VARDATA(entryvec))[i].key);
-	#endif
-	memcpy( (void*)union_dl, (void*)datum_l, KEYSIZE );
-	memcpy( (void*)union_dr, (void*)datum_r, KEYSIZE );
-
-	spherekey_union_two(union_dl, datum_alpha );
-	spherekey_union_two(union_dr, datum_alpha );
-	
-	size_alpha = spherekey_size( union_dl );
-	size_beta  = spherekey_size( union_dr );
-
-	/* pick which page to add it to */
-	if (size_alpha - size_l < size_beta - size_r + WISH_F(v->spl_nleft, v->spl_nright, 1.0e-9) ) {
-		memcpy( (void*)datum_l, (void*)union_dl, KEYSIZE );
-		size_l = size_alpha;
-		*left++ = i;
-		v->spl_nleft++;
-	} else {
-		memcpy( (void*)datum_r, (void*)union_dr, KEYSIZE );
-		size_r = size_beta;
-		*right++ = i;
-		v->spl_nright++;
-	}
-   }
-   FREE(costvector);
-
-   *right = *left = FirstOffsetNumber;
-
-   datum_alpha = (int32*)MALLOC(KEYSIZE);
-   memcpy( (void*)datum_alpha, (void*)datum_l, KEYSIZE ); 
-   datum_beta  = (int32*)MALLOC(KEYSIZE); 
-   memcpy( (void*)datum_beta, (void*)datum_r, KEYSIZE );
-
-   v->spl_ldatum = PointerGetDatum(datum_alpha);
-   v->spl_rdatum = PointerGetDatum(datum_beta);
-
-   PG_RETURN_POINTER(v);
-}
 
+    keys = ( int32 ** ) MALLOC ( sizeof ( int32 * ) * maxoff );
+    for ( i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext ( i ) ){
+      #ifdef GEVHDRSZ
+        keys[i - 1] = ( int32 * ) DatumGetPointer ( entryvec->vector[i].key );
+      #else
+        keys[i - 1] = ( int32 * ) DatumGetPointer ( ( ( GISTENTRY * ) VARDATA ( entryvec ) )[i].key );
+      #endif
+    }
+    left    = ( int32 * ) MALLOC ( sizeof ( int32 ) * maxoff );
+    right   = ( int32 * ) MALLOC ( sizeof ( int32 ) * maxoff );
+    datum_l = ( int32 * ) MALLOC ( KEYSIZE );
+    datum_r = ( int32 * ) MALLOC ( KEYSIZE );
+
+    spherekey_picksplit ( keys, maxoff, left, &nleft, right, &nright, datum_l, datum_r );
+
+    v->spl_left   = ( OffsetNumber * ) MALLOC ( ( maxoff + 2 ) * sizeof ( OffsetNumber ) );
+    v->spl_right  = ( OffsetNumber * ) MALLOC ( ( maxoff + 2 ) * sizeof ( OffsetNumber ) );
+    v->spl_nleft  = nleft;
+    v->spl_nright = nright;
+    for ( i = 0; i < nleft; i++ ){
+      v->spl_left[i] = left[i] + 1;
+    }
+    for ( i = 0; i < nright; i++ ){
+      v->spl_right[i] = right[i] + 1;
+    }
+    v->spl_left[nleft] = v->spl_right[nright] = FirstOffsetNumber;
+    v->spl_ldatum = PointerGetDatum ( datum_l );
+    v->spl_rdatum = PointerGetDatum ( datum_r );
+
+    FREE ( keys );
+    FREE ( left );
+    FREE ( right );
+    PG_RETURN_POINTER ( v );
+  }
+
+
+
+#if PG_VERSION_NUM >= 100000
+
+/*!
+  \brief count of histogram bins of key edges
+*/
+#define GIST_INSPECT_NBIN ( 64 * 27 )
+
+#if PG_VERSION_NUM < 140000
+#define ROLE_PG_STAT_SCAN_TABLES DEFAULT_ROLE_STAT_SCAN_TABLES
+#endif
+
+  /*!
+    \brief statistics of one level of a GiST index
+  */
+  typedef struct {
+    int64     pages;    //!< count of pages
+    int64     tuples;   //!< count of keys
+    float8    fill;     //!< sum of used page fractions
+    float8    size;     //!< sum of key volumes
+    float8    overlap;  //!< sum of overlap volumes of keys on the same page
+    int64     emin;     //!< smallest largest edge of keys
+    int64     emax;     //!< largest largest edge of keys
+    int64     hist[GIST_INSPECT_NBIN]; //!< log histogram of largest key edges
+  } GistLevelStat;
+
+
+  /*!
+    The edges are integers up to 2^31. Edges below 64 get a bin of
+    their own, larger ones 64 bins per power of two, so a bin is
+    narrower than 1/64 of its value.
+    \brief returns the histogram bin of a key edge
+    \param k largest edge of key
+  */
+  static int32 gist_inspect_bin ( int64 k )
+  {
+    int32 e = 6;
+    if ( k < 64 ){
+      return ( int32 ) k;
+    }
+    while ( ( k >> ( e + 1 ) ) > 0 ){
+      e++;
+    }
+    return 64 * ( e - 5 ) + ( int32 ) ( ( k >> ( e - 6 ) ) & 63 );
+  }
+
+
+  /*!
+    \brief returns the middle of a histogram bin
+    \param b histogram bin
+  */
+  static float8 gist_inspect_bin_value ( int32 b )
+  {
+    int32 e;
+    if ( b < 64 ){
+      return ( float8 ) b;
+    }
+    e = b / 64 + 5;
+    return ldexp ( 64 + b % 64 + 0.5, e - 6 );
+  }
+
+
+  /*!
+    \brief returns a quantile of the largest key edges
+    \param st statistics of level
+    \param q  quantile between 0 and 1
+  */
+  static float8 gist_inspect_quantile ( const GistLevelStat * st, float8 q )
+  {
+    int64  r = ( int64 ) floor ( q * ( st->tuples - 1 ) + 0.5 );
+    int64  c = 0;
+    int32  b;
+    float8 v = ( float8 ) st->emax;
+    for ( b = 0; b < GIST_INSPECT_NBIN; b++ ){
+      c += st->hist[b];
+      if ( c > r ){
+        v = gist_inspect_bin_value ( b );
+        break;
+      }
+    }
+    return Min ( Max ( v, ( float8 ) st->emin ), ( float8 ) st->emax ) / MAXCVALUE ;
+  }
+
+
+  /*!
+    Adds the keys of a page to the level statistics. The keys of an
+    inner page are the bounding boxes of its children, so their
+    pairwise overlap is the volume searched twice by a query.
+    \brief inspects a page of a GiST index
+    \param st    statistics of level
+    \param rel   index relation
+    \param page  index page
+    \param next  pointer to array of child pages
+    \param nnext pointer to count of child pages
+    \param mnext pointer to allocated count of child pages
+  */
+  static void gist_inspect_page ( GistLevelStat * st, Relation rel, Page page,
+                                  BlockNumber ** next, int64 * nnext, int64 * mnext )
+  {
+    const float8         space = BLCKSZ - MAXALIGN ( SizeOfPageHeaderData ) - MAXALIGN ( sizeof ( GISTPageOpaqueData ) );
+    OffsetNumber         i, j, maxoff = PageGetMaxOffsetNumber ( page );
+    int32             ** keys;
+    int32                k[6];
+    int32                n = 0;
+    int64                e;
+    bool                 isnull;
+
+    keys = ( int32 ** ) MALLOC ( sizeof ( int32 * ) * ( maxoff + 1 ) );
+    for ( i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext ( i ) ){
+      IndexTuple  itup = ( IndexTuple ) PageGetItem ( page, PageGetItemId ( page, i ) );
+      Datum       d    = index_getattr ( itup, 1, RelationGetDescr ( rel ), &isnull );
+      int32     * v;
+
+      if ( ! GistPageIsLeaf ( page ) ){
+        if ( *nnext >= *mnext ){
+          *mnext *= 2;
+          *next   = ( BlockNumber * ) repalloc ( *next, sizeof ( BlockNumber ) * *mnext );
+        }
+        ( *next )[ ( *nnext )++ ] = ItemPointerGetBlockNumber ( &itup->t_tid );
+      }
+      if ( isnull ){
+        continue;
+      }
+      v = ( int32 * ) DatumGetPointer ( d );
+      keys[n++] = v;
+      st->size += spherekey_size ( v );
+      e = Max ( Max ( ( int64 ) v[3] - v[0], ( int64 ) v[4] - v[1] ), ( int64 ) v[5] - v[2] );
+      if ( st->tuples == 0 || e < st->emin ){
+        st->emin = e;
+      }
+      if ( st->tuples == 0 || e > st->emax ){
+        st->emax = e;
+      }
+      st->hist[gist_inspect_bin ( e )]++;
+      st->tuples++;
+    }
+
+    for ( i = 0; i < n; i++ ){
+      for ( j = i + 1; j < n; j++ ){
+        memcpy ( ( void * ) k, ( void * ) keys[i], KEYSIZE );
+        if ( spherekey_inter_two ( k, keys[j] ) ){
+          st->overlap += spherekey_size ( k );
+        }
+      }
+    }
+    FREE ( keys );
+
+    st->fill += 1.0 - PageGetExactFreeSpace ( page ) / space;
+    st->pages++;
+  }
+
+
+  Datum  g_spherekey_inspect(PG_FUNCTION_ARGS)
+  {
+    ReturnSetInfo    * rsinfo = ( ReturnSetInfo * ) fcinfo->resultinfo;
+    Oid                indexoid = PG_GETARG_OID ( 0 );
+    Oid                keytype;
+    MemoryContext      oldctx;
+    Tuplestorestate  * out;
+    TupleDesc          desc;
+    Relation           rel;
+    BlockNumber      * cur, * next;
+    int64              ncur, nnext, mcur, mnext, b;
+    int32              level = 0;
+
+    if ( rsinfo == NULL || ! IsA ( rsinfo, ReturnSetInfo ) ||
+         ( rsinfo->allowedModes & SFRM_Materialize ) == 0 ){
+      elog ( ERROR , "pg_sphere_index_stats: set-valued function called in context that cannot accept a set" );
+    }
+    if ( get_call_result_type ( fcinfo, NULL, &desc ) != TYPEFUNC_COMPOSITE ){
+      elog ( ERROR , "pg_sphere_index_stats: return type must be a row type" );
+    }
+
+    rel     = index_open ( indexoid, AccessShareLock );
+    keytype = GetSysCacheOid2 ( TYPENAMENSP,
+#if PG_VERSION_NUM >= 120000
+                                Anum_pg_type_oid,
+#endif
+                                CStringGetDatum ( "spherekey" ),
+                                ObjectIdGetDatum ( get_func_namespace ( fcinfo->flinfo->fn_oid ) ) );
+    if ( rel->rd_rel->relam != GIST_AM_OID || RelationGetDescr ( rel )->natts != 1 ||
+         TupleDescAttr ( RelationGetDescr ( rel ), 0 )->atttypid != keytype ){
+      elog ( ERROR , "pg_sphere_index_stats: \"%s\" is not a single column pg_sphere GiST index",
+             RelationGetRelationName ( rel ) );
+    }
+    // the keys show the extents of the indexed values
+    if ( ! has_privs_of_role ( GetUserId ( ), ROLE_PG_STAT_SCAN_TABLES ) &&
+         pg_class_aclcheck ( rel->rd_index->indrelid, GetUserId ( ), ACL_SELECT ) != ACLCHECK_OK ){
+      elog ( ERROR , "pg_sphere_index_stats: permission denied for index \"%s\"",
+             RelationGetRelationName ( rel ) );
+    }
+
+    oldctx = MemoryContextSwitchTo ( rsinfo->econtext->ecxt_per_query_memory );
+    desc   = CreateTupleDescCopy ( desc );
+    out    = tuplestore_begin_heap ( false, false, work_mem );
+    MemoryContextSwitchTo ( oldctx );
+
+    mcur   = mnext = 64;
+    cur    = ( BlockNumber * ) MALLOC ( sizeof ( BlockNumber ) * mcur );
+    next   = ( BlockNumber * ) MALLOC ( sizeof ( BlockNumber ) * mnext );
+    cur[0] = GIST_ROOT_BLKNO;
+    ncur   = 1;
+
+    // breadth first, one level after the other
+    while ( ncur > 0 ){
+      GistLevelStat  * st;
+      Datum          values[11];
+      bool           nulls[11];
+      BlockNumber  * tmp;
+      int            i;
+
+      st    = ( GistLevelStat * ) MALLOC ( sizeof ( GistLevelStat ) );
+      memset ( ( void * ) st, 0, sizeof ( GistLevelStat ) );
+      nnext = 0;
+
+      for ( b = 0; b < ncur; b++ ){
+        Buffer  buf;
+        Page    page;
+
+        CHECK_FOR_INTERRUPTS ( );
+        buf = ReadBufferExtended ( rel, MAIN_FORKNUM, cur[b], RBM_NORMAL, NULL );
+        LockBuffer ( buf, BUFFER_LOCK_SHARE );
+        page = BufferGetPage ( buf );
+        if ( ! GistPageIsDeleted ( page ) ){
+          gist_inspect_page ( st, rel, page, &next, &nnext, &mnext );
+        }
+        UnlockReleaseBuffer ( buf );
+      }
+
+      memset ( nulls, 0, sizeof ( nulls ) );
+      values[0] = Int32GetDatum ( level );
+      values[1] = Int64GetDatum ( st->pages );
+      values[2] = Int64GetDatum ( st->tuples );
+      values[3] = Float8GetDatum ( st->pages > 0 ? st->fill / st->pages : 0.0 );
+      values[4] = Float8GetDatum ( st->size );
+      values[5] = Float8GetDatum ( st->tuples > 0 ? st->size / st->tuples : 0.0 );
+      values[6] = Float8GetDatum ( st->overlap );
+      if ( st->tuples > 0 ){
+        values[7]  = Float8GetDatum ( ( float8 ) st->emin / MAXCVALUE );
+        values[8]  = Float8GetDatum ( gist_inspect_quantile ( st, 0.5 ) );
+        values[9]  = Float8GetDatum ( gist_inspect_quantile ( st, 0.9 ) );
+        values[10] = Float8GetDatum ( ( float8 ) st->emax / MAXCVALUE );
+      } else {
+        for ( i = 7; i < 11; i++ ){
+          nulls[i] = true;
+        }
+      }
+      tuplestore_putvalues ( out, desc, values, nulls );
+      FREE ( st );
+
+      tmp  = cur;  cur  = next;  next  = tmp;
+      b    = mcur; mcur = mnext; mnext = b;
+      ncur = nnext;
+      level++;
+    }
+    FREE ( cur );
+    FREE ( next );
+
+    index_close ( rel, AccessShareLock );
+
+    rsinfo->returnMode = SFRM_Materialize;
+    rsinfo->setResult  = out;
+    rsinfo->setDesc    = desc;
+    return ( Datum ) 0;
+  }
+
+#endif
@@ -70,6 +70,21 @@
   */
   Datum g_spoint_compress(PG_FUNCTION_ARGS);
 
+  /*!
+    Creates the key value from compact spherical point.
+    \brief GIST's compress method for compact point
+    \return GIST entry datum
+    \note PostgreSQL function
+  */
+  Datum g_spoint4_compress(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief GIST's compress method for vector point
+    \return GIST entry datum
+    \note PostgreSQL function
+  */
+  Datum g_spoint3_compress(PG_FUNCTION_ARGS);
+
   /*!
     Creates the key value from spherical line.
     \brief GIST's compress method for line
@@ -136,6 +151,24 @@
   */
   Datum g_spoint_consistent(PG_FUNCTION_ARGS);
 
+  /*!
+    Calls the method of spherical points, a compact point
+    as query is converted before.
+    \brief GIST's consistence method for compact point
+    \return bool datum, true if consistent
+    \note PostgreSQL function
+  */
+  Datum g_spoint4_consistent(PG_FUNCTION_ARGS);
+
+  /*!
+    Calls the method of spherical points, a vector point
+    as query is converted before.
+    \brief GIST's consistence method for vector point
+    \return bool datum, true if consistent
+    \note PostgreSQL function
+  */
+  Datum g_spoint3_consistent(PG_FUNCTION_ARGS);
+
   /*!
     \brief GIST's consistence method for circle
     \return bool datum, true if consistent
@@ -197,4 +230,20 @@
   Datum g_spherekey_picksplit(PG_FUNCTION_ARGS);
 
 
+#if PG_VERSION_NUM >= 100000
+
+  /*!
+    Walks a pg_sphere GiST index from the root to the leaves and
+    returns one row per level with the count of pages and keys, the
+    average fill of the pages, the total and average key volume, the
+    overlap volume of keys on the same page, and the minimum, median,
+    90 % quantile and maximum of the largest key edge.
+    \brief inspection of a GiST index
+    \return set of level statistics
+    \note PostgreSQL function
+  */
+  Datum g_spherekey_inspect(PG_FUNCTION_ARGS);
+
+#endif
+
 #endif
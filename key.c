@@ -14,7 +14,7 @@
   */
   static int32 * key_add_point ( int32 * key , const SPoint * p )
   {
-      static int32  k[3] ;
+      int32  k[6] ;
       spherepoint_gen_key ( &k[0], p ) ;
       spherekey_union_two ( key , &k[0] );
       return key;
@@ -44,6 +44,116 @@
       return kinter;
  }
 
+  double spherekey_size ( const int32 * v )
+  {
+    static const int32  ks =  MAXCVALUE ;
+    double d = ( ( double ) ( v[3] - v[0] ) )/ks 
+             * ( ( double ) ( v[4] - v[1] ) )/ks
+             * ( ( double ) ( v[5] - v[2] ) )/ks;
+    return d;
+  }
+
+
+#define WISH_F(a,b,c) (double)( -(double)(((a)-(b))*((a)-(b))*((a)-(b)))*(c) )
+
+  typedef struct
+  {
+    double   cost;
+    int32    pos;
+  } SPLITCOST;
+
+  static int comparecost ( const void *a, const void *b )
+  {
+    if ( ( ( SPLITCOST * ) a )->cost == ( ( SPLITCOST * ) b )->cost )
+      return 0;
+    else
+      return ( ( ( SPLITCOST * ) a )->cost > ( ( SPLITCOST * ) b )->cost ) ? 1 : -1;
+  }
+
+  void spherekey_picksplit ( int32 * const * keys, int32 n,
+                             int32 * left, int32 * nleft,
+                             int32 * right, int32 * nright,
+                             int32 * kl, int32 * kr )
+  {
+    int32       i, j;
+    int32       union_dl[6], union_dr[6];
+    int32       union_d[6], inter_d[6];
+    double      size_alpha, size_beta;
+    double      size_waste, waste = -1.0;
+    double      size_l, size_r;
+    int32       seed_1 = -1, seed_2 = -1;
+    SPLITCOST * costvector;
+
+    *nleft = *nright = 0;
+
+    for ( i = 0; i < n - 1; i++ ){
+      for ( j = i + 1; j < n; j++ ){
+        memcpy ( ( void * ) union_d, ( void * ) keys[i], KEYSIZE );
+        memcpy ( ( void * ) inter_d, ( void * ) keys[i], KEYSIZE );
+        size_waste = spherekey_size ( spherekey_union_two ( union_d, keys[j] ) ) -
+          ( ( spherekey_inter_two ( inter_d, keys[j] ) ) ? spherekey_size ( inter_d ) : 0 );
+        if ( size_waste > waste ){
+          waste  = size_waste;
+          seed_1 = i;
+          seed_2 = j;
+        }
+      }
+    }
+
+    if ( seed_1 < 0 || seed_2 < 0 ){
+      seed_1 = 0;
+      seed_2 = 1;
+    }
+
+    memcpy ( ( void * ) kl, ( void * ) keys[seed_1], KEYSIZE );
+    memcpy ( ( void * ) kr, ( void * ) keys[seed_2], KEYSIZE );
+    size_l = spherekey_size ( kl );
+    size_r = spherekey_size ( kr );
+
+    costvector = ( SPLITCOST * ) palloc ( sizeof ( SPLITCOST ) * n );
+    for ( i = 0; i < n; i++ ){
+      costvector[i].pos = i;
+      memcpy ( ( void * ) union_dl, ( void * ) kl, KEYSIZE );
+      spherekey_union_two ( union_dl, keys[i] );
+      memcpy ( ( void * ) union_dr, ( void * ) kr, KEYSIZE );
+      spherekey_union_two ( union_dr, keys[i] );
+      costvector[i].cost = pgs_abs ( ( spherekey_size ( union_dl ) - size_l ) - ( spherekey_size ( union_dr ) - size_r ) );
+    }
+    qsort ( ( void * ) costvector, n, sizeof ( SPLITCOST ), comparecost );
+
+    for ( j = 0; j < n; j++ ){
+      i = costvector[j].pos;
+
+      if ( i == seed_1 ){
+        left[( *nleft )++] = i;
+        continue;
+      } else if ( i == seed_2 ){
+        right[( *nright )++] = i;
+        continue;
+      }
+
+      memcpy ( ( void * ) union_dl, ( void * ) kl, KEYSIZE );
+      memcpy ( ( void * ) union_dr, ( void * ) kr, KEYSIZE );
+      spherekey_union_two ( union_dl, keys[i] );
+      spherekey_union_two ( union_dr, keys[i] );
+
+      size_alpha = spherekey_size ( union_dl );
+      size_beta  = spherekey_size ( union_dr );
+
+      /* pick which page to add it to */
+      if ( size_alpha - size_l < size_beta - size_r + WISH_F ( *nleft, *nright, 1.0e-9 ) ){
+        memcpy ( ( void * ) kl, ( void * ) union_dl, KEYSIZE );
+        size_l = size_alpha;
+        left[( *nleft )++] = i;
+      } else {
+        memcpy ( ( void * ) kr, ( void * ) union_dr, KEYSIZE );
+        size_r = size_beta;
+        right[( *nright )++] = i;
+      }
+    }
+    pfree ( costvector );
+  }
+
   int32 * spherepoint_gen_key (  int32 * k , const SPoint * sp )
   {
 
@@ -69,163 +179,111 @@
     return ( k );
   }
 
+  int32 * spherepoint4_gen_key ( int32 * k , const SPoint4 * p4 )
+  {
+    SPoint sp;
+    return spherepoint_gen_key ( k, spoint4_to_spoint ( &sp, p4 ) );
+  }
 
-  int32 * spherecircle_gen_key( int32 * k, const SCIRCLE * c )
+  int32 * spherepoint3_gen_key ( int32 * k , const Vector3D * v )
   {
+    SPoint sp;
+    return spherepoint_gen_key ( k, vector3d_spoint ( &sp, v ) );
+  }
 
-    static double      r,d ;
-    static const int32  ks = MAXCVALUE;
-    static int           i ;
-    static Vector3D   v[8] ;
-    static Vector3D     tv ;
-    static Vector3D  mm[2] ;
-    static SEuler       se ;
-    r = sin( c->radius ) ;
-    d = cos( c->radius ) ;
-
-    v[0].x = -r ; v[0].y = -r  ; v[0].z = d ;
-    v[1].x = -r ; v[1].y = +r  ; v[1].z = d ;
-    v[2].x = +r ; v[2].y = -r  ; v[2].z = d ;
-    v[3].x = +r ; v[3].y = +r  ; v[3].z = d ;
-    v[4].x = -r ; v[4].y = -r  ; v[4].z = 1.0 ;
-    v[5].x = -r ; v[5].y = +r  ; v[5].z = 1.0 ;
-    v[6].x = +r ; v[6].y = -r  ; v[6].z = 1.0 ;
-    v[7].x = +r ; v[7].y = +r  ; v[7].z = 1.0 ;
-
-    se.psi_a    = EULER_AXIS_X;
-    se.theta_a  = EULER_AXIS_Z;
-    se.phi_a    = EULER_AXIS_X;
-    se.phi      = PIH - c->center.lat ;
-    se.theta    = PIH + c->center.lng ;
-    se.psi      = 0.0;
-    // min
-    mm[0].x = mm[0].y =  mm[0].z =  1.0;
-    // max
-    mm[1].x = mm[1].y =  mm[1].z = -1.0;
-
-    for ( i=0; i<8; i++ ){
-      euler_vector_trans ( &tv , &v[i] , &se );
-      if ( tv.x >= -1.0 && tv.x <= 1.0 ){
-        mm[0].x = min ( mm[0].x , tv.x );
-        mm[1].x = max ( mm[1].x , tv.x );
-      } 
-      else if ( tv.x < -1.0 ) {
-        mm[0].x = -1.0;
-      }
-      else if ( tv.x > 1.0 ) {
-        mm[1].x = 1.0;
-      }
-      
-      if ( tv.y >= -1.0 && tv.y <= 1.0 ){
-        mm[0].y = min ( mm[0].y , tv.y );
-        mm[1].y = max ( mm[1].y , tv.y );
-      }
-      else if ( tv.y < -1.0 ) {
-        mm[0].y = -1.0;
-      }
-      else if ( tv.y > 1.0 ) {
-        mm[1].y = 1.0;
-      }
 
-      if ( tv.z >= -1.0 && tv.z <= 1.0 ){
-        mm[0].z = min ( mm[0].z , tv.z );
-        mm[1].z = max ( mm[1].z , tv.z );
-      }
-      else if ( tv.z < -1.0 ) {
-        mm[0].z = -1.0;
-      }
-      else if ( tv.z > 1.0 ) {
-        mm[1].z = 1.0;
-      }
-    }
+  /*!
+    The extent of a spherical circle along an axis follows from the
+    angle a between circle's center and the axis. The maximum is
+    cos(a-r), the minimum cos(a+r) with circle's radius r.
+    \brief Returns the extent of a spherical circle along an axis
+    \param lim pointer to result, minimum and maximum
+    \param c   coordinate of circle's center along the axis
+    \param cr  cosine of circle's radius
+    \param sr  sine of circle's radius
+    \return pointer to result
+  */
+  static float8 * spherecircle_axis_extent ( float8 * lim , float8 c , float8 cr , float8 sr )
+  {
+    float8 sa = 1.0 - c * c ;
 
-    k[0]  = mm[0].x * ks ;
-    k[1]  = mm[0].y * ks ;
-    k[2]  = mm[0].z * ks ;
-    k[3]  = mm[1].x * ks ;
-    k[4]  = mm[1].y * ks ;
-    k[5]  = mm[1].z * ks ;
+    sa     = ( sa > 0.0 ) ? sqrt( sa ) : 0.0 ;
+    lim[0] = ( c <= -cr ) ? -1.0 : ( c * cr - sa * sr );
+    lim[1] = ( c >=  cr ) ?  1.0 : ( c * cr + sa * sr );
+    return lim;
+  }
 
+  /*!
+    \brief Converts the extents along the axes to a key
+    \param k   pointer to key
+    \param lim extents, minimum and maximum for each axis
+    \return pointer to key
+  */
+  static int32 * spherekey_from_extent ( int32 * k , float8 lim[3][2] )
+  {
+    static const int32 ks = MAXCVALUE ;
+    int                i ;
+
+    for ( i=0; i<3; i++ ){
+      if ( lim[i][0] < -1.0 ) lim[i][0] = -1.0;
+      if ( lim[i][1] >  1.0 ) lim[i][1] =  1.0;
+      k[i]   = lim[i][0] * ks ;
+      k[i+3] = lim[i][1] * ks ;
+    }
     return ( k );
-   
+  }
+
+
+  int32 * spherecircle_gen_key( int32 * k, const SCIRCLE * c )
+  {
+    Vector3D   v ;
+    float8     lim[3][2] , cr , sr ;
+
+    // keep the tolerance of scircle_cont_point
+    cr = cos( c->radius + EPSILON ) ;
+    sr = sin( c->radius + EPSILON ) ;
+    spoint_vector3d ( &v, &c->center );
+    spherecircle_axis_extent ( lim[0], v.x, cr, sr );
+    spherecircle_axis_extent ( lim[1], v.y, cr, sr );
+    spherecircle_axis_extent ( lim[2], v.z, cr, sr );
+    return spherekey_from_extent ( k , lim );
   }
 
 
   int32 * sphereellipse_gen_key( int32 * k, const SELLIPSE * e )
   {
-    static double   r[2],d ;
-    static const int32  ks = MAXCVALUE;
-    static int           i ;
-    static Vector3D   v[8] ;
-    static Vector3D     tv ;
-    static Vector3D  mm[2] ;
-    static SEuler       se ;
-
-    r[0] = sin( e->rad[0] ) ;
-    r[1] = sin( e->rad[1] ) ;
-    d    = cos( e->rad[1] ) ;
-
-    v[0].x = d   ; v[0].y = -r[0]  ; v[0].z = -r[1] ;  
-    v[1].x = d   ; v[1].y = +r[0]  ; v[1].z = -r[1] ;  
-    v[2].x = d   ; v[2].y = -r[0]  ; v[2].z = +r[1] ;  
-    v[3].x = d   ; v[3].y = +r[0]  ; v[3].z = +r[1] ;  
-    v[4].x = 1.0 ; v[4].y = -r[0]  ; v[4].z = -r[1] ;  
-    v[5].x = 1.0 ; v[5].y = +r[0]  ; v[5].z = -r[1] ;  
-    v[6].x = 1.0 ; v[6].y = -r[0]  ; v[6].z = +r[1] ;  
-    v[7].x = 1.0 ; v[7].y = +r[0]  ; v[7].z = +r[1] ;  
-
-    sellipse_trans( &se , e );
-
-    // min
-    mm[0].x = mm[0].y =  mm[0].z =  1.0;
-    // max
-    mm[1].x = mm[1].y =  mm[1].z = -1.0;
-
-    for ( i=0; i<8; i++ ){
-      euler_vector_trans ( &tv , &v[i] , &se );
-      if ( tv.x >= -1.0 && tv.x <= 1.0 ){
-        mm[0].x = min ( mm[0].x , tv.x );
-        mm[1].x = max ( mm[1].x , tv.x );
-      }
-      else if ( tv.x < -1.0 ) {
-        mm[0].x = -1.0;
-      }
-      else if ( tv.x > 1.0 ) {
-        mm[1].x = 1.0;
-      }
+    SEuler         se ;
+    SEulerMatrix   m  ;
+    float8         lim[3][2], r[2], ca, sa, sb, w ;
+    int            i ;
 
-      if ( tv.y >= -1.0 && tv.y <= 1.0 ){
-        mm[0].y = min ( mm[0].y , tv.y );
-        mm[1].y = max ( mm[1].y , tv.y );
-      }
-      else if ( tv.y < -1.0 ) {
-        mm[0].y = -1.0;
-      }
-      else if ( tv.y > 1.0 ) {
-        mm[1].y = 1.0;
-      }
+    // keep the tolerance of sellipse_cont_point
+    r[0] = e->rad[0] + EPSILON ;
+    r[1] = e->rad[1] + EPSILON ;
+    ca   = cos( r[0] ) ;
+    sa   = sin( r[0] ) ;
+    sb   = sin( r[1] ) ;
 
-      if ( tv.z >= -1.0 && tv.z <= 1.0 ){
-        mm[0].z = min ( mm[0].z , tv.z );
-        mm[1].z = max ( mm[1].z , tv.z );
-      }
-      else if ( tv.z < -1.0 ) {
-        mm[0].z = -1.0;
-      }
-      else if ( tv.z > 1.0 ) {
-        mm[1].z = 1.0;
-      }
+    // columns of matrix are the ellipse axes in global coordinates
+    seuler_matrix ( &m , sellipse_trans( &se , e ) );
 
+    for ( i=0; i<3; i++ ){
 
-    }  
-    k[0]  = mm[0].x * ks ;
-    k[1]  = mm[0].y * ks ;
-    k[2]  = mm[0].z * ks ;
-    k[3]  = mm[1].x * ks ;
-    k[4]  = mm[1].y * ks ;
-    k[5]  = mm[1].z * ks ;
+      float8  cl[2] ;
 
-    return ( k );
+      // ellipse is inside the circle around center with major axis
+      spherecircle_axis_extent ( cl, m.m[i][0], ca, sa );
+
+      // ellipse is inside the cylinder given by ellipse boundary
+      // and the x-range cos(rad[0]) .. 1 of ellipse frame
+      w = sqrt( sqr( sa * m.m[i][1] ) + sqr( sb * m.m[i][2] ) );
+      lim[i][0] = min ( m.m[i][0] , ca * m.m[i][0] ) - w ;
+      lim[i][1] = max ( m.m[i][0] , ca * m.m[i][0] ) + w ;
+
+      lim[i][0] = max ( lim[i][0] , cl[0] );
+      lim[i][1] = min ( lim[i][1] , cl[1] );
+    }
+    return spherekey_from_extent ( k , lim );
   }
 
 
@@ -233,14 +291,14 @@
   {
 
     static const int32         ks =  MAXCVALUE ;
-    static SPoint p[3] ;
+    SPoint p[3] ;
 
     sline_begin ( &p[0], sl );
     sline_end   ( &p[1], sl );
     
     if ( FPzero(sl->length) ){
 
-      static Vector3D  vbeg , vend ;
+      Vector3D  vbeg , vend ;
       spoint_vector3d ( &vbeg , &p[0] );
       spoint_vector3d ( &vend , &p[1] );
 
@@ -253,10 +311,11 @@
 
     } else {
 
-      static Vector3D  v[4], vt, vr[2] ;
-      static SEuler    se ;
-      static float8    l, ls, lc ;
-      static int8      i;
+      Vector3D  v[4], vt, vr[2] ;
+      SEuler    se ;
+      SEulerMatrix     m  ;
+      float8    l, ls, lc ;
+      int8      i;
 
       sphereline_to_euler ( &se, sl );
       l  = sl->length / 2.0 ; 
@@ -277,8 +336,9 @@
       vr[0].x  = vr[0].y = vr[0].z =  1.0;
       vr[1].x  = vr[1].y = vr[1].z = -1.0;
 
+      seuler_matrix ( &m , &se );
       for ( i=0; i<4; i++ ){
-        euler_vector_trans(&vt,&v[i],&se);
+        euler_matrix_vector_trans ( &vt , &v[i] , &m );
         if ( vt.x >= -1.0 && vt.x <= 1.0 ){
           vr[0].x = min ( vr[0].x , vt.x );
           vr[1].x = max ( vr[1].x , vt.x );
@@ -307,16 +367,18 @@
 
   /*!
     \brief Creates the key of a polygon
-    \param sp pointer to polygon
+    \param in pointer to polygon, packed or not
     \param key pointer to key
     \return pointer to key
   */
 
-  int32 * spherepoly_gen_key ( int32 * key , const SPOLY * sp )
+  int32 * spherepoly_gen_key ( int32 * key , const SPOLY * in )
   {
-      static int32   i,k,r;
-      static SLine       l;
-      static int32   tk[6];
+      /* the index keys of packed values are made of unpacked points */
+      SPOLY * sp = ( SPOLY * ) spherepoints_unpack ( ( void * ) in );
+      int32   i,k,r;
+      SLine       l;
+      int32   tk[6];
       bool   start = TRUE;
 
       for ( i=0; i<sp->npts; i++ ){
@@ -338,15 +400,20 @@
         }
       }
 
+      if ( sp != in ){
+        FREE ( sp );
+      }
       return key;
   }
 
 
-  int32 * spherepath_gen_key ( int32 * key , const SPATH * sp )
+  int32 * spherepath_gen_key ( int32 * key , const SPATH * in )
   {
-      static  int32   i,k,r;
-      static  SLine       l;
-      static  int32   tk[6];
+      /* the index keys of packed values are made of unpacked points */
+      SPATH * sp = ( SPATH * ) spherepoints_unpack ( ( void * ) in );
+      int32   i,k,r;
+      SLine       l;
+      int32   tk[6];
       bool    start = TRUE;
 
       for ( i=0; i<sp->npts; i++ ){
@@ -368,6 +435,9 @@
         }
       }
 
+      if ( sp != in ){
+        FREE ( sp );
+      }
       return key;    
   }
 
@@ -375,8 +445,8 @@
 
   int32 * spherebox_gen_key ( int32 * key , const SBOX * box )
   {
-    static SPoint  p;
-    static float8  d;
+    SPoint  p;
+    float8  d;
     
     key[0] = key[1] = key[2] =  MAXCVALUE;
     key[3] = key[4] = key[5] = -MAXCVALUE;
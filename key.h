@@ -33,6 +33,33 @@
   int32 * spherekey_inter_two ( int32 * kinter , const int32 * key );
 
 
+  /*!
+    \brief Returns the volume of a key ( cube )
+    \param v pointer to key
+    \return volume
+  */
+  double spherekey_size ( const int32 * v );
+
+  /*!
+    Splits a set of keys into two groups. The seeds are the pair
+    of keys which waste the most volume if united. The other keys
+    are added to the group whose volume grows least, beginning with
+    the keys having the largest preference.
+    \brief Splits keys into two groups ( GiST picksplit )
+    \param keys   array of n pointers to keys
+    \param n      count of keys, at least two
+    \param left   positions of keys in left group ( at least n elements )
+    \param nleft  count of keys in left group
+    \param right  positions of keys in right group ( at least n elements )
+    \param nright count of keys in right group
+    \param kl     union key of left group
+    \param kr     union key of right group
+  */
+  void spherekey_picksplit ( int32 * const * keys, int32 n,
+                             int32 * left, int32 * nleft,
+                             int32 * right, int32 * nright,
+                             int32 * kl, int32 * kr );
+
   /*!
     \brief generate key value of spherical point
     \param k  pointer to key
@@ -41,6 +68,24 @@
   */
   int32 * spherepoint_gen_key (  int32 * k , const SPoint * sp );
 
+  /*!
+    \brief generate key value of compact spherical point
+    \param k  pointer to key
+    \param p4 compact spherical point
+    \return pointer to key
+  */
+  int32 * spherepoint4_gen_key ( int32 * k , const SPoint4 * p4 );
+
+  /*!
+    The vector is converted to a spherical point first, so the
+    key is the same as the one of the spherical point.
+    \brief generate key value of vector point
+    \param k pointer to key
+    \param v vector point
+    \return pointer to key
+  */
+  int32 * spherepoint3_gen_key ( int32 * k , const Vector3D * v );
+
   /*!
     \brief generates circle's key
     \param k  pointer to key
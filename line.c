@@ -9,6 +9,8 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
   PG_FUNCTION_INFO_V1(sphereline_in);
+  PG_FUNCTION_INFO_V1(sphereline_recv);
+  PG_FUNCTION_INFO_V1(sphereline_send);
   PG_FUNCTION_INFO_V1(sphereline_from_point);
   PG_FUNCTION_INFO_V1(sphereline_from_points);
   PG_FUNCTION_INFO_V1(sphereline_from_trans);
@@ -50,8 +52,8 @@
   */
   static SLine * sline_swap_beg_end ( SLine * out, const SLine * in )
   {
-    static SLine   l;
-    static SEuler se;
+    SLine   l;
+    SEuler se;
     l.length =   in->length;
     l.phi    = - in->length;
     l.theta  = PI ;
@@ -71,7 +73,7 @@
     if ( FPne( l1->length, l2->length) ){
       return false;
     } else {
-      static SEuler e1, e2;
+      SEuler e1, e2;
       seuler_set_zxz ( &e1 );
       seuler_set_zxz ( &e2 );
       e1.phi   = l1->phi;
@@ -89,8 +91,8 @@
   bool sline_from_points ( SLine * sl, const SPoint * pbeg, const SPoint * pend )
   {
 
-    static SEuler  se;
-    static float8   l;
+    SEuler  se;
+    float8   l;
 
     l = spoint_dist ( pbeg, pend );
 
@@ -130,7 +132,7 @@
   SPoint * sline_begin ( SPoint * p, const SLine  * l )
   {
     const static SPoint  tmp = { 0.0, 0.0 } ;
-    static SEuler   se ;
+    SEuler   se ;
     sphereline_to_euler ( &se, l );
     euler_spoint_trans ( p, &tmp, &se );
     return p;
@@ -138,8 +140,8 @@
 
   SPoint * sline_end ( SPoint * p, const SLine  * l )
   {
-    static SPoint  tmp  = { 0.0, 0.0 } ;
-    static SEuler   se  ;
+    SPoint  tmp  = { 0.0, 0.0 } ;
+    SEuler   se  ;
     tmp.lng = l->length ;
     sphereline_to_euler ( &se, l );
     euler_spoint_trans ( p, &tmp, &se );
@@ -155,7 +157,7 @@
   static Vector3D * sline_vector_begin ( Vector3D * v, const SLine  * l )
   {
     const static Vector3D  tmp = { 1.0, 0.0, 0.0 } ;
-    static SEuler   se ;
+    SEuler   se ;
     sphereline_to_euler ( &se, l );
     euler_vector_trans( v, &tmp, &se );
     return v;
@@ -169,8 +171,8 @@
   */
   static Vector3D * sline_vector_end ( Vector3D * v, const SLine  * l )
   {
-    static Vector3D  tmp = { 0.0, 0.0, 0.0 } ;
-    static SEuler   se ;
+    Vector3D  tmp = { 0.0, 0.0, 0.0 } ;
+    SEuler   se ;
     tmp.x = cos(l->length);
     tmp.y = sin(l->length);
     sphereline_to_euler ( &se, l );
@@ -339,17 +341,17 @@
   int8 sphereline_circle_pos ( const SLine * sl , const SCIRCLE * sc )
   {
 
-    static float8 i, mi;
+    float8 i, mi;
     static const float8 step = ( PI - 0.01 );
-    static SPoint p[2] = { { 0.0, 0.0} , { 0.0, 0.0 } } ;
-    static SCIRCLE  c ;
-    static bool   bbeg, bend ;
-    static SEuler se ;
-    static int    contain;
+    SPoint p[2] = { { 0.0, 0.0} , { 0.0, 0.0 } } ;
+    SCIRCLE  c ;
+    bool   bbeg, bend ;
+    SEuler se ;
+    int    contain;
 
     if ( FPzero( sl->length ) ) { // line is point
       sline_begin( &p[0], sl ) ;
-      if ( spoint_in_circle ( &p[0], &c ) ){
+      if ( spoint_in_circle ( &p[0], sc ) ){
         return PGS_CIRCLE_CONT_LINE  ;
       } else {
         return PGS_CIRCLE_LINE_AVOID ;
@@ -402,8 +404,8 @@
   bool sline_circle_touch( const SLine * sl , const SCIRCLE * sc )
   {
     // we assume here, line and circle are overlapping
-    static SEuler se;
-    static SCIRCLE tc;
+    SEuler se;
+    SCIRCLE tc;
 
     sphereline_to_euler_inv ( &se, sl );
     euler_scircle_trans  ( &tc , sc , &se );
@@ -573,7 +575,7 @@
 
   SLine  * euler_sline_trans ( SLine * out , const SLine  * in , const SEuler * se )
   {
-    static SEuler stmp[2];
+    SEuler stmp[2];
     sphereline_to_euler ( &stmp[0], in );
     seuler_trans_zxz ( &stmp[1] , &stmp[0] , se );
     out->phi    = stmp[1].phi;
@@ -586,8 +588,8 @@
   bool spoint_at_sline( const SPoint * p, const SLine * sl )
   {
   
-    static SEuler se ;
-    static SPoint sp;
+    SEuler se ;
+    SPoint sp;
 
     sphereline_to_euler_inv ( &se, sl );
     euler_spoint_trans ( &sp , p , &se );
@@ -609,8 +611,8 @@
 
   SPoint * sline_center( SPoint * c, const SLine * sl )
   {
-    static SEuler se;
-    static SPoint p;
+    SEuler se;
+    SPoint p;
     p.lng = sl->length/2.0;
     p.lat = 0.0;
     sphereline_to_euler ( &se, sl );
@@ -618,6 +620,7 @@
   }
 
 
+#ifndef PGS_CORE
   Datum  sphereline_in(PG_FUNCTION_ARGS)
   {
     SLine     * sl  = ( SLine * ) MALLOC ( sizeof ( SLine ) ) ;
@@ -626,12 +629,9 @@
     float8      eang[3], length ;
     SEuler        se , stmp, so ;
     int                       i ;
+    SParseBuffer            * pb = sphere_parse ( c );
 
-    void sphere_yyparse( void );
-
-    init_buffer ( c );
-    sphere_yyparse(); 
-    if ( get_line ( &eang[0], &eang[1], &eang[2], etype, &length ) ){
+    if ( get_line ( pb, &eang[0], &eang[1], &eang[2], etype, &length ) ){
 
       for ( i=0; i<3; i++ ){
         switch ( i ){
@@ -658,15 +658,56 @@
       sl->length = length;
 
     } else {
-      reset_buffer();
       FREE( sl );
       sl = NULL;
       elog ( ERROR , "sphereline_in: parse error" );
     }
-    reset_buffer();
+    free_buffer ( pb );
+
+    PG_RETURN_POINTER( sl );
+
+  }
+
+  Datum  sphereline_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo  buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SLine     * sl  = ( SLine * ) MALLOC ( sizeof ( SLine ) ) ;
+    SEuler        se ;
+    float8        length ;
+
+    seuler_set_zxz ( &se );
+    se.phi     = pgs_getmsgfloat8 ( buf );
+    se.theta   = pgs_getmsgfloat8 ( buf );
+    se.psi     = pgs_getmsgfloat8 ( buf );
+    length     = pgs_getmsgfloat8 ( buf );
+    spheretrans_check ( &se );
+
+    sl->phi    = se.phi;
+    sl->theta  = se.theta;
+    sl->psi    = se.psi;
+
+    if ( length < 0.0 ){
+      FREE( sl );
+      elog ( ERROR , "sphereline_recv: length must be not negative" );
+      PG_RETURN_NULL();
+    } else if ( FPge(length, PID) ){
+      length = PID ;
+    }
+    sl->length = length;
 
     PG_RETURN_POINTER( sl );
+  }
 
+  Datum  sphereline_send(PG_FUNCTION_ARGS)
+  {
+    SLine  * sl = ( SLine * ) PG_GETARG_POINTER(0);
+    StringInfoData buf;
+    pq_begintypsend ( &buf );
+    pq_sendfloat8 ( &buf, sl->phi );
+    pq_sendfloat8 ( &buf, sl->theta );
+    pq_sendfloat8 ( &buf, sl->psi );
+    pq_sendfloat8 ( &buf, sl->length );
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
   }
 
   Datum  sphereline_equal(PG_FUNCTION_ARGS)
@@ -717,7 +758,7 @@
       elog ( ERROR , "sphereline_from_trans: length of line must be >= 0" );
       PG_RETURN_NULL( );
     } else {
-      static SEuler tmp;
+      SEuler tmp;
       if ( FPgt ( l, PID ) ){
         l = PID;
       }
@@ -959,4 +1000,5 @@
     sphereline_to_euler ( e, l );
     PG_RETURN_POINTER ( e );
   }
+#endif
 
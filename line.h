@@ -185,6 +185,20 @@ typedef struct {
   */
   Datum  sphereline_in                  (PG_FUNCTION_ARGS);
 
+  /*!
+    \brief binary input function of spherical line
+    \return spherical line datum
+    \note PostgreSQL function
+  */
+  Datum  sphereline_recv                (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief binary output function of spherical line
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  sphereline_send                (PG_FUNCTION_ARGS);
+
   /*!
     \brief Casts spherical point as line
     \return a spherical line datum
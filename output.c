@@ -1,4 +1,10 @@
 #include "types.h"
+#include "dtoa.h"
+#if PG_VERSION_NUM >= 120000
+#include "utils/float.h"
+#else
+#include "utils/builtins.h"
+#endif
 
 /*!
   \file
@@ -17,6 +23,9 @@
 #define OUTPUT_HMS  4    //!< output in hour, minutes, seconds
 /* @} */
 
+#define OUTPUT_POINT_LEN  64  //!< expected output length of a spherical point
+#define OUTPUT_ANGLE_LEN  32  //!< expected output length of a single angle
+
 /*!
   Default is radians.
   \brief holds the current output modus.
@@ -28,6 +37,8 @@ static short int sphere_output_precision = -1;
 
   PG_FUNCTION_INFO_V1 (set_sphere_output);
   PG_FUNCTION_INFO_V1 (spherepoint_out  );
+  PG_FUNCTION_INFO_V1 (spherepoint4_out );
+  PG_FUNCTION_INFO_V1 (spherepoint3_out );
   PG_FUNCTION_INFO_V1 (spherecircle_out );
   PG_FUNCTION_INFO_V1 (sphereline_out   );
   PG_FUNCTION_INFO_V1 (spheretrans_out  );
@@ -61,6 +72,20 @@ static short int sphere_output_precision = -1;
   */
   Datum  spherepoint_out           (PG_FUNCTION_ARGS);
 
+  /*!
+    \brief the output function of compact spherical point
+    \return cstring
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_out          (PG_FUNCTION_ARGS);
+
+  /*!
+    \brief the output function of vector point
+    \return cstring
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_out          (PG_FUNCTION_ARGS);
+
   /*!
     \brief the output function of spherical circle
     \return cstring
@@ -149,6 +174,257 @@ static short int sphere_output_precision = -1;
     }
   }
 
+  /*!
+    \brief creates an output buffer
+    \param si   pointer to string buffer
+    \param size expected length of output
+  */
+  static void out_init ( StringInfo si, int size )
+  {
+    si->data    = ( char * ) MALLOC ( size + 1 );
+    si->maxlen  = size + 1;
+    si->len     = 0;
+    si->cursor  = 0;
+    si->data[0] = '\0';
+  }
+
+  /*!
+    \brief appends an unsigned integer like sprintf's "%*u" or "%0*u"
+    \param si    pointer to string buffer
+    \param v     value
+    \param width minimum field width
+    \param zero  if true, pad with zeros instead of blanks
+  */
+  static void out_uint ( StringInfo si, unsigned int v, int width, bool zero )
+  {
+    char  tmp[16];
+    int   n = 0, i;
+    char  buf[32];
+    int   l = 0;
+
+    do {
+      tmp[n++] = '0' + ( v % 10 );
+      v       /= 10;
+    } while ( v > 0 );
+    for ( i = n; i < width; i++ ){
+      buf[l++] = ( zero ) ? '0' : ' ';
+    }
+    while ( n > 0 ){
+      buf[l++] = tmp[--n];
+    }
+    appendBinaryStringInfo ( si, buf, l );
+  }
+
+  /*!
+    The value is written like "%.*g" with DBL_DIG digits. Only if
+    extra_float_digits is set to 3, as pg_dump does, the shortest
+    text that reads back as the same value is used.
+    \brief appends a double with the default output precision
+    \param si pointer to string buffer
+    \param v  value
+  */
+  static void out_float ( StringInfo si, double v )
+  {
+    char  buf[DTOA_SHORT_BUFLEN];
+    int   n;
+
+    if ( extra_float_digits >= 3 ){
+      n = pgs_dtoa_shortest ( v, buf );
+    } else {
+      n = pgs_dtoa_g ( v, DBL_DIG, buf );
+    }
+    appendBinaryStringInfo ( si, buf, n );
+  }
+
+  /*!
+    \brief appends a double like sprintf's "%*.*f" or "%0*.*f"
+    \param si    pointer to string buffer
+    \param v     value
+    \param width minimum field width
+    \param prec  number of decimals
+    \param zero  if true, pad with zeros instead of blanks
+  */
+  static void out_fixed ( StringInfo si, double v, int width, int prec, bool zero )
+  {
+    char  buf[DTOA_BUFLEN];
+    int   n = pgs_dtoa_f ( v, width, prec, zero, buf );
+    appendBinaryStringInfo ( si, buf, n );
+  }
+
+  /*!
+    Writes degrees ( or hours ), minutes and seconds. With the
+    default precision the numbers are padded with blanks, otherwise
+    with zeros.
+    \brief appends an angle in DMS or HMS format
+    \param si    pointer to string buffer
+    \param rad   angle in radians ( divided by 15 for hours )
+    \param unit  'd' for degrees, 'h' for hours
+    \param dw    field width of degrees
+    \param sw    field width of seconds
+    \param sp    number of decimals of seconds
+    \param szero if true, pad seconds with zeros
+  */
+  static void out_dms ( StringInfo si, double rad, char unit, int dw, int sw, int sp, bool szero )
+  {
+    unsigned int  deg = 0, min = 0;
+    double        sec = 0.0;
+    bool          zero = ( sphere_output_precision != -1 );
+
+    rad_to_dms ( rad, &deg, &min, &sec );
+    out_uint ( si, deg, dw, zero );
+    appendStringInfoChar ( si, unit );
+    appendStringInfoChar ( si, ' ' );
+    out_uint ( si, min, 2, zero );
+    appendBinaryStringInfo ( si, "m ", 2 );
+    if ( zero ){
+      out_fixed ( si, sec, sw, sp, szero );
+    } else {
+      out_float ( si, sec );
+    }
+    appendStringInfoChar ( si, 's' );
+  }
+
+  /*!
+    Used for radii, lengths and Euler angles.
+    \brief appends an angle in the current output mode
+    \param si     pointer to string buffer
+    \param rad    angle in radians
+    \param rwidth field width of radians with fixed precision
+    \param szero  if true, pad seconds with zeros
+  */
+  static void out_angle ( StringInfo si, double rad, int rwidth, bool szero )
+  {
+    short int sopd = sphere_output_precision;
+    short int sopl = ( sopd > 0 ) ? sopd + 3 : sopd + 2;
+
+    switch ( sphere_output ){
+
+      case OUTPUT_DEG : if ( sopd == -1 ){
+                          out_float ( si, RADIANS * rad );
+                        } else {
+                          out_fixed ( si, RADIANS * rad, sopd + 8, sopd + 4, false );
+                        }
+                        appendStringInfoChar ( si, 'd' );
+                        break;
+      case OUTPUT_HMS :
+      case OUTPUT_DMS : out_dms ( si, rad, 'd', 2, sopl, sopd, szero );
+                        break;
+      default         : if ( sopd == -1 ){
+                          out_float ( si, rad );
+                        } else {
+                          out_fixed ( si, rad, sopd + rwidth, sopd + 6, false );
+                        }
+                        break;
+    }
+  }
+
+  /*!
+    \brief appends a spherical point in the current output mode
+    \param si pointer to string buffer
+    \param sp pointer to spherical point
+  */
+  static void out_spoint ( StringInfo si, const SPoint * sp )
+  {
+    short int sopd = sphere_output_precision;
+    short int sopl = ( sopd > 0 ) ? sopd + 3 : sopd + 2;
+    char      sign = ( sp->lat < 0 ) ? ( '-' ) : ( '+' );
+
+    appendStringInfoChar ( si, '(' );
+    switch ( sphere_output ){
+
+      case OUTPUT_DEG : if ( sopd == -1 ){
+                          out_float ( si, RADIANS * sp->lng );
+                          appendBinaryStringInfo ( si, "d , ", 4 );
+                          out_float ( si, RADIANS * sp->lat );
+                        } else {
+                          out_fixed ( si, RADIANS * sp->lng, sopd + 8, sopd + 4, false );
+                          appendBinaryStringInfo ( si, "d , ", 4 );
+                          out_fixed ( si, RADIANS * sp->lat, sopd + 8, sopd + 4, false );
+                        }
+                        appendStringInfoChar ( si, 'd' );
+                        break;
+      case OUTPUT_DMS : out_dms ( si, sp->lng, 'd', 3, sopl, sopd, true );
+                        appendBinaryStringInfo ( si, " , ", 3 );
+                        appendStringInfoChar ( si, sign );
+                        out_dms ( si, sp->lat, 'd', 2, sopl, sopd, true );
+                        break;
+      case OUTPUT_HMS : out_dms ( si, sp->lng / 15, 'h', ( sopd == -1 ) ? 3 : 2,
+                                  ( sopd == 0 ) ? sopl + 2 : sopl + 1, sopd + 1, true );
+                        appendBinaryStringInfo ( si, " , ", 3 );
+                        appendStringInfoChar ( si, sign );
+                        out_dms ( si, sp->lat, 'd', 2, sopl, sopd, true );
+                        break;
+      default         : if ( sopd == -1 ){
+                          out_float ( si, sp->lng );
+                          appendBinaryStringInfo ( si, " , ", 3 );
+                          out_float ( si, sp->lat );
+                        } else {
+                          out_fixed ( si, sp->lng, sopd + 9, sopd + 6, false );
+                          appendBinaryStringInfo ( si, " , ", 3 );
+                          out_fixed ( si, sp->lat, sopd + 9, sopd + 6, false );
+                        }
+                        break;
+    }
+    appendStringInfoChar ( si, ')' );
+  }
+
+  /*!
+    \brief appends the points of a path or polygon in braces
+    \param si   pointer to string buffer
+    \param p    array of points
+    \param npts number of points
+  */
+  static void out_spoints ( StringInfo si, const SPoint * p, int32 npts )
+  {
+    int32 i;
+
+    appendStringInfoChar ( si, '{' );
+    for ( i = 0; i < npts; i++ ){
+      if ( i > 0 ){
+        appendStringInfoChar ( si, ',' );
+      }
+      out_spoint ( si, &p[i] );
+    }
+    appendStringInfoChar ( si, '}' );
+  }
+
+  /*!
+    \brief appends the angles and axes of an Euler transformation
+    \param si pointer to string buffer
+    \param se pointer to Euler transformation
+  */
+  static void out_strans ( StringInfo si, const SEuler * se )
+  {
+    SPoint         val[3];
+    unsigned char  i, t = 0;
+
+    val[0].lat = val[1].lat = val[2].lat = 0.0;
+    val[0].lng = se->phi;
+    val[1].lng = se->theta;
+    val[2].lng = se->psi;
+
+    spoint_check ( &val[0] );
+    spoint_check ( &val[1] );
+    spoint_check ( &val[2] );
+
+    for ( i=0; i<3; i++ ){
+      out_angle ( si, val[i].lng, 9, true );
+      appendBinaryStringInfo ( si, ", ", 2 );
+    }
+    for ( i=0; i<3; i++ ){
+      switch ( i ){
+        case 0: t = se->phi_a  ; break;
+        case 1: t = se->theta_a; break;
+        case 2: t = se->psi_a  ; break;
+      }
+      switch ( t ){
+        case EULER_AXIS_X : appendStringInfoChar ( si, 'X' ); break;
+        case EULER_AXIS_Y : appendStringInfoChar ( si, 'Y' ); break;
+        case EULER_AXIS_Z : appendStringInfoChar ( si, 'Z' ); break;
+      }
+    }
+  }
+
   Datum set_sphere_output_precision(PG_FUNCTION_ARGS)
   {
     short int  c  = PG_GETARG_INT16(0);
@@ -186,399 +462,138 @@ static short int sphere_output_precision = -1;
 
   Datum spherepoint_out(PG_FUNCTION_ARGS)
   {
-
     SPoint * sp   =  ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
-    char * buffer = ( char * ) MALLOC ( 255 ) ;
-    unsigned int latdeg , latmin, lngdeg, lngmin;
-    double latsec, lngsec;
-    short int sopd=sphere_output_precision;
-    short int sopl=( sopd>0 )? sopd+3 : sopd+2;
-    
-    latdeg = latmin = lngdeg = lngmin = 0;
-    latsec = lngsec = 0.0;
-
-    switch ( sphere_output ){
+    StringInfoData si;
 
-      case OUTPUT_DEG : if(sphere_output_precision==-1) {
-                          sprintf ( buffer , "(%.*gd , %.*gd)", 
-                            DBL_DIG, RADIANS*sp->lng, DBL_DIG, RADIANS*sp->lat );
-                        } else {
-                          sprintf ( buffer , "(%*.*fd , %*.*fd)", 
-                            sopd+8, sopd+4, RADIANS*sp->lng,
-                            sopd+8, sopd+4, RADIANS*sp->lat );
-                        }
-                        break;
-      case OUTPUT_DMS : rad_to_dms ( sp->lng , &lngdeg, &lngmin, &lngsec );
-                        rad_to_dms ( sp->lat , &latdeg, &latmin, &latsec );
-                        if(sphere_output_precision==-1) {
-                          sprintf (
-                            buffer ,
-                            "(%3ud %2um %.*gs , %c%2ud %2um %.*gs)",
-                            lngdeg, lngmin, DBL_DIG, lngsec,
-                            ( sp->lat<0 )?('-'):('+'),
-                            latdeg, latmin, DBL_DIG, latsec 
-                          );
-                        } else {
-                          sprintf (
-                            buffer ,
-                            "(%03ud %02um %0*.*fs , %c%02ud %02um %0*.*fs)",
-                            lngdeg, lngmin, sopl, sopd, lngsec,
-                            ( sp->lat<0 )?('-'):('+'),
-                            latdeg, latmin, sopl, sopd, latsec 
-                          );
-                        }
-                        break;
+    out_init ( &si, OUTPUT_POINT_LEN );
+    out_spoint ( &si, sp );
+    PG_RETURN_CSTRING ( si.data );
+  }
 
-      case OUTPUT_HMS : rad_to_dms ( sp->lng / 15 , &lngdeg, &lngmin, &lngsec );
-                        rad_to_dms ( sp->lat , &latdeg, &latmin, &latsec );
-                        if(sphere_output_precision==-1) {
-                          sprintf ( 
-                            buffer ,
-                            "(%3uh %2um %.*gs , %c%2ud %2um %.*gs)",
-                            lngdeg, lngmin, DBL_DIG, lngsec,
-                            ( sp->lat<0 )?('-'):('+'),
-                            latdeg, latmin, DBL_DIG, latsec 
-                          );
-                        } else {
-                          sprintf (
-                            buffer ,
-                            "(%02uh %02um %0*.*fs , %c%02ud %02um %0*.*fs)",
-                            lngdeg, lngmin, (sopd==0)?sopl+2:sopl+1, sopd+1, lngsec,
-                            ( sp->lat<0 )?('-'):('+'),
-                            latdeg, latmin, sopl, sopd, latsec 
-                          );
-                        }
-                        break;
+  Datum spherepoint4_out(PG_FUNCTION_ARGS)
+  {
+    SPoint4 * p4  =  ( SPoint4 * ) PG_GETARG_POINTER ( 0 ) ;
+    SPoint    sp;
+    StringInfoData si;
 
-      default         : if(sphere_output_precision==-1) {
-                          sprintf ( buffer , "(%.*g , %.*g)", DBL_DIG, sp->lng, DBL_DIG, sp->lat );
-                        } else {
-                          sprintf ( buffer , "(%*.*f , %*.*f)", sopd+9, sopd+6, sp->lng, sopd+9, sopd+6, sp->lat );
-                        }
-                        break;
-    }
+    out_init ( &si, OUTPUT_POINT_LEN );
+    out_spoint ( &si, spoint4_to_spoint ( &sp, p4 ) );
+    PG_RETURN_CSTRING ( si.data );
+  }
 
-    PG_RETURN_CSTRING ( buffer );
+  Datum spherepoint3_out(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v  =  ( Vector3D * ) PG_GETARG_POINTER ( 0 ) ;
+    SPoint     sp;
+    StringInfoData si;
 
+    out_init ( &si, OUTPUT_POINT_LEN );
+    out_spoint ( &si, vector3d_spoint ( &sp, v ) );
+    PG_RETURN_CSTRING ( si.data );
   }
 
   Datum spherecircle_out(PG_FUNCTION_ARGS)
   {
     SCIRCLE  *    c =  ( SCIRCLE  * ) PG_GETARG_POINTER ( 0 ) ;
-    char * buffer   =  ( char * ) MALLOC (255);
-    char * pointstr = DatumGetPointer( DirectFunctionCall1 ( spherepoint_out , PointerGetDatum(&c->center) ) ) ;
-
-    unsigned int rdeg , rmin;
-    double rsec;
-
-    short int sopd=sphere_output_precision;
-    short int sopl=( sopd>0 )? sopd+3 : sopd+2;
-
-    rdeg = rmin = 0;
-    rsec = 0.0;
-
-    switch ( sphere_output ){
-
-      case OUTPUT_DEG : if(sphere_output_precision==-1) {
-                          sprintf ( buffer , "<%s , %.*gd>", pointstr, DBL_DIG, RADIANS*c->radius );
-                        } else {
-                          sprintf ( buffer , "<%s , %*.*fd>", pointstr, sopd+8, sopd+4, RADIANS*c->radius );
-                        }
-                        break;
-      case OUTPUT_HMS :
-      case OUTPUT_DMS : rad_to_dms ( c->radius , &rdeg, &rmin, &rsec );
-                        if(sphere_output_precision==-1) {
-                          sprintf ( 
-                            buffer ,
-                            "<%s , %2ud %2um %.*gs>",
-                            pointstr,
-                            rdeg, rmin, DBL_DIG, rsec
-                          );
-                        } else {
-                          sprintf ( 
-                            buffer ,
-                            "<%s , %02ud %02um %0*.*fs>",
-                            pointstr,
-                            rdeg, rmin, sopl, sopd, rsec
-                          );
-                        }
-                        break;
-      default         : if(sphere_output_precision==-1) {
-                          sprintf ( buffer , "<%s , %.*g>", pointstr, DBL_DIG, c->radius );
-                        } else {
-                          sprintf ( buffer , "<%s , %*.*f>", pointstr, sopd+9, sopd+6, c->radius );
-                        }
-                        break;
-    }
-
-    FREE ( pointstr );
-    PG_RETURN_CSTRING ( buffer );
-
+    StringInfoData si;
+
+    out_init ( &si, OUTPUT_POINT_LEN + OUTPUT_ANGLE_LEN + 6 );
+    appendStringInfoChar ( &si, '<' );
+    out_spoint ( &si, &c->center );
+    appendBinaryStringInfo ( &si, " , ", 3 );
+    out_angle ( &si, c->radius, 9, true );
+    appendStringInfoChar ( &si, '>' );
+    PG_RETURN_CSTRING ( si.data );
   }
 
 
   Datum sphereellipse_out(PG_FUNCTION_ARGS)
   {
     SELLIPSE    * e =  ( SELLIPSE  * ) PG_GETARG_POINTER ( 0 ) ;
-    char * buffer   =  ( char * ) MALLOC (255);
-    char * pointstr ;
-    unsigned int rdeg[3] , rmin[3];
-    double rsec[3];
+    StringInfoData si;
     SPoint sp;
-    
-    short int sopd=sphere_output_precision;
-    short int sopl=( sopd>0 )? sopd+3 : sopd+2;
 
     sp.lng   =   e->psi  ;
     sp.lat   = - e->theta;
-    pointstr = DatumGetPointer( DirectFunctionCall1 ( spherepoint_out , PointerGetDatum(&sp) ) );
-
-
-    switch ( sphere_output ){
-
-      case OUTPUT_DEG : if(sphere_output_precision==-1) {
-                          sprintf ( buffer , "<{ %.*gd , %.*gd }, %s , %.*gd>", 
-                            DBL_DIG, RADIANS*(e->rad[0]), DBL_DIG, RADIANS*(e->rad[1]),
-                            pointstr, DBL_DIG, RADIANS*(e->phi) );
-                        } else {
-                          sprintf ( buffer , "<{ %*.*fd , %*.*fd }, %s , %*.*fd>", 
-                            sopd+8, sopd+4, RADIANS*(e->rad[0]),
-                            sopd+8, sopd+4, RADIANS*(e->rad[1]),
-                            pointstr, sopd+8, sopd+4, RADIANS*(e->phi) );
-                        }
-                        break;
-      case OUTPUT_HMS :
-      case OUTPUT_DMS : rad_to_dms ( e->rad[0] , &rdeg[0], &rmin[0], &rsec[0] );
-                        rad_to_dms ( e->rad[1] , &rdeg[1], &rmin[1], &rsec[1] );
-                        rad_to_dms ( e->phi    , &rdeg[2], &rmin[2], &rsec[2] );
-                        if(sphere_output_precision==-1) {
-                          sprintf ( buffer ,
-                            "<{ %2ud %2um %.*gs , %2ud %2um %.*gs }, %s , %2ud %2um %.*gs>",
-                            rdeg[0], rmin[0], DBL_DIG, rsec[0],
-                            rdeg[1], rmin[1], DBL_DIG, rsec[1],
-                            pointstr,
-                            rdeg[2], rmin[2], DBL_DIG, rsec[2] );
-                        } else {
-                          sprintf ( buffer ,
-                            "<{ %02ud %02um %*.*fs , %02ud %02um %*.*fs }, %s , %02ud %02um %*.*fs>",
-                            rdeg[0], rmin[0], sopl, sopd, rsec[0],
-                            rdeg[1], rmin[1], sopl, sopd, rsec[1],
-                            pointstr,
-                            rdeg[2], rmin[2], sopl, sopd, rsec[2] );
-                        }
-                        break;
-      default         : if(sphere_output_precision==-1) {
-                          sprintf ( buffer , "<{ %.*g , %.*g }, %s , %.*g>",
-                            DBL_DIG, e->rad[0], DBL_DIG, e->rad[1],
-                            pointstr, DBL_DIG, e->phi );
-                        } else {
-                          sprintf ( buffer , "<{ %*.*f , %*.*f }, %s , %*.*f>",
-                            sopd+8, sopd+6, e->rad[0],
-                            sopd+8, sopd+6, e->rad[1],
-                            pointstr, sopd+8, sopd+6, e->phi );
-                        }
-                        break;
-    }
 
-    FREE ( pointstr );
-    PG_RETURN_CSTRING ( buffer );
+    out_init ( &si, OUTPUT_POINT_LEN + 3 * OUTPUT_ANGLE_LEN + 16 );
+    appendBinaryStringInfo ( &si, "<{ ", 3 );
+    out_angle ( &si, e->rad[0], 8, false );
+    appendBinaryStringInfo ( &si, " , ", 3 );
+    out_angle ( &si, e->rad[1], 8, false );
+    appendBinaryStringInfo ( &si, " }, ", 4 );
+    out_spoint ( &si, &sp );
+    appendBinaryStringInfo ( &si, " , ", 3 );
+    out_angle ( &si, e->phi, 8, false );
+    appendStringInfoChar ( &si, '>' );
+    PG_RETURN_CSTRING ( si.data );
   }
 
   Datum sphereline_out(PG_FUNCTION_ARGS)
   {
     SLine    * sl   =  ( SLine  * ) PG_GETARG_POINTER ( 0 ) ;
-    char     * out  =  ( char * ) MALLOC (255) ;
-    char     * tstr =  NULL;
+    StringInfoData si;
     SEuler     se ;
 
-    unsigned int rdeg , rmin;
-    double rsec;
-
-    short int sopd=sphere_output_precision;
-    short int sopl=( sopd>0 )? sopd+3 : sopd+2;
-
-    rdeg = rmin = 0;
-    rsec = 0.0;
-    
     seuler_set_zxz ( &se );
     se.phi   = sl->phi;
     se.theta = sl->theta;
     se.psi   = sl->psi;
-    tstr     = DatumGetPointer ( DirectFunctionCall1 ( 
-                       spheretrans_out,
-                       PointerGetDatum ( &se ) ) );
-
-    switch ( sphere_output ){
 
-      case OUTPUT_DEG : if(sphere_output_precision==-1) {
-                          sprintf ( out , "( %s ), %.*gd", tstr, DBL_DIG, RADIANS*sl->length );
-                        } else {
-                          sprintf ( out , "( %s ), %*.*fd", tstr, sopd+8, sopd+4, RADIANS*sl->length );
-                        }
-                        break;
-      case OUTPUT_HMS :
-      case OUTPUT_DMS : rad_to_dms ( sl->length , &rdeg, &rmin, &rsec );
-                        if(sphere_output_precision==-1) {
-                          sprintf ( 
-                            out ,
-                            "( %s ), %2ud %2um %.*gs",
-                            tstr, rdeg, rmin, DBL_DIG, rsec
-                          );
-                        } else {
-                          sprintf ( 
-                            out ,
-                            "( %s ), %02ud %02um %0*.*fs",
-                            tstr, rdeg, rmin, sopl, sopd, rsec
-                          );
-                        }
-                        break;
-      default         : if(sphere_output_precision==-1) {
-                          sprintf ( out , "( %s ), %.*g", tstr, DBL_DIG, sl->length );
-                        } else {
-                          sprintf ( out , "( %s ), %*.*f", tstr, sopd+8, sopd+6, sl->length );
-                        }
-                        break;
-    }
-
-    PG_RETURN_CSTRING ( out );
+    out_init ( &si, 4 * OUTPUT_ANGLE_LEN + 16 );
+    appendBinaryStringInfo ( &si, "( ", 2 );
+    out_strans ( &si, &se );
+    appendBinaryStringInfo ( &si, " ), ", 4 );
+    out_angle ( &si, sl->length, 8, true );
+    PG_RETURN_CSTRING ( si.data );
   }
 
 
   Datum spheretrans_out(PG_FUNCTION_ARGS)
   {
     SEuler  *    se =  ( SEuler  * ) PG_GETARG_POINTER ( 0 ) ;
-    char * buffer   =  ( char * ) MALLOC (255);
-    char  buf[100];
-    char  etype[4];
-    SPoint  val[3];
-    unsigned char i, t = 0;
-    unsigned int rdeg , rmin;
-    double rsec;
-
-    short int sopd=sphere_output_precision;
-    short int sopl=( sopd>0 )? sopd+3 : sopd+2;
-
-    val[0].lat = val[1].lat = val[2].lat = 0.0;
-    val[0].lng = se->phi;
-    val[1].lng = se->theta;
-    val[2].lng = se->psi;
+    StringInfoData si;
 
-    spoint_check ( &val[0] );
-    spoint_check ( &val[1] );
-    spoint_check ( &val[2] );
-    
-    buffer[0] ='\0';
-    for ( i=0; i<3; i++){
-
-      rdeg = rmin = 0;
-      rsec = 0.0;
-      switch ( sphere_output ){
-
-        case OUTPUT_DEG : if(sphere_output_precision==-1) {
-                            sprintf ( &buf[0] , "%.*gd", DBL_DIG, RADIANS*val[i].lng );
-                          } else {
-                            sprintf ( &buf[0] , "%*.*fd", sopd+8, sopd+4, RADIANS*val[i].lng );
-                          }
-                          break;
-        case OUTPUT_HMS :
-        case OUTPUT_DMS : rad_to_dms ( val[i].lng , &rdeg, &rmin, &rsec );
-                          if(sphere_output_precision==-1) {
-                            sprintf ( 
-                              &buf[0] ,
-                              "%2ud %2um %.*gs",
-                              rdeg, rmin, DBL_DIG, rsec
-                            );
-                          } else {
-                            sprintf ( 
-                              &buf[0] ,
-                              "%02ud %02um %0*.*fs",
-                              rdeg, rmin, sopl, sopd, rsec
-                            );
-                          }
-                          break;
-        default         : if(sphere_output_precision==-1) {
-                            sprintf ( &buf[0] , "%.*g", DBL_DIG, val[i].lng );
-                          } else {
-                            sprintf ( &buf[0] , "%*.*f", sopd+9, sopd+6, val[i].lng );
-                          }
-                          break;
-      }
-      strcat( &buf[0], ", ");
-      strcat ( buffer, &buf[0] );
-    }
-    for ( i=0; i<3; i++ ){
-      switch ( i ){
-        case 0: t = se->phi_a  ; break;
-        case 1: t = se->theta_a; break;
-        case 2: t = se->psi_a  ; break;
-      }
-      switch ( t ){
-        case EULER_AXIS_X : etype[i]='X'; break;
-        case EULER_AXIS_Y : etype[i]='Y'; break;
-        case EULER_AXIS_Z : etype[i]='Z'; break;
-      }
-    }
-    etype[3] = '\0';
-    strcat( buffer , etype );
-
-    PG_RETURN_CSTRING ( buffer );
+    out_init ( &si, 3 * OUTPUT_ANGLE_LEN + 10 );
+    out_strans ( &si, se );
+    PG_RETURN_CSTRING ( si.data );
   }
 
 
   Datum spherepath_out(PG_FUNCTION_ARGS)
   {
     SPATH * path = PG_GETARG_SPATH( 0 ) ;
-    int32  i ;
-    char * out   =  ( char * ) MALLOC ( 128 * path->npts );
-    char * tmp;
-
-    strcpy(out,"{");
-    for ( i = 0; i<path->npts; i++ ){
-      if ( i>0 ){
-      	strcat(out,",");
-      }
-      tmp = DatumGetPointer ( DirectFunctionCall1( spherepoint_out , PointerGetDatum( &path->p[i] ) ) );
-      strcat(out,tmp);
-      FREE ( tmp );
-    }
-    strcat(out,"}");
-    PG_RETURN_CSTRING ( out );
+    StringInfoData si;
+
+    out_init ( &si, ( OUTPUT_POINT_LEN + 1 ) * path->npts + 2 );
+    out_spoints ( &si, &path->p[0], path->npts );
+    PG_RETURN_CSTRING ( si.data );
   }
 
 
   Datum spherepoly_out(PG_FUNCTION_ARGS)
   {
     SPOLY * poly = PG_GETARG_SPOLY( 0 );
-    int32  i ;
-    char * out   =  ( char * ) MALLOC ( 128 * poly->npts );
-    char * tmp;
-
-    strcpy(out,"{");
-    for ( i = 0; i<poly->npts; i++ ){
-      if ( i>0 ){
-      	strcat(out,",");
-      }
-      tmp = DatumGetPointer ( DirectFunctionCall1( spherepoint_out , PointerGetDatum( &poly->p[i] ) ) );
-      strcat(out,tmp);
-      FREE ( tmp );
-    }
-    strcat(out,"}");
-    PG_RETURN_CSTRING ( out );
+    StringInfoData si;
+
+    out_init ( &si, ( OUTPUT_POINT_LEN + 1 ) * poly->npts + 2 );
+    out_spoints ( &si, &poly->p[0], poly->npts );
+    PG_RETURN_CSTRING ( si.data );
   }
 
 
   Datum spherebox_out(PG_FUNCTION_ARGS)
   {
     SBOX  * box      =  ( SBOX * ) PG_GETARG_POINTER ( 0 ) ;
-    char  * buffer   =  ( char * ) MALLOC (255);
-    char  * str1     =  DatumGetPointer( DirectFunctionCall1 ( spherepoint_out , PointerGetDatum(&box->sw) ) ) ;
-    char  * str2     =  DatumGetPointer( DirectFunctionCall1 ( spherepoint_out , PointerGetDatum(&box->ne) ) ) ;
-
-    sprintf ( buffer, "(%s, %s)", str1, str2 );
-    FREE ( str1 );
-    FREE ( str2 );
-    PG_RETURN_CSTRING ( buffer );
-
+    StringInfoData si;
+
+    out_init ( &si, 2 * OUTPUT_POINT_LEN + 4 );
+    appendStringInfoChar ( &si, '(' );
+    out_spoint ( &si, &box->sw );
+    appendBinaryStringInfo ( &si, ", ", 2 );
+    out_spoint ( &si, &box->ne );
+    appendStringInfoChar ( &si, ')' );
+    PG_RETURN_CSTRING ( si.data );
   }
 
 
@@ -9,6 +9,10 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
   PG_FUNCTION_INFO_V1(spherepath_in);
+  PG_FUNCTION_INFO_V1(spherepath_recv);
+  PG_FUNCTION_INFO_V1(spherepath_send);
+  PG_FUNCTION_INFO_V1(spherepath_from_arrays);
+  PG_FUNCTION_INFO_V1(spherepath_from_points);
   PG_FUNCTION_INFO_V1(spherepath_get_point);
   PG_FUNCTION_INFO_V1(spherepath_point);
   PG_FUNCTION_INFO_V1(spherepath_equal);
@@ -52,6 +56,8 @@
   PG_FUNCTION_INFO_V1(sphereellipse_overlap_path_com_neg );
   PG_FUNCTION_INFO_V1(spheretrans_path);
   PG_FUNCTION_INFO_V1(spheretrans_path_inverse);
+  PG_FUNCTION_INFO_V1(spherepath_pack);
+  PG_FUNCTION_INFO_V1(spherepath_unpack);
   PG_FUNCTION_INFO_V1(spherepath_add_point);
   PG_FUNCTION_INFO_V1(spherepath_add_points_finalize);
 
@@ -65,7 +71,7 @@
     \param nelem count of elements
     \return pointer to created spherical polygon
   */
-  static SPATH * spherepath_from_array ( SPoint * arr, int32 nelem )
+  PGS_KERNEL SPATH * spherepath_from_array ( SPoint * arr, int32 nelem )
   {
 
     SPATH  * path = NULL;
@@ -75,8 +81,8 @@
       return NULL;
     } else {
 
-      static int32  i;
-      static float8 scheck ;
+      int32  i;
+      float8 scheck ;
       int32      size;
 
       for ( i=0; i<nelem ; i++ ){
@@ -134,14 +140,16 @@
     \param se  pointer to Euler transformation
     \return pointer to result path
   */
-  static SPATH  * euler_spath_trans ( SPATH * out , const SPATH  * in , const SEuler * se )
+  PGS_KERNEL SPATH  * euler_spath_trans ( SPATH * out , const SPATH  * in , const SEuler * se )
   {
     int32 i;
+    SEulerMatrix m;
     
     out->size = in->size;
     out->npts = in->npts;
+    seuler_matrix ( &m , se );
     for ( i=0; i<in->npts ; i++ ){
-      euler_spoint_trans ( &out->p[i] , &in->p[i] , se );
+      euler_matrix_spoint_trans ( &out->p[i] , &in->p[i] , &m );
     }
     return out ;
   }
@@ -155,12 +163,12 @@
     \param circ pointer to circle
     \return relationship as a \link PGS_CIRCLE_PATH_REL int8 value \endlink (\ref PGS_CIRCLE_PATH_REL )
   */
-  static int8  path_circle_pos ( const SPATH * path, const SCIRCLE * circ )
+  PGS_KERNEL int8  path_circle_pos ( const SPATH * path, const SCIRCLE * circ )
   {
-     static int8    pos;
-     static int32     i;
-     static SLine    sl;
-     static int32     n;
+     int8    pos;
+     int32     i;
+     SLine    sl;
+     int32     n;
      static const int8 sc_in = ( 1 << PGS_CIRCLE_CONT_LINE  );
      static const int8 sc_ov = ( 1 << PGS_CIRCLE_LINE_OVER  );
      static const int8 sc_os = ( 1 << PGS_CIRCLE_LINE_AVOID );
@@ -206,9 +214,9 @@
   */
   static  bool  path_line_overlap ( const SPATH * path, const SLine * line )
   {
-     static int32  i ;
-     static SLine sl ;
-     static int32  n ;
+     int32  i ;
+     SLine sl ;
+     int32  n ;
 
      n = path->npts - 1;
 
@@ -228,12 +236,12 @@
     \param ell  pointer to ellipse
     \return relationship as a \link PGS_ELLIPSE_PATH_REL int8 value \endlink (\ref PGS_ELLIPSE_PATH_REL )
   */
-  static int8  path_ellipse_pos ( const SPATH * path, const SELLIPSE * ell )
+  PGS_KERNEL int8  path_ellipse_pos ( const SPATH * path, const SELLIPSE * ell )
   {
-     static int8    pos ;
-     static int32     i ;
-     static SLine    sl ;
-     static int32     n ;
+     int8    pos ;
+     int32     i ;
+     SLine    sl ;
+     int32     n ;
      static const int8 sc_in = ( 1 << PGS_ELLIPSE_CONT_LINE  );
      static const int8 sc_ov = ( 1 << PGS_ELLIPSE_LINE_OVER  );
      static const int8 sc_os = ( 1 << PGS_ELLIPSE_LINE_AVOID );
@@ -242,8 +250,8 @@
      n = path->npts - 1;
 
      if ( FPzero( ell->rad[0] ) ){
-       static bool    pcp;
-       static SPoint  cen;
+       bool    pcp;
+       SPoint  cen;
        sellipse_center( &cen, ell );
        pcp = spath_cont_point ( path, &cen );
        if ( pcp ){
@@ -254,7 +262,7 @@
      }
 
      if ( FPzero( ell->rad[1] ) ){ 
-       static SLine l;
+       SLine l;
        sellipse_line( &l, ell );
 /*!
 \todo implement ellipse contains path if ellipse is a line
@@ -293,10 +301,10 @@
     \param path2 pointer to second path
     \return true, if overlapping
   */
-  static bool path_overlap ( const SPATH * path1, const SPATH * path2 )
+  PGS_KERNEL bool path_overlap ( const SPATH * path1, const SPATH * path2 )
   {
-     static int32     i ;
-     static SLine    sl ;
+     int32     i ;
+     SLine    sl ;
      for ( i=0 ; i<path1->npts; i++ ){
         spath_segment ( &sl , path1 , i );
         if ( path_line_overlap ( path2 , &sl ) ){
@@ -313,12 +321,12 @@
     \param poly pointer to polygon
     \return relationship as a \link PGS_POLY_PATH_REL int8 value \endlink (\ref PGS_POLY_PATH_REL )
   */
-  static int8  path_poly_pos ( const SPATH * path, const SPOLY * poly )
+  PGS_KERNEL int8  path_poly_pos ( const SPATH * path, const SPOLY * poly )
   {
-     static int32     i ;
-     static SLine    sl ;
-     static int8 pos, res;
-     static int32      n ;
+     int32     i ;
+     SLine    sl ;
+     int8 pos, res;
+     int32      n ;
      static const int8 sp_os = ( 1 << PGS_LINE_POLY_AVOID );
      static const int8 sp_ct = ( 1 << PGS_POLY_CONT_LINE  );
      static const int8 sp_ov = ( 1 << PGS_LINE_POLY_OVER  );
@@ -354,7 +362,7 @@
     \return pointer to result point
     \see spath_point ( SPoint * , SPATH *, float8 )
   */
-  static SPoint * spath_get_point ( SPoint * sp , const SPATH * path , int32 i )
+  PGS_KERNEL SPoint * spath_get_point ( SPoint * sp , const SPATH * path , int32 i )
   {
     if ( i >= 0 && i < path->npts ){
       memcpy ( (void*) sp , (void*) &path->p[i]  , sizeof ( SPoint ) );
@@ -372,11 +380,11 @@
     \return pointer to result point
     \see spherepath_point(PG_FUNCTION_ARGS)
   */
-  static SPoint * spath_point ( SPoint * sp , const SPATH * path , float8 f )
+  PGS_KERNEL SPoint * spath_point ( SPoint * sp , const SPATH * path , float8 f )
   {
-      static SLine sl;
+      SLine sl;
       SLine     * slp;
-      static int32  i;
+      int32  i;
       
       i = (int32) floor(f) ;
 
@@ -384,8 +392,8 @@
       if ( ! slp ){
         return NULL;
       } else {
-        static SEuler se;
-        static SPoint tp;
+        SEuler se;
+        SPoint tp;
         
         sphereline_to_euler ( &se, &sl ) ;
         
@@ -409,8 +417,8 @@
   {
     if ( p1->npts == p2->npts ){
 
-      static  int32   i;
-      static  bool  ret;
+      int32   i;
+      bool  ret;
 
       ret = TRUE;
 
@@ -427,10 +435,10 @@
 
   bool spath_cont_point ( const SPATH  * path, const SPoint   * sp )
   {
-    static int32  n;
-    static bool ret;
-    static SLine sl;
-    static int32  i;
+    int32  n;
+    bool ret;
+    SLine sl;
+    int32  i;
     n   = path->npts - 1;
     ret = FALSE;
 
@@ -455,37 +463,104 @@
   }
 
 
+#ifndef PGS_CORE
   Datum  spherepath_in(PG_FUNCTION_ARGS)
   {
     SPATH * path ;
     char  * c  = PG_GETARG_CSTRING(0);
-    static int32  i, nelem;
+    int32  i, nelem;
+    SParseBuffer * pb = sphere_parse ( c );
 
-    void sphere_yyparse( void );
-    init_buffer ( c );
-    sphere_yyparse() ;
-
-    nelem = get_path_count( ) ;
+    nelem = get_path_count( pb ) ;
     if ( nelem > 1 ){
       SPoint arr[nelem];
       for ( i = 0; i<nelem ; i++ ){
-         get_path_elem ( i , &arr[i].lng , &arr[i].lat );
+         get_path_elem ( pb, i , &arr[i].lng , &arr[i].lat );
       }
       path  = spherepath_from_array ( &arr[0], nelem );
     } else {
-      reset_buffer();
       elog ( ERROR , "spherepath_in: more than one point needed" );
       PG_RETURN_NULL();
     }
-    reset_buffer();
+    free_buffer ( pb );
+
+    PG_RETURN_POINTER( path );
+  }
+
+
+  Datum  spherepath_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SPATH   * path ;
+    SPoint   * arr ;
+    int32      i, nelem;
+
+    nelem = pq_getmsgint ( buf, sizeof ( int32 ) );
+    if ( nelem < 0 || nelem > ( buf->len - buf->cursor ) / ( int32 ) ( 2 * sizeof ( float8 ) ) ){
+      elog ( ERROR , "spherepath_recv: invalid number of points" );
+      PG_RETURN_NULL();
+    }
+    arr = ( SPoint * ) MALLOC ( sizeof ( SPoint ) * max ( nelem, 1 ) );
+    for ( i = 0; i<nelem ; i++ ){
+      arr[i].lng = pgs_getmsgfloat8 ( buf );
+      arr[i].lat = pgs_getmsgfloat8 ( buf );
+    }
+    path = spherepath_from_array ( arr, nelem );
+    FREE ( arr );
+
+    PG_RETURN_POINTER( path );
+  }
+
+  Datum  spherepath_send(PG_FUNCTION_ARGS)
+  {
+    SPATH   * path = PG_GETARG_SPATH( 0 ) ;
+    StringInfoData buf;
+    int32      i;
+
+    pq_begintypsend ( &buf );
+    pq_sendint ( &buf, path->npts, sizeof ( int32 ) );
+    for ( i = 0; i<path->npts ; i++ ){
+      spoint_sendmsg ( &buf, &path->p[i] );
+    }
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
+
+  Datum  spherepath_from_arrays(PG_FUNCTION_ARGS)
+  {
+    ArrayType * lng = PG_GETARG_ARRAYTYPE_P ( 0 );
+    ArrayType * lat = PG_GETARG_ARRAYTYPE_P ( 1 );
+    SPATH   * path ;
+    SPoint   * arr ;
+    int32      nelem;
+
+    arr  = spoint_array_from_float8 ( lng, lat, &nelem );
+    path = spherepath_from_array ( arr, nelem );
+    if ( arr ){
+      FREE ( arr );
+    }
+    PG_RETURN_POINTER( path );
+  }
 
+  Datum  spherepath_from_points(PG_FUNCTION_ARGS)
+  {
+    ArrayType * pts = PG_GETARG_ARRAYTYPE_P ( 0 );
+    SPATH   * path ;
+    SPoint   * arr ;
+    int32      nelem;
+
+    arr  = spoint_array_from_spoint ( pts, &nelem );
+    path = spherepath_from_array ( arr, nelem );
+    if ( arr ){
+      FREE ( arr );
+    }
     PG_RETURN_POINTER( path );
   }
 
 
+
   Datum  spherepath_get_point(PG_FUNCTION_ARGS)
   {
-    static int32 i;
+    int32 i;
     SPATH  * path = PG_GETARG_SPATH( 0 ) ;
     SPoint   * sp = ( SPoint * ) MALLOC ( sizeof ( SPoint ) );
     i = PG_GETARG_INT32 ( 1 ) ;
@@ -498,7 +573,7 @@
 
   Datum  spherepath_point(PG_FUNCTION_ARGS)
   {
-    static float8 i;
+    float8 i;
     SPATH  * path = PG_GETARG_SPATH( 0 ) ;
     SPoint   * sp = ( SPoint * ) MALLOC ( sizeof ( SPoint ) );
     i = PG_GETARG_FLOAT8 ( 1 ) ;
@@ -527,10 +602,10 @@
   Datum  spherepath_length(PG_FUNCTION_ARGS)
   {
     SPATH  * path = PG_GETARG_SPATH( 0 ) ;
-    static int32 i;
-    static SLine l;
-    static float8 sum;
-    static int32  n;
+    int32 i;
+    SLine l;
+    float8 sum;
+    int32  n;
     n = path->npts - 1;
     sum = 0.0;
     
@@ -549,8 +624,8 @@
   Datum  spherepath_swap(PG_FUNCTION_ARGS)
   {
     SPATH  * path = PG_GETARG_SPATH( 0 ) ;
-    static int32  i;
-    static int32  n;
+    int32  i;
+    int32  n;
     SPATH * ret    = (SPATH *) MALLOC ( VARSIZE(path) );
     n = path->npts - 1;
     
@@ -823,6 +898,51 @@
    PG_RETURN_DATUM( ret );
   }
 
+  Datum  spherepath_pack(PG_FUNCTION_ARGS)
+  {
+    SPATH   * path = PG_GETARG_SPATH ( 0 ) ;
+    float8    unit = PG_GETARG_FLOAT8 ( 1 ) ;
+    SPACKED * pk;
+    SPATH   * up;
+    int32     i;
+    bool      valid;
+
+    if ( ! ( unit > 0.0 ) || isinf ( unit ) ){
+      elog ( ERROR , "spherepath_pack: precision must be a positive number" );
+    }
+    if ( unit < PGS_PACKED_UNIT_MIN ){
+      elog ( ERROR , "spherepath_pack: precision must be at least %g", PGS_PACKED_UNIT_MIN );
+    }
+    pk = spherepoints_pack ( path->p, path->npts, unit );
+    if ( pk == NULL ){
+      PG_RETURN_POINTER ( path );
+    }
+
+    /* the unpacked path must be valid as the input */
+    up    = ( SPATH * ) spherepoints_unpack ( pk );
+    valid = TRUE;
+    for ( i=1; i<up->npts && valid; i++ ){
+      if ( spoint_eq ( &up->p[i-1], &up->p[i] ) || FPeq ( spoint_dist ( &up->p[i-1], &up->p[i] ), PI ) ){
+        valid = FALSE;
+      }
+    }
+    FREE ( up );
+    if ( ! valid ){
+      FREE ( pk );
+      PG_RETURN_POINTER ( path );
+    }
+    PG_RETURN_POINTER ( pk );
+  }
+
+  Datum  spherepath_unpack(PG_FUNCTION_ARGS)
+  {
+    PG_RETURN_POINTER ( PG_GETARG_SPATH ( 0 ) );
+  }
+#endif
+
+#if PG_VERSION_NUM < 80400
+
+#ifndef PGS_CORE
   Datum  spherepath_add_point(PG_FUNCTION_ARGS)
   {
     SPATH   * path  =  ( SPATH   * ) PG_GETARG_POINTER ( 0 ) ;
@@ -857,11 +977,12 @@
     if ( FPeq ( spoint_dist ( p, &path->p[ path->npts - 1 ]) , PI ) )
     {
       elog ( NOTICE , "spath(spoint): Skip point, distance of previous point is 180deg" );
+      PG_RETURN_POINTER ( path );
     }
 
     size = offsetof(SPATH, p[0]) + sizeof(SPoint) * ( path->npts + 1 );
     path_new = palloc( size );
-    memcpy( (void*) path , (void*) path_new, VARSIZE(path) );
+    memcpy( (void*) path_new , (void*) path, VARSIZE(path) );
     path_new->npts++;
 
 #if PG_VERSION_NUM < 80300
@@ -890,4 +1011,63 @@
     }
     PG_RETURN_POINTER ( path );
   }
+#endif
+
+#else
+
+#ifndef PGS_CORE
+  Datum  spherepath_add_point(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf = ( PG_ARGISNULL ( 0 ) ) ? NULL : ( SPointBuffer * ) PG_GETARG_POINTER ( 0 ) ;
+    SPoint       * p   = ( PG_ARGISNULL ( 1 ) ) ? NULL : ( SPoint * ) PG_GETARG_POINTER ( 1 ) ;
+
+    if ( p == NULL ){
+      if ( buf == NULL ){
+        PG_RETURN_NULL ( );
+      }
+      PG_RETURN_POINTER ( buf );
+    }
+
+    if ( buf != NULL ){
+      // skip if equal
+      if ( spoint_eq ( p, &buf->p[ buf->npts - 1 ] ) ){
+        PG_RETURN_POINTER ( buf );
+      }
+      // Skip if distance is equal 180deg
+      if ( FPeq ( spoint_dist ( p, &buf->p[ buf->npts - 1 ] ) , PI ) )
+      {
+        elog ( NOTICE , "spath(spoint): Skip point, distance of previous point is 180deg" );
+        PG_RETURN_POINTER ( buf );
+      }
+    }
+
+    buf = spoint_buffer_add ( fcinfo, buf, p );
+    PG_RETURN_POINTER ( buf );
+  }
+
+  Datum  spherepath_add_points_finalize(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf = ( PG_ARGISNULL ( 0 ) ) ? NULL : ( SPointBuffer * ) PG_GETARG_POINTER ( 0 ) ;
+    SPATH        * path ;
+    int32          size ;
+
+    if ( buf == NULL ){
+      PG_RETURN_NULL ( );
+    }
+
+    if ( buf->npts < 2 ){
+      elog ( NOTICE , "spath(spoint): At least 2 points required" );
+      PG_RETURN_NULL ( );
+    }
+
+    size = offsetof(SPATH, p[0]) + sizeof(SPoint) * buf->npts ;
+    path = ( SPATH * ) MALLOC ( size );
+    SET_VARSIZE( path, size );
+    path->npts = buf->npts;
+    memcpy( (void*) &path->p[0] , (void*) buf->p, sizeof(SPoint) * buf->npts );
+    PG_RETURN_POINTER ( path );
+  }
+#endif
+
+#endif
 
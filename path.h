@@ -57,7 +57,7 @@ typedef struct
 /*! @} */
 /*! @} */
 
-#define PG_GETARG_SPATH( arg ) ( ( SPATH  * ) DatumGetPointer( PG_DETOAST_DATUM( PG_GETARG_DATUM ( arg ) ) ) )
+#define PG_GETARG_SPATH( arg ) ( ( SPATH  * ) spherepoints_unpack ( DatumGetPointer( PG_DETOAST_DATUM( PG_GETARG_DATUM ( arg ) ) ) ) )
 
   /*!
     \brief Checks, whether two pathes are equal
@@ -92,6 +92,36 @@ typedef struct
   */
   Datum  spherepath_in(PG_FUNCTION_ARGS);
 
+  /*!
+    \brief binary input function of spherical path
+    \return spherical path datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_recv(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief binary output function of spherical path
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_send(PG_FUNCTION_ARGS);
+
+  /*!
+    Creates a spherical path from arrays of longitudes
+    and latitudes both in radians
+    \brief path created from longitude and latitude arrays
+    \return spherical path datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_from_arrays(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief path created from an array of spherical points
+    \return spherical path datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_from_points(PG_FUNCTION_ARGS);
+
   /*!
     \brief Returns the n-th point of a path
     \return point datum
@@ -396,6 +426,22 @@ typedef struct
   */
   Datum  spheretrans_path_inverse(PG_FUNCTION_ARGS);
 
+  /*!
+    The path is returned unchanged, if the packed path is not
+    smaller or if the rounded points do not make a valid path.
+    \brief Packs a path with a precision
+    \return path datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_pack(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Unpacks a path
+    \return path datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_unpack(PG_FUNCTION_ARGS);
+
   /*!
     State transition function for aggregate function spath(spoint).
     Do never call this function outside an aggregate function!
@@ -412,4 +458,22 @@ typedef struct
   */
   Datum  spherepath_add_points_finalize(PG_FUNCTION_ARGS);
 
+#ifdef PGS_CORE
+
+  /*
+    Kernels of path.c, which are static in the extension. See
+    PGS_KERNEL and the documentation of the definitions.
+  */
+  SPATH * spherepath_from_array ( SPoint * arr, int32 nelem );
+  SPATH * euler_spath_trans ( SPATH * out , const SPATH  * in , const SEuler * se );
+  int8  path_circle_pos ( const SPATH * path, const SCIRCLE * circ );
+  int8  path_ellipse_pos ( const SPATH * path, const SELLIPSE * ell );
+  bool  path_overlap ( const SPATH * path1, const SPATH * path2 );
+  int8  path_poly_pos ( const SPATH * path, const SPOLY * poly );
+  SPoint * spath_get_point ( SPoint * sp , const SPATH * path , int32 i );
+  SPoint * spath_point ( SPoint * sp , const SPATH * path , float8 f );
+
+#endif
+
+
 #endif
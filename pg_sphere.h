@@ -55,12 +55,19 @@
 #define min(a,b) ( (a<b)?(a):(b) )          //!< minimum of two values
 #define pgs_abs(a) ((a<0)?(-a):(a))         //!< absolute value
 
+#ifdef PGS_CORE
+
+#include "pgs_core.h"
+
+#else
+
 #include "postgres.h"
 #include "fmgr.h"
 #include "utils/geo_decls.h"
 #include "utils/array.h"
 #include "utils/elog.h"
 #include "utils/builtins.h"
+#include "libpq/pqformat.h"
 #include "catalog/pg_type.h"
 #include "access/skey.h"
 #include "access/gist.h"
@@ -71,15 +78,54 @@
 #include "access/rtree.h"
 #endif
 
+#endif
+
 #ifdef EPSILON
 #undef EPSILON
 #endif
 #define EPSILON  1.0E-09                   //!< Precision of floating point values
 
+/*!
+  Since PostgreSQL 12 utils/geo_decls.h defines the comparisons as
+  inline functions with its own EPSILON of 1.0E-06. They are replaced
+  here, so the extension and the core library compare with the
+  EPSILON above.
+  \addtogroup PGS_FP
+  \brief Comparison of floating point values with precision EPSILON
+  @{
+*/
+#undef FPzero
+#undef FPeq
+#undef FPne
+#undef FPlt
+#undef FPle
+#undef FPgt
+#undef FPge
+#define FPzero( A )    ( fabs ( A ) <= EPSILON )
+#define FPeq( A, B )   ( fabs ( ( A ) - ( B ) ) <= EPSILON )
+#define FPne( A, B )   ( fabs ( ( A ) - ( B ) ) > EPSILON )
+#define FPlt( A, B )   ( ( B ) - ( A ) > EPSILON )
+#define FPle( A, B )   ( ( A ) - ( B ) <= EPSILON )
+#define FPgt( A, B )   ( ( A ) - ( B ) > EPSILON )
+#define FPge( A, B )   ( ( B ) - ( A ) <= EPSILON )
+/* @} */
+
 #define FREE     pfree                     //!< An alias for pfree
 #define MALLOC   palloc                    //!< An alias for palloc
 
 typedef unsigned char uchar;               //!< An alias for unsigned char
 
+/*!
+  The relationship kernels are local to their files in the extension,
+  but visible in the core library, so they can be called by tests and
+  benchmarks.
+  \brief storage class of kernels
+*/
+#ifdef PGS_CORE
+#define PGS_KERNEL
+#else
+#define PGS_KERNEL static
+#endif
+
 
 #endif
@@ -0,0 +1,122 @@
+#include "pg_sphere.h"
+#include "stats.h"
+#include <stdarg.h>
+
+/*!
+  \file
+  \brief Memory and error hooks of the geometry core library
+*/
+
+#ifdef PGS_CORE
+
+uint64 pgs_stat_counter[PGS_STAT_COUNT];
+
+uint64 pgs_stat_gist[PGS_TYPE_SBOX + 1][PGS_STAT_MAX_STRATEGY + 1][PGS_STAT_GIST_COUNT];
+
+/*!
+  \brief current allocation hook
+*/
+static pgs_core_alloc_hook      core_alloc   = NULL;
+
+/*!
+  \brief current reallocation hook
+*/
+static pgs_core_realloc_hook    core_realloc = NULL;
+
+/*!
+  \brief current free hook
+*/
+static pgs_core_free_hook       core_free    = NULL;
+
+/*!
+  \brief current error callback
+*/
+static pgs_core_error_callback  core_error   = NULL;
+
+
+  /*!
+    \brief writes a message to stderr, aborts on errors
+    \param level level of message
+    \param message message text
+  */
+  static void pgs_core_default_error ( int level, const char * message )
+  {
+    fprintf ( stderr, "%s: %s\n", ( level >= ERROR ) ? "ERROR" :
+                                  ( level >= WARNING ) ? "WARNING" :
+                                  ( level >= NOTICE ) ? "NOTICE" : "DEBUG", message );
+    if ( level >= ERROR ){
+      abort ( );
+    }
+  }
+
+
+  void pgs_core_set_allocator ( pgs_core_alloc_hook alloc, pgs_core_realloc_hook realloc,
+                                pgs_core_free_hook free )
+  {
+    core_alloc   = alloc;
+    core_realloc = realloc;
+    core_free    = free;
+  }
+
+
+  void pgs_core_set_error_callback ( pgs_core_error_callback cb )
+  {
+    core_error = cb;
+  }
+
+
+  void * pgs_core_alloc ( size_t size )
+  {
+    void * p = core_alloc ? core_alloc ( size ) : malloc ( size ? size : 1 );
+    if ( p == NULL ){
+      pgs_core_elog ( ERROR, "out of memory" );
+    }
+    return p;
+  }
+
+
+  void * pgs_core_alloc0 ( size_t size )
+  {
+    void * p = pgs_core_alloc ( size );
+    memset ( p, 0, size );
+    return p;
+  }
+
+
+  void * pgs_core_realloc ( void * ptr, size_t size )
+  {
+    void * p = core_realloc ? core_realloc ( ptr, size ) : realloc ( ptr, size ? size : 1 );
+    if ( p == NULL ){
+      pgs_core_elog ( ERROR, "out of memory" );
+    }
+    return p;
+  }
+
+
+  void pgs_core_free ( void * ptr )
+  {
+    if ( core_free ){
+      core_free ( ptr );
+    } else {
+      free ( ptr );
+    }
+  }
+
+
+  void pgs_core_elog ( int level, const char * fmt, ... )
+  {
+    char     msg[1024];
+    va_list  ap;
+
+    va_start ( ap, fmt );
+    vsnprintf ( msg, sizeof ( msg ), fmt, ap );
+    va_end ( ap );
+
+    ( core_error ? core_error : pgs_core_default_error ) ( level, msg );
+    if ( level >= ERROR ){
+      // the callback must not return on errors
+      abort ( );
+    }
+  }
+
+#endif
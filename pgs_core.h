@@ -0,0 +1,165 @@
+#ifndef __PGS_CORE_H__
+#define __PGS_CORE_H__
+
+/*!
+  \file
+  \brief Declarations of the geometry core library
+
+  The geometry functions can be compiled without PostgreSQL, if
+  PGS_CORE is defined. This header replaces the PostgreSQL headers
+  then: it defines the basic types and macros used by the geometry
+  functions, and maps memory allocation and error reporting to hooks,
+  which an application can set. The PostgreSQL functions are not
+  compiled into the core library.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int8_t       int8;               //!< signed 1 byte integer
+typedef int16_t      int16;              //!< signed 2 byte integer
+typedef int32_t      int32;              //!< signed 4 byte integer
+typedef int64_t      int64;              //!< signed 8 byte integer
+typedef uint8_t      uint8;              //!< unsigned 1 byte integer
+typedef uint16_t     uint16;             //!< unsigned 2 byte integer
+typedef uint32_t     uint32;             //!< unsigned 4 byte integer
+typedef uint64_t     uint64;             //!< unsigned 8 byte integer
+typedef float        float4;             //!< 4 byte floating point value
+typedef double       float8;             //!< 8 byte floating point value
+typedef size_t       Size;               //!< size of memory
+typedef uintptr_t    Datum;              //!< value passed to PostgreSQL functions
+typedef unsigned int Oid;                //!< object id
+
+#ifndef TRUE
+#define TRUE  1                          //!< boolean true
+#endif
+#ifndef FALSE
+#define FALSE 0                          //!< boolean false
+#endif
+
+#define Max(x, y)  ( ( x ) > ( y ) ? ( x ) : ( y ) )  //!< maximum of two values
+#define Min(x, y)  ( ( x ) < ( y ) ? ( x ) : ( y ) )  //!< minimum of two values
+
+/*!
+  \addtogroup PGS_CORE_VARLENA
+  \brief Variable length values, the first 4 bytes hold the size
+  @{
+*/
+#define VARHDRSZ              ( ( int32 ) sizeof ( int32 ) )
+#define VARSIZE( p )          ( * ( const int32 * ) ( p ) )
+#define SET_VARSIZE( p, len ) ( * ( int32 * ) ( p ) = ( int32 ) ( len ) )
+/* @} */
+
+/*!
+  \addtogroup PGS_CORE_ELOG
+  \brief Levels of error reports
+  @{
+*/
+#define DEBUG1   14
+#define LOG      15
+#define NOTICE   18
+#define WARNING  19
+#define ERROR    21
+/* @} */
+
+/*!
+  Only the declarations of the PostgreSQL functions are seen by the
+  core library, their arguments do not need to be complete types.
+  \brief opaque PostgreSQL types used in declarations
+*/
+typedef struct FunctionCallInfoBaseData * FunctionCallInfo;
+typedef struct ArrayType ArrayType;
+typedef struct StringInfoData * StringInfo;
+#define PG_FUNCTION_ARGS  FunctionCallInfo fcinfo
+#define PG_FUNCTION_INFO_V1( f )  extern int pgs_core_no_finfo_##f
+
+/*!
+  \brief allocates memory, must not return NULL
+*/
+typedef void * ( * pgs_core_alloc_hook ) ( size_t size );
+
+/*!
+  \brief resizes allocated memory, must not return NULL
+*/
+typedef void * ( * pgs_core_realloc_hook ) ( void * ptr, size_t size );
+
+/*!
+  \brief frees allocated memory
+*/
+typedef void ( * pgs_core_free_hook ) ( void * ptr );
+
+/*!
+  The callback gets messages of all levels. If the level is ERROR,
+  the callback must not return, for instance by calling longjmp.
+  If it returns anyway, the program is aborted.
+  \brief handles an error report
+*/
+typedef void ( * pgs_core_error_callback ) ( int level, const char * message );
+
+  /*!
+    Sets the memory functions of the core library. NULL values select
+    malloc, realloc and free. The default allocation aborts the program,
+    if no memory is left.
+    \brief sets the memory functions
+    \param alloc   allocation function
+    \param realloc reallocation function
+    \param free    function to free memory
+  */
+  void pgs_core_set_allocator ( pgs_core_alloc_hook alloc, pgs_core_realloc_hook realloc,
+                                pgs_core_free_hook free );
+
+  /*!
+    The default callback writes the message to stderr and aborts the
+    program on errors.
+    \brief sets the error callback
+    \param cb callback, NULL selects the default
+  */
+  void pgs_core_set_error_callback ( pgs_core_error_callback cb );
+
+  /*!
+    \brief allocates memory using the allocation hook
+    \param size size in bytes
+    \return pointer to memory
+  */
+  void * pgs_core_alloc ( size_t size );
+
+  /*!
+    \brief allocates zeroed memory using the allocation hook
+    \param size size in bytes
+    \return pointer to memory
+  */
+  void * pgs_core_alloc0 ( size_t size );
+
+  /*!
+    \brief resizes memory using the reallocation hook
+    \param ptr  pointer to memory
+    \param size new size in bytes
+    \return pointer to memory
+  */
+  void * pgs_core_realloc ( void * ptr, size_t size );
+
+  /*!
+    \brief frees memory using the free hook
+    \param ptr pointer to memory
+  */
+  void pgs_core_free ( void * ptr );
+
+  /*!
+    \brief formats a message and passes it to the error callback
+    \param level \link PGS_CORE_ELOG level \endlink of message
+    \param fmt   printf format
+  */
+  void pgs_core_elog ( int level, const char * fmt, ... )
+#ifdef __GNUC__
+    __attribute__ ( ( format ( printf, 2, 3 ) ) )
+#endif
+    ;
+
+#define palloc( s )       pgs_core_alloc ( s )         //!< allocation of the core library
+#define palloc0( s )      pgs_core_alloc0 ( s )        //!< zeroed allocation of the core library
+#define repalloc( p, s )  pgs_core_realloc ( p, s )    //!< reallocation of the core library
+#define pfree( p )        pgs_core_free ( p )          //!< free of the core library
+#define elog              pgs_core_elog                //!< error report of the core library
+
+#endif
@@ -1,4 +1,10 @@
 #include "point.h"
+#ifndef PGS_CORE
+#include "utils/lsyscache.h"
+#if PG_VERSION_NUM >= 80400 && PG_VERSION_NUM < 90000
+#include "nodes/execnodes.h"
+#endif
+#endif
 
 /*!        
   \file
@@ -11,8 +17,13 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
  PG_FUNCTION_INFO_V1(spherepoint_in);
+ PG_FUNCTION_INFO_V1(spherepoint_recv);
+ PG_FUNCTION_INFO_V1(spherepoint_send);
  PG_FUNCTION_INFO_V1(spherepoint_from_long_lat);
+ PG_FUNCTION_INFO_V1(spherepoint_from_arrays);
  PG_FUNCTION_INFO_V1(spherepoint_distance);
+ PG_FUNCTION_INFO_V1(spherepoint_distance_array);
+ PG_FUNCTION_INFO_V1(spherepoint_dwithin);
  PG_FUNCTION_INFO_V1(spherepoint_long);
  PG_FUNCTION_INFO_V1(spherepoint_lat);
  PG_FUNCTION_INFO_V1(spherepoint_x);
@@ -20,6 +31,15 @@
  PG_FUNCTION_INFO_V1(spherepoint_z);
  PG_FUNCTION_INFO_V1(spherepoint_xyz);
  PG_FUNCTION_INFO_V1(spherepoint_equal);
+ PG_FUNCTION_INFO_V1(spherepoint_centroid_add);
+ PG_FUNCTION_INFO_V1(spherepoint_centroid_combine);
+ PG_FUNCTION_INFO_V1(spherepoint_centroid_serialize);
+ PG_FUNCTION_INFO_V1(spherepoint_centroid_deserialize);
+ PG_FUNCTION_INFO_V1(spherepoint_centroid_finalize);
+ PG_FUNCTION_INFO_V1(spherepoint_collect_add);
+ PG_FUNCTION_INFO_V1(spherepoint_collect_combine);
+ PG_FUNCTION_INFO_V1(spherepoint_collect_serialize);
+ PG_FUNCTION_INFO_V1(spherepoint_collect_deserialize);
 
 #endif
 
@@ -32,9 +52,51 @@
   }
 
 
+#if PG_VERSION_NUM >= 80400
+
+  MemoryContext pgs_agg_context ( FunctionCallInfo fcinfo, const char * fname )
+  {
+    MemoryContext aggctx;
+
+#if PG_VERSION_NUM >= 90000
+    if ( ! AggCheckCallContext ( fcinfo, &aggctx ) )
+#else
+    if ( fcinfo->context && IsA ( fcinfo->context, AggState ) ){
+      aggctx = ( ( AggState * ) fcinfo->context )->aggcontext;
+    } else
+#endif
+    {
+      elog ( ERROR , "%s: called in non-aggregate context", fname );
+      return NULL;
+    }
+    return aggctx;
+  }
+
+
+  SPointBuffer * spoint_buffer_add ( FunctionCallInfo fcinfo, SPointBuffer * buf, const SPoint * p )
+  {
+    if ( buf == NULL ){
+      MemoryContext aggctx = pgs_agg_context ( fcinfo, "spoint_buffer_add" );
+
+      buf         = ( SPointBuffer * ) MemoryContextAlloc ( aggctx, sizeof ( SPointBuffer ) );
+      buf->npts   = 0;
+      buf->maxpts = 64;
+      buf->p      = ( SPoint * ) MemoryContextAlloc ( aggctx, sizeof ( SPoint ) * buf->maxpts );
+    } else if ( buf->npts == buf->maxpts ){
+      buf->maxpts *= 2;
+      buf->p       = ( SPoint * ) repalloc ( buf->p, sizeof ( SPoint ) * buf->maxpts );
+    }
+    memcpy ( (void*) &buf->p[buf->npts], (void*) p, sizeof ( SPoint ) );
+    buf->npts++;
+    return buf;
+  }
+
+#endif
+
+
   SPoint *  spoint_check (SPoint * spoint)
   {
-    static bool lat_is_neg;
+    bool lat_is_neg;
     lat_is_neg = ( spoint->lat < 0 )?( TRUE ):( FALSE );
 
     spoint->lng  = spoint->lng - floor(spoint->lng / ( PID ) )  * PID;
@@ -71,6 +133,149 @@
   }
 
 
+/*!
+  \brief unit of longitude of compact spherical point in radians
+*/
+#define SPOINT4_LNG_UNIT  ( PID / 4294967296.0 )
+
+/*!
+  \brief unit of latitude of compact spherical point in radians
+*/
+#define SPOINT4_LAT_UNIT  ( PIH / 2147483647.0 )
+
+  SPoint * spoint4_to_spoint ( SPoint * p , const SPoint4 * p4 )
+  {
+    p->lng = ( float8 ) ( ( uint32 ) p4->lng ) * SPOINT4_LNG_UNIT;
+    p->lat = ( float8 ) p4->lat * SPOINT4_LAT_UNIT;
+    return p;
+  }
+
+  SPoint4 * spoint_to_spoint4 ( SPoint4 * p4 , const SPoint * p )
+  {
+    /* the longitude wraps around at 2*pi */
+    p4->lng = ( int32 ) ( uint32 ) fmod ( floor ( p->lng / SPOINT4_LNG_UNIT + 0.5 ), 4294967296.0 );
+    p4->lat = ( int32 ) floor ( p->lat / SPOINT4_LAT_UNIT + 0.5 );
+    if ( p4->lat == 2147483647 || p4->lat == -2147483647 ){
+      /* the longitude of the poles is 0 */
+      p4->lng = 0;
+    }
+    return p4;
+  }
+
+
+#ifndef PGS_CORE
+  float8  pgs_getmsgfloat8 ( StringInfo buf )
+  {
+    float8 f = pq_getmsgfloat8 ( buf );
+    if ( isnan ( f ) || isinf ( f ) ){
+      elog ( ERROR , "pgs_getmsgfloat8: invalid floating point value" );
+    }
+    return f;
+  }
+
+
+  SPoint *  spoint_getmsg ( SPoint * p, StringInfo buf )
+  {
+    p->lng = pgs_getmsgfloat8 ( buf );
+    p->lat = pgs_getmsgfloat8 ( buf );
+    return spoint_check ( p );
+  }
+
+
+  void  spoint_sendmsg ( StringInfo buf, const SPoint * p )
+  {
+    pq_sendfloat8 ( buf, p->lng );
+    pq_sendfloat8 ( buf, p->lat );
+  }
+
+  /*!
+    \brief checks that an array has one dimension and no NULL values
+    \param arr   the array
+    \param fname function name for error messages
+    \return count of elements
+  */
+  static int32 spoint_array_check ( ArrayType * arr, const char * fname )
+  {
+    int32 n = ArrayGetNItems ( ARR_NDIM ( arr ), ARR_DIMS ( arr ) );
+    if ( n > 0 && ARR_NDIM ( arr ) != 1 ){
+      elog ( ERROR , "%s: array must be one-dimensional", fname );
+    }
+#if PG_VERSION_NUM >= 80200
+    if ( ARR_HASNULL ( arr ) ){
+      elog ( ERROR , "%s: array must not contain NULL values", fname );
+    }
+#endif
+    return n;
+  }
+
+
+  SPoint *  spoint_array_from_float8 ( ArrayType * lng, ArrayType * lat, int32 * nelem )
+  {
+    SPoint  * arr = NULL;
+    float8  * x, * y;
+    int32     i, n;
+
+    if ( ARR_ELEMTYPE ( lng ) != FLOAT8OID || ARR_ELEMTYPE ( lat ) != FLOAT8OID ){
+      elog ( ERROR , "spoint_array_from_float8: float8 arrays expected" );
+    }
+    n = spoint_array_check ( lng, "spoint_array_from_float8" );
+    if ( spoint_array_check ( lat, "spoint_array_from_float8" ) != n ){
+      elog ( ERROR , "spoint_array_from_float8: arrays of longitudes and latitudes must have the same length" );
+    }
+    if ( n > 0 ){
+      x   = ( float8 * ) ARR_DATA_PTR ( lng );
+      y   = ( float8 * ) ARR_DATA_PTR ( lat );
+      arr = ( SPoint * ) MALLOC ( sizeof ( SPoint ) * n );
+      for ( i = 0; i < n; i++ ){
+        if ( isnan ( x[i] ) || isinf ( x[i] ) || isnan ( y[i] ) || isinf ( y[i] ) ){
+          elog ( ERROR , "spoint_array_from_float8: invalid floating point value" );
+        }
+        arr[i].lng = x[i];
+        arr[i].lat = y[i];
+      }
+    }
+    *nelem = n;
+    return arr;
+  }
+
+
+  SPoint *  spoint_array_from_spoint ( ArrayType * arr, int32 * nelem )
+  {
+    SPoint  * p = NULL;
+    int32     n = spoint_array_check ( arr, "spoint_array_from_spoint" );
+
+    if ( n > 0 ){
+      p = ( SPoint * ) MALLOC ( sizeof ( SPoint ) * n );
+      memcpy ( (void*) p, (void*) ARR_DATA_PTR ( arr ), sizeof ( SPoint ) * n );
+    }
+    *nelem = n;
+    return p;
+  }
+
+
+  float8 *  spoint_array_vectors ( ArrayType * arr, int32 * nelem )
+  {
+    float8  * v = NULL;
+    SPoint  * p;
+    int32     i, n = spoint_array_check ( arr, "spoint_array_vectors" );
+
+    if ( n > 0 ){
+      p = ( SPoint * ) ARR_DATA_PTR ( arr );
+      v = ( float8 * ) MALLOC ( sizeof ( float8 ) * 3 * n );
+      for ( i = 0; i < n; i++ ){
+        float8 cl = cos ( p[i].lat );
+        v[i      ] = cos ( p[i].lng ) * cl;
+        v[i + n  ] = sin ( p[i].lng ) * cl;
+        v[i + 2*n] = sin ( p[i].lat );
+      }
+    }
+    *nelem = n;
+    return v;
+  }
+#endif
+
+
+
   SPoint * vector3d_spoint ( SPoint * p , const Vector3D * v )
   {
 
@@ -105,29 +310,53 @@
     return ( v ) ;
   }
 
+#ifndef PGS_CORE
   Datum  spherepoint_in(PG_FUNCTION_ARGS)
   {
     SPoint  * sp  = ( SPoint * ) MALLOC ( sizeof ( SPoint ) ) ;
     char    *  c  = PG_GETARG_CSTRING(0);
     double lng, lat;
+    SParseBuffer * pb ;
+
+    // plain "(lng,lat)" input does not need the parser
+    if ( parse_fast_point ( c, &lng, &lat ) ){
+      sp->lng       = lng;
+      sp->lat       = lat;
+      spoint_check ( sp );
+      PG_RETURN_POINTER( sp );
+    }
 
-    void sphere_yyparse( void );
-    init_buffer ( c );
-    sphere_yyparse();
-    if ( get_point( &lng, &lat ) ){
+    pb = sphere_parse ( c );
+    if ( get_point( pb, &lng, &lat ) ){
       sp->lng       = lng;
       sp->lat       = lat;
       spoint_check ( sp );
     } else {
-      reset_buffer();
       FREE( sp );
       sp = NULL;
       elog ( ERROR , "spherepoint_in: parse error" );
     }
-    reset_buffer();
+    free_buffer ( pb );
+    PG_RETURN_POINTER( sp );
+  }
+
+
+  Datum  spherepoint_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SPoint   * sp  = ( SPoint * ) MALLOC ( sizeof ( SPoint ) ) ;
+    spoint_getmsg ( sp, buf );
     PG_RETURN_POINTER( sp );
   }
 
+  Datum  spherepoint_send(PG_FUNCTION_ARGS)
+  {
+    SPoint  * sp = ( SPoint * ) PG_GETARG_POINTER( 0 ) ;
+    StringInfoData buf;
+    pq_begintypsend ( &buf );
+    spoint_sendmsg ( &buf, sp );
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
 
   Datum  spherepoint_from_long_lat(PG_FUNCTION_ARGS)
   {
@@ -138,6 +367,40 @@
     PG_RETURN_POINTER( p );
   }
 
+  Datum  spherepoint_from_arrays(PG_FUNCTION_ARGS)
+  {
+    ArrayType * lng = PG_GETARG_ARRAYTYPE_P ( 0 );
+    ArrayType * lat = PG_GETARG_ARRAYTYPE_P ( 1 );
+    Oid         elemtype;
+    int16       typlen;
+    bool        typbyval;
+    char        typalign;
+    Datum     * elems;
+    SPoint    * arr;
+    int32       i, nelem;
+    ArrayType * result;
+
+    arr      = spoint_array_from_float8 ( lng, lat, &nelem );
+    elemtype = get_element_type ( get_fn_expr_rettype ( fcinfo->flinfo ) );
+    if ( ! OidIsValid ( elemtype ) ){
+      elog ( ERROR , "spherepoint_from_arrays: could not determine element type" );
+    }
+    if ( nelem == 0 ){
+      PG_RETURN_ARRAYTYPE_P ( construct_empty_array ( elemtype ) );
+    }
+    get_typlenbyvalalign ( elemtype, &typlen, &typbyval, &typalign );
+    elems = ( Datum * ) MALLOC ( sizeof ( Datum ) * nelem );
+    for ( i = 0; i < nelem; i++ ){
+      spoint_check ( &arr[i] );
+      elems[i] = PointerGetDatum ( &arr[i] );
+    }
+    result = construct_array ( elems, nelem, elemtype, typlen, typbyval, typalign );
+    FREE ( elems );
+    FREE ( arr );
+    PG_RETURN_ARRAYTYPE_P ( result );
+  }
+#endif
+
   float8 spoint_dist ( const SPoint * p1, const SPoint * p2 )
   {
 	float8 dl = p1->lng - p2->lng;
@@ -159,6 +422,7 @@
     }
   }
 
+#ifndef PGS_CORE
   Datum spherepoint_distance(PG_FUNCTION_ARGS) 
   {
 
@@ -168,6 +432,51 @@
 
   }
 
+  Datum spherepoint_dwithin(PG_FUNCTION_ARGS)
+  {
+    SPoint  * p1 = ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
+    SPoint  * p2 = ( SPoint * ) PG_GETARG_POINTER ( 1 ) ;
+    float8    r  = PG_GETARG_FLOAT8 ( 2 ) ;
+    PG_RETURN_BOOL ( FPle ( spoint_dist ( p1, p2 ), r ) );
+  }
+
+  Datum spherepoint_distance_array(PG_FUNCTION_ARGS)
+  {
+    SPoint    * p   = ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
+    ArrayType * arr = PG_GETARG_ARRAYTYPE_P ( 1 );
+    float8    * v;
+    Datum     * elems;
+    Vector3D    c, e, x;
+    int32       i, n;
+    int16       typlen;
+    bool        typbyval;
+    char        typalign;
+    ArrayType * result;
+
+    v = spoint_array_vectors ( arr, &n );
+    if ( n == 0 ){
+      PG_RETURN_ARRAYTYPE_P ( construct_empty_array ( FLOAT8OID ) );
+    }
+    spoint_vector3d ( &c, p );
+
+    // atan2 is exact for small and large distances, like spoint3
+    elems = ( Datum * ) MALLOC ( sizeof ( Datum ) * n );
+    for ( i = 0; i < n; i++ ){
+      float8 a;
+      e.x = v[i];
+      e.y = v[n + i];
+      e.z = v[2*n + i];
+      vector3d_cross ( &x, &c, &e );
+      a = atan2 ( vector3d_length ( &x ), vector3d_scalar ( &c, &e ) );
+      elems[i] = Float8GetDatum ( FPzero ( a ) ? 0.0 : a );
+    }
+    get_typlenbyvalalign ( FLOAT8OID, &typlen, &typbyval, &typalign );
+    result = construct_array ( elems, n, FLOAT8OID, typlen, typbyval, typalign );
+    FREE ( elems );
+    FREE ( v );
+    PG_RETURN_ARRAYTYPE_P ( result );
+  }
+
   Datum  spherepoint_long(PG_FUNCTION_ARGS)
   {
     SPoint  * p =  ( SPoint * )  PG_GETARG_POINTER ( 0 ) ;
@@ -183,7 +492,7 @@
   Datum  spherepoint_x(PG_FUNCTION_ARGS)
   {
     SPoint  * p =  ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
-    static Vector3D  v ;
+    Vector3D  v ;
     spoint_vector3d ( &v , p );    
     PG_RETURN_FLOAT8 ( v.x   ); 
   }
@@ -191,7 +500,7 @@
   Datum  spherepoint_y(PG_FUNCTION_ARGS)
   {
     SPoint  * p =  ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
-    static Vector3D  v ;
+    Vector3D  v ;
     spoint_vector3d ( &v , p );    
     PG_RETURN_FLOAT8 ( v.y   ); 
   }
@@ -199,7 +508,7 @@
   Datum  spherepoint_z(PG_FUNCTION_ARGS)
   {
     SPoint  * p =  ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
-    static Vector3D  v ;
+    Vector3D  v ;
     spoint_vector3d ( &v , p );    
     PG_RETURN_FLOAT8 ( v.z   ); 
   }
@@ -209,7 +518,7 @@
     SPoint  * p =  ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
     Datum    dret[3];
     ArrayType  *result;
-    static Vector3D  v ;
+    Vector3D  v ;
     spoint_vector3d ( &v , p );    
     dret[0] = Float8GetDatumFast(v.x);
     dret[1] = Float8GetDatumFast(v.y);
@@ -224,4 +533,186 @@
     SPoint  * p2 =  ( SPoint * )  PG_GETARG_POINTER ( 1 ) ;
     PG_RETURN_BOOL( spoint_eq ( p1 , p2 ) );
   }
+#endif
+
+
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    \brief The transition state of the centroid aggregate
+  */
+  typedef struct {
+    Vector3D  sum;     //!< sum of unit vectors of points
+    int64     n;       //!< count of points
+  } SPointCentroid;
+
+  /*!
+    \brief returns the centroid state, creates it if it does not exist
+  */
+  static SPointCentroid * spoint_centroid_state ( FunctionCallInfo fcinfo, int arg, const char * fname )
+  {
+    SPointCentroid * c;
+
+    if ( ! PG_ARGISNULL ( arg ) ){
+      return ( SPointCentroid * ) PG_GETARG_POINTER ( arg );
+    }
+    c = ( SPointCentroid * ) MemoryContextAllocZero ( pgs_agg_context ( fcinfo, fname ), sizeof ( SPointCentroid ) );
+    return c;
+  }
+
+
+#ifndef PGS_CORE
+  Datum  spherepoint_centroid_add(PG_FUNCTION_ARGS)
+  {
+    SPointCentroid * c = spoint_centroid_state ( fcinfo, 0, "spherepoint_centroid_add" );
+    Vector3D         v;
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      spoint_vector3d ( &v, ( SPoint * ) PG_GETARG_POINTER ( 1 ) );
+      c->sum.x += v.x;
+      c->sum.y += v.y;
+      c->sum.z += v.z;
+      c->n++;
+    }
+    PG_RETURN_POINTER ( c );
+  }
 
+
+  Datum  spherepoint_centroid_combine(PG_FUNCTION_ARGS)
+  {
+    SPointCentroid * c = spoint_centroid_state ( fcinfo, 0, "spherepoint_centroid_combine" );
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      SPointCentroid * c2 = ( SPointCentroid * ) PG_GETARG_POINTER ( 1 );
+      c->sum.x += c2->sum.x;
+      c->sum.y += c2->sum.y;
+      c->sum.z += c2->sum.z;
+      c->n     += c2->n;
+    }
+    PG_RETURN_POINTER ( c );
+  }
+
+
+  Datum  spherepoint_centroid_serialize(PG_FUNCTION_ARGS)
+  {
+    SPointCentroid * c = ( SPointCentroid * ) PG_GETARG_POINTER ( 0 );
+    StringInfoData   buf;
+
+    pq_begintypsend ( &buf );
+    pq_sendfloat8 ( &buf, c->sum.x );
+    pq_sendfloat8 ( &buf, c->sum.y );
+    pq_sendfloat8 ( &buf, c->sum.z );
+    pq_sendint64  ( &buf, c->n );
+    PG_RETURN_BYTEA_P ( pq_endtypsend ( &buf ) );
+  }
+
+
+  Datum  spherepoint_centroid_deserialize(PG_FUNCTION_ARGS)
+  {
+    bytea          * b = PG_GETARG_BYTEA_P ( 0 );
+    SPointCentroid * c = ( SPointCentroid * ) palloc ( sizeof ( SPointCentroid ) );
+    StringInfoData   buf;
+
+    buf.data   = VARDATA ( b );
+    buf.len    = VARSIZE ( b ) - VARHDRSZ;
+    buf.maxlen = buf.len;
+    buf.cursor = 0;
+    c->sum.x = pq_getmsgfloat8 ( &buf );
+    c->sum.y = pq_getmsgfloat8 ( &buf );
+    c->sum.z = pq_getmsgfloat8 ( &buf );
+    c->n     = pq_getmsgint64  ( &buf );
+    pq_getmsgend ( &buf );
+    PG_RETURN_POINTER ( c );
+  }
+
+
+  Datum  spherepoint_centroid_finalize(PG_FUNCTION_ARGS)
+  {
+    SPointCentroid * c = ( SPointCentroid * ) PG_GETARG_POINTER ( 0 );
+    SPoint         * p;
+
+    // no points or points cancel out each other, e.g. two antipodes
+    if ( c->n == 0 || vector3d_length ( &c->sum ) <= EPSILON * c->n ){
+      PG_RETURN_NULL ( );
+    }
+    p = ( SPoint * ) MALLOC ( sizeof ( SPoint ) );
+    vector3d_spoint ( p, &c->sum );
+    PG_RETURN_POINTER ( p );
+  }
+
+
+  Datum  spherepoint_collect_add(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf = ( PG_ARGISNULL ( 0 ) ) ? NULL : ( SPointBuffer * ) PG_GETARG_POINTER ( 0 ) ;
+
+    if ( ! PG_ARGISNULL ( 1 ) ){
+      buf = spoint_buffer_add ( fcinfo, buf, ( SPoint * ) PG_GETARG_POINTER ( 1 ) );
+    }
+    if ( buf == NULL ){
+      PG_RETURN_NULL ( );
+    }
+    PG_RETURN_POINTER ( buf );
+  }
+
+
+  Datum  spherepoint_collect_combine(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf  = ( PG_ARGISNULL ( 0 ) ) ? NULL : ( SPointBuffer * ) PG_GETARG_POINTER ( 0 ) ;
+    SPointBuffer * buf2 = ( PG_ARGISNULL ( 1 ) ) ? NULL : ( SPointBuffer * ) PG_GETARG_POINTER ( 1 ) ;
+    int32          i;
+
+    if ( buf2 != NULL ){
+      for ( i=0; i<buf2->npts; i++ ){
+        buf = spoint_buffer_add ( fcinfo, buf, &buf2->p[i] );
+      }
+    }
+    if ( buf == NULL ){
+      PG_RETURN_NULL ( );
+    }
+    PG_RETURN_POINTER ( buf );
+  }
+
+
+  Datum  spherepoint_collect_serialize(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf = ( SPointBuffer * ) PG_GETARG_POINTER ( 0 );
+    StringInfoData s;
+    int32          i;
+
+    pq_begintypsend ( &s );
+    pq_sendint ( &s, buf->npts, sizeof ( int32 ) );
+    for ( i=0; i<buf->npts; i++ ){
+      pq_sendfloat8 ( &s, buf->p[i].lng );
+      pq_sendfloat8 ( &s, buf->p[i].lat );
+    }
+    PG_RETURN_BYTEA_P ( pq_endtypsend ( &s ) );
+  }
+
+
+  Datum  spherepoint_collect_deserialize(PG_FUNCTION_ARGS)
+  {
+    bytea        * b   = PG_GETARG_BYTEA_P ( 0 );
+    SPointBuffer * buf = ( SPointBuffer * ) palloc ( sizeof ( SPointBuffer ) );
+    StringInfoData s;
+    int32          i;
+
+    s.data   = VARDATA ( b );
+    s.len    = VARSIZE ( b ) - VARHDRSZ;
+    s.maxlen = s.len;
+    s.cursor = 0;
+    buf->npts = pq_getmsgint ( &s, sizeof ( int32 ) );
+    if ( buf->npts < 0 || buf->npts > ( int32 ) ( ( s.len - s.cursor ) / ( 2 * sizeof ( float8 ) ) ) ){
+      elog ( ERROR , "spherepoint_collect_deserialize: invalid count of points" );
+    }
+    buf->maxpts = ( buf->npts > 0 ) ? buf->npts : 1;
+    buf->p      = ( SPoint * ) palloc ( sizeof ( SPoint ) * buf->maxpts );
+    for ( i=0; i<buf->npts; i++ ){
+      buf->p[i].lng = pq_getmsgfloat8 ( &s );
+      buf->p[i].lat = pq_getmsgfloat8 ( &s );
+    }
+    pq_getmsgend ( &s );
+    PG_RETURN_POINTER ( buf );
+  }
+#endif
+
+#endif
@@ -19,6 +19,18 @@
    float8 lat;  //!< latitude value in radians
   }  SPoint;
 
+/*!
+  The compact spherical point stores longitude and latitude as fixed
+  point values. The unit of the longitude is 2*pi/2^32, the one of the
+  latitude is (pi/2)/(2^31-1), so the position of a spherical point
+  is kept with an error up to 0.15 milli arc seconds in 8 bytes.
+  \brief Compact spherical point
+*/
+  typedef struct {
+   int32 lng;   //!< longitude value, unsigned in units of 2*pi/2^32
+   int32 lat;   //!< latitude value in units of (pi/2)/(2^31-1)
+  }  SPoint4;
+
   /*!
     Calculate the distance of two spherical points
     \brief Distance of two spherical points
@@ -44,6 +56,83 @@
   */
   SPoint *  spoint_check (SPoint * spoint);
 
+  /*!
+    \brief converts a compact spherical point to a spherical point
+    \param p  pointer to result
+    \param p4 pointer to compact point
+    \return pointer to result
+  */
+  SPoint * spoint4_to_spoint ( SPoint * p , const SPoint4 * p4 );
+
+  /*!
+    Rounds the longitude and latitude of a valid spherical point to
+    the nearest fixed point values.
+    \brief converts a spherical point to a compact spherical point
+    \param p4 pointer to result
+    \param p  pointer to spherical point
+    \return pointer to result
+  */
+  SPoint4 * spoint_to_spoint4 ( SPoint4 * p4 , const SPoint * p );
+
+  /*!
+    Reads a float8 value of the binary representation of
+    a spherical type and rejects NaN and infinite values.
+    \brief reads a finite float8 value from a message buffer
+    \param buf message buffer
+    \return float8 value
+  */
+  float8  pgs_getmsgfloat8 ( StringInfo buf );
+
+  /*!
+    Reads longitude and latitude from a message buffer
+    and validates the point like the text input does.
+    \brief reads a spherical point from a message buffer
+    \param p   pointer to spherical point
+    \param buf message buffer
+    \return pointer to spherical point
+  */
+  SPoint *  spoint_getmsg ( SPoint * p, StringInfo buf );
+
+  /*!
+    \brief writes a spherical point to a message buffer
+    \param buf message buffer
+    \param p   pointer to spherical point
+  */
+  void  spoint_sendmsg ( StringInfo buf, const SPoint * p );
+
+  /*!
+    Reads spherical points from arrays of longitudes and latitudes,
+    both in radians. The arrays must have one dimension, the same
+    length and no NULL or non-finite values. The points are not
+    validated by spoint_check.
+    \brief reads spherical points from two float8 arrays
+    \param lng   array of longitudes
+    \param lat   array of latitudes
+    \param nelem pointer to count of points
+    \return palloc'd array of points, or NULL if the arrays are empty
+  */
+  SPoint *  spoint_array_from_float8 ( ArrayType * lng, ArrayType * lat, int32 * nelem );
+
+  /*!
+    \brief copies the points of a spoint array
+    \param arr   array of spherical points with one dimension and no NULL values
+    \param nelem pointer to count of points
+    \return palloc'd array of points, or NULL if the array is empty
+  */
+  SPoint *  spoint_array_from_spoint ( ArrayType * arr, int32 * nelem );
+
+  /*!
+    Converts the points of a spoint array to unit vectors. The
+    coordinates are stored in one block: first all x values, then
+    all y values and then all z values, as vector3d_dist2_batch
+    expects them.
+    \brief unit vectors of a spoint array
+    \param arr   array of spherical points with one dimension and no NULL values
+    \param nelem pointer to count of points
+    \return palloc'd block of 3 * nelem coordinates, or NULL if the array is empty
+  */
+  float8 *  spoint_array_vectors ( ArrayType * arr, int32 * nelem );
+
   /*!
     \brief transforms a 3 dim.vector to a spherical point 
     \param p pointer to spherical point
@@ -60,6 +149,42 @@
   */
   Vector3D * spoint_vector3d    ( Vector3D * v   , const SPoint   * p );
 
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    Raises an error if the function is not called as part of an
+    aggregate.
+    \brief Returns the memory context of an aggregate
+    \param fcinfo call info of aggregate support function
+    \param fname function name for error messages
+    \return memory context of transition states
+  */
+  MemoryContext pgs_agg_context ( FunctionCallInfo fcinfo, const char * fname );
+
+  /*!
+    The transition state of aggregates collecting spherical points.
+    The array grows geometrically, so adding n points costs O(n).
+    \brief Growable array of spherical points
+  */
+  typedef struct {
+    int32    npts;     //!< count of points
+    int32    maxpts;   //!< count of allocated points
+    SPoint * p;        //!< array of points
+  } SPointBuffer;
+
+  /*!
+    Appends a point to the transition state of an aggregate. The state
+    is created and grows in the memory context of the aggregate.
+    \brief Adds a point to point buffer
+    \param fcinfo call info of aggregate transition function
+    \param buf pointer to point buffer, NULL creates a new one
+    \param p pointer to spherical point
+    \return pointer to point buffer
+  */
+  SPointBuffer * spoint_buffer_add ( FunctionCallInfo fcinfo, SPointBuffer * buf, const SPoint * p );
+
+#endif
+
 
   /*!
     Take the input and stores it as a spherical point
@@ -68,6 +193,19 @@
    */
   Datum  spherepoint_in(PG_FUNCTION_ARGS);
 
+  /*!
+    Reads the binary representation of a spherical point
+    \return a spherical point datum
+    \note Does check the input too.
+   */
+  Datum  spherepoint_recv(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief binary output function of spherical point
+    \return bytea
+   */
+  Datum  spherepoint_send(PG_FUNCTION_ARGS);
+
 
   /*!
     Create a spherical point from longitude
@@ -78,6 +216,15 @@
    */
   Datum  spherepoint_from_long_lat(PG_FUNCTION_ARGS);
 
+  /*!
+    Create an array of spherical points from arrays of longitudes
+    and latitudes both in radians
+    \brief  points created from longitude and latitude arrays
+    \return a spherical point array datum
+    \note PostgreSQL function
+   */
+  Datum  spherepoint_from_arrays(PG_FUNCTION_ARGS);
+
 
   /*!
     Calculate the distance of two spherical points
@@ -88,6 +235,24 @@
   */
   Datum spherepoint_distance(PG_FUNCTION_ARGS);
 
+  /*!
+    \brief distances of a spherical point to the points of an array
+    \return float8 array datum
+    \note PostgreSQL function
+  */
+  Datum spherepoint_distance_array(PG_FUNCTION_ARGS);
+
+  /*!
+    Checks, if the distance of two spherical points is not
+    larger than the radius. Unlike dist ( p1, p2 ) <= r, the
+    planner can use a GiST index on one of the points.
+    \brief checks the distance of two spherical points
+    \return boolean datum
+    \see spherepoint_dwithin_support
+    \note PostgreSQL function
+  */
+  Datum spherepoint_dwithin(PG_FUNCTION_ARGS);
+
   /*!
     \brief longitude of spherical point
     \return longitude datum in radians ( float8 )
@@ -137,5 +302,79 @@
   */
   Datum  spherepoint_equal(PG_FUNCTION_ARGS);
 
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    Adds the unit vector of a point to the transition state of
+    the spoint_centroid aggregate.
+    \brief transition function of centroid aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_centroid_add(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief combines two transition states of centroid aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_centroid_combine(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief serializes the transition state of centroid aggregate
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_centroid_serialize(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief deserializes the transition state of centroid aggregate
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_centroid_deserialize(PG_FUNCTION_ARGS);
+
+  /*!
+    The centroid is the direction of the sum of the unit vectors
+    of all points. It is NULL, if the sum vanishes.
+    \brief final function of centroid aggregate
+    \return spherical point datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_centroid_finalize(PG_FUNCTION_ARGS);
+
+  /*!
+    Collects all points into a point buffer. The aggregates
+    computing an enclosing circle or a convex hull share this
+    transition function.
+    \brief transition function of aggregates collecting points
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_collect_add(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief appends the points of second point buffer to the first one
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_collect_combine(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief serializes a point buffer
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_collect_serialize(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief deserializes a point buffer
+    \return transition state datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_collect_deserialize(PG_FUNCTION_ARGS);
+
+#endif
+
 
 #endif
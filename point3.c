@@ -0,0 +1,179 @@
+#include "point3.h"
+#include "libpq/pqformat.h"
+
+/*!
+  \file
+  This file contains definitions for vector point functions
+  \brief definitions of vector point functions
+*/
+
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  PG_FUNCTION_INFO_V1(spherepoint3_in);
+  PG_FUNCTION_INFO_V1(spherepoint3_recv);
+  PG_FUNCTION_INFO_V1(spherepoint3_send);
+  PG_FUNCTION_INFO_V1(spherepoint3_from_point);
+  PG_FUNCTION_INFO_V1(spherepoint3_to_point);
+  PG_FUNCTION_INFO_V1(spherepoint3_equal);
+  PG_FUNCTION_INFO_V1(spherepoint3_equal_neg);
+  PG_FUNCTION_INFO_V1(spherepoint3_distance);
+  PG_FUNCTION_INFO_V1(spherepoint3_in_circle);
+  PG_FUNCTION_INFO_V1(spherepoint3_in_circle_neg);
+  PG_FUNCTION_INFO_V1(spherepoint3_in_circle_com);
+  PG_FUNCTION_INFO_V1(spherepoint3_in_circle_com_neg);
+
+#endif
+
+
+/*!
+  \brief the last circle of a cone search
+*/
+static SCIRCLE   ccache_circle   = { { 0.0, 0.0 }, -1.0 };
+
+/*!
+  \brief the center vector of the cached circle
+*/
+static Vector3D  ccache_center   ;
+
+/*!
+  \brief the squared chord length of the cached circle's radius
+*/
+static float8    ccache_lim      = 0.0;
+
+
+  /*!
+    A cone search checks many points against the same circle, so
+    the center vector and the chord length of the last circle are
+    kept. The point is inside, if the squared chord length to the
+    center is not larger than the one of the radius, the same test
+    as scircle_select_points does.
+    \brief Checks whether a vector point is contained by circle
+    \param v pointer to vector point
+    \param c pointer to circle
+    \return true, if circle contains the point
+  */
+  static bool vector3d_in_circle ( const Vector3D * v, const SCIRCLE * c )
+  {
+    float8 r;
+    if ( memcmp ( ( void * ) &ccache_circle, ( void * ) c, sizeof ( SCIRCLE ) ) != 0 ){
+      r = c->radius + EPSILON;
+      spoint_vector3d ( &ccache_center, &c->center );
+      ccache_lim = ( r >= PI ) ? 4.0 : sqr ( 2.0 * sin ( r / 2.0 ) );
+      memcpy ( ( void * ) &ccache_circle, ( void * ) c, sizeof ( SCIRCLE ) );
+    }
+    return ( sqr ( v->x - ccache_center.x ) +
+             sqr ( v->y - ccache_center.y ) +
+             sqr ( v->z - ccache_center.z ) <= ccache_lim );
+  }
+
+
+  Datum  spherepoint3_in(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v  = ( Vector3D * ) MALLOC ( sizeof ( Vector3D ) ) ;
+    SPoint   * p  = ( SPoint   * ) DatumGetPointer (
+                      DirectFunctionCall1 ( spherepoint_in, PG_GETARG_DATUM ( 0 ) ) );
+    spoint_vector3d ( v, p );
+    FREE ( p );
+    PG_RETURN_POINTER ( v );
+  }
+
+  Datum  spherepoint3_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    Vector3D * v   = ( Vector3D * ) MALLOC ( sizeof ( Vector3D ) ) ;
+    float8     l;
+    v->x = pgs_getmsgfloat8 ( buf );
+    v->y = pgs_getmsgfloat8 ( buf );
+    v->z = pgs_getmsgfloat8 ( buf );
+    l    = vector3d_length ( v );
+    if ( FPzero ( l ) ){
+      elog ( ERROR , "spherepoint3_recv: null vector" );
+    }
+    v->x /= l;
+    v->y /= l;
+    v->z /= l;
+    PG_RETURN_POINTER ( v );
+  }
+
+  Datum  spherepoint3_send(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v = ( Vector3D * ) PG_GETARG_POINTER( 0 ) ;
+    StringInfoData buf;
+    pq_begintypsend ( &buf );
+    pq_sendfloat8 ( &buf, v->x );
+    pq_sendfloat8 ( &buf, v->y );
+    pq_sendfloat8 ( &buf, v->z );
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
+
+  Datum  spherepoint3_from_point(PG_FUNCTION_ARGS)
+  {
+    SPoint   * p = ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
+    Vector3D * v = ( Vector3D * ) MALLOC ( sizeof ( Vector3D ) ) ;
+    PG_RETURN_POINTER ( spoint_vector3d ( v, p ) );
+  }
+
+  Datum  spherepoint3_to_point(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v = ( Vector3D * ) PG_GETARG_POINTER ( 0 ) ;
+    SPoint   * p = ( SPoint * ) MALLOC ( sizeof ( SPoint ) ) ;
+    PG_RETURN_POINTER ( vector3d_spoint ( p, v ) );
+  }
+
+  Datum  spherepoint3_equal(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v1 = ( Vector3D * ) PG_GETARG_POINTER ( 0 ) ;
+    Vector3D * v2 = ( Vector3D * ) PG_GETARG_POINTER ( 1 ) ;
+    PG_RETURN_BOOL ( vector3d_eq ( v1 , v2 ) );
+  }
+
+  Datum  spherepoint3_equal_neg(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v1 = ( Vector3D * ) PG_GETARG_POINTER ( 0 ) ;
+    Vector3D * v2 = ( Vector3D * ) PG_GETARG_POINTER ( 1 ) ;
+    PG_RETURN_BOOL ( ! vector3d_eq ( v1 , v2 ) );
+  }
+
+  Datum  spherepoint3_distance(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v1 = ( Vector3D * ) PG_GETARG_POINTER ( 0 ) ;
+    Vector3D * v2 = ( Vector3D * ) PG_GETARG_POINTER ( 1 ) ;
+    Vector3D   c;
+    float8     d;
+    /* atan2 is exact for small and large distances */
+    vector3d_cross ( &c, v1, v2 );
+    d = atan2 ( vector3d_length ( &c ), vector3d_scalar ( v1, v2 ) );
+    if ( FPzero ( d ) ){
+      d = 0.0;
+    }
+    PG_RETURN_FLOAT8 ( d );
+  }
+
+  Datum  spherepoint3_in_circle(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v = ( Vector3D * ) PG_GETARG_POINTER ( 0 ) ;
+    SCIRCLE  * c = ( SCIRCLE  * ) PG_GETARG_POINTER ( 1 ) ;
+    PG_RETURN_BOOL ( vector3d_in_circle ( v, c ) );
+  }
+
+  Datum  spherepoint3_in_circle_neg(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v = ( Vector3D * ) PG_GETARG_POINTER ( 0 ) ;
+    SCIRCLE  * c = ( SCIRCLE  * ) PG_GETARG_POINTER ( 1 ) ;
+    PG_RETURN_BOOL ( ! vector3d_in_circle ( v, c ) );
+  }
+
+  Datum  spherepoint3_in_circle_com(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v = ( Vector3D * ) PG_GETARG_POINTER ( 1 ) ;
+    SCIRCLE  * c = ( SCIRCLE  * ) PG_GETARG_POINTER ( 0 ) ;
+    PG_RETURN_BOOL ( vector3d_in_circle ( v, c ) );
+  }
+
+  Datum  spherepoint3_in_circle_com_neg(PG_FUNCTION_ARGS)
+  {
+    Vector3D * v = ( Vector3D * ) PG_GETARG_POINTER ( 1 ) ;
+    SCIRCLE  * c = ( SCIRCLE  * ) PG_GETARG_POINTER ( 0 ) ;
+    PG_RETURN_BOOL ( ! vector3d_in_circle ( v, c ) );
+  }
@@ -0,0 +1,101 @@
+#ifndef __PGS_POINT3_H__
+#define __PGS_POINT3_H__
+
+#include "point4.h"
+
+/*!
+  \file
+  This file contains declarations of the vector point. The
+  vector point keeps the unit vector of a position, so the
+  distance and the cone search need no trigonometric function
+  per point.
+  \brief vector point declarations
+*/
+
+
+  /*!
+    Take the input and stores it as a vector point
+    \return a vector point datum
+    \note Does check the input too.
+   */
+  Datum  spherepoint3_in(PG_FUNCTION_ARGS);
+
+  /*!
+    Reads the binary representation of a vector point. The vector
+    is normalized.
+    \return a vector point datum
+   */
+  Datum  spherepoint3_recv(PG_FUNCTION_ARGS);
+
+  /*!
+    Writes the binary representation of a vector point
+    \return bytea datum
+   */
+  Datum  spherepoint3_send(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief converts a spherical point to a vector point
+    \return a vector point datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_from_point(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief converts a vector point to a spherical point
+    \return a spherical point datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_to_point(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether two vector points are equal
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_equal(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether two vector points are not equal
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_equal_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Calculates the distance between two vector points
+    \return float8 datum in radians
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_distance(PG_FUNCTION_ARGS);
+
+  /*!
+    Compares the squared chord length between point and circle
+    center with the one of the radius.
+    \brief Checks whether a vector point is contained by circle
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_in_circle(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a vector point is not contained by circle
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_in_circle_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a circle contains a vector point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_in_circle_com(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a circle does not contain a vector point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint3_in_circle_com_neg(PG_FUNCTION_ARGS);
+
+#endif
@@ -0,0 +1,255 @@
+#include "point4.h"
+#include "libpq/pqformat.h"
+
+/*!
+  \file
+  This file contains definitions for compact spherical
+  point functions
+  \brief definitions of compact spherical point functions
+*/
+
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  PG_FUNCTION_INFO_V1(spherepoint4_in);
+  PG_FUNCTION_INFO_V1(spherepoint4_recv);
+  PG_FUNCTION_INFO_V1(spherepoint4_send);
+  PG_FUNCTION_INFO_V1(spherepoint4_from_point);
+  PG_FUNCTION_INFO_V1(spherepoint4_to_point);
+  PG_FUNCTION_INFO_V1(spherepoint4_equal);
+  PG_FUNCTION_INFO_V1(spherepoint4_equal_neg);
+  PG_FUNCTION_INFO_V1(spherepoint4_distance);
+  PG_FUNCTION_INFO_V1(spherepoint4_in_circle);
+  PG_FUNCTION_INFO_V1(spherepoint4_in_circle_neg);
+  PG_FUNCTION_INFO_V1(spherepoint4_in_circle_com);
+  PG_FUNCTION_INFO_V1(spherepoint4_in_circle_com_neg);
+  PG_FUNCTION_INFO_V1(sphereline_cont_point4);
+  PG_FUNCTION_INFO_V1(sphereline_cont_point4_neg);
+  PG_FUNCTION_INFO_V1(sphereline_cont_point4_com);
+  PG_FUNCTION_INFO_V1(sphereline_cont_point4_com_neg);
+  PG_FUNCTION_INFO_V1(spherepath_cont_point4);
+  PG_FUNCTION_INFO_V1(spherepath_cont_point4_neg);
+  PG_FUNCTION_INFO_V1(spherepath_cont_point4_com);
+  PG_FUNCTION_INFO_V1(spherepath_cont_point4_com_neg);
+  PG_FUNCTION_INFO_V1(spherepoly_cont_point4);
+  PG_FUNCTION_INFO_V1(spherepoly_cont_point4_neg);
+  PG_FUNCTION_INFO_V1(spherepoly_cont_point4_com);
+  PG_FUNCTION_INFO_V1(spherepoly_cont_point4_com_neg);
+  PG_FUNCTION_INFO_V1(sphereellipse_cont_point4);
+  PG_FUNCTION_INFO_V1(sphereellipse_cont_point4_neg);
+  PG_FUNCTION_INFO_V1(sphereellipse_cont_point4_com);
+  PG_FUNCTION_INFO_V1(sphereellipse_cont_point4_com_neg);
+  PG_FUNCTION_INFO_V1(spherebox_cont_point4);
+  PG_FUNCTION_INFO_V1(spherebox_cont_point4_neg);
+  PG_FUNCTION_INFO_V1(spherebox_cont_point4_com);
+  PG_FUNCTION_INFO_V1(spherebox_cont_point4_com_neg);
+
+#endif
+
+
+  Datum  spherepoint4_in(PG_FUNCTION_ARGS)
+  {
+    SPoint4  * p4 = ( SPoint4 * ) MALLOC ( sizeof ( SPoint4 ) ) ;
+    SPoint   * p  = ( SPoint  * ) DatumGetPointer (
+                      DirectFunctionCall1 ( spherepoint_in, PG_GETARG_DATUM ( 0 ) ) );
+    spoint_to_spoint4 ( p4, p );
+    FREE ( p );
+    PG_RETURN_POINTER ( p4 );
+  }
+
+  Datum  spherepoint4_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SPoint4  * p4  = ( SPoint4 * ) MALLOC ( sizeof ( SPoint4 ) ) ;
+    p4->lng = ( int32 ) pq_getmsgint ( buf, 4 );
+    p4->lat = ( int32 ) pq_getmsgint ( buf, 4 );
+    if ( p4->lat < -2147483647 ){
+      elog ( ERROR , "spherepoint4_recv: latitude out of range" );
+    }
+    PG_RETURN_POINTER ( p4 );
+  }
+
+  Datum  spherepoint4_send(PG_FUNCTION_ARGS)
+  {
+    SPoint4 * p4 = ( SPoint4 * ) PG_GETARG_POINTER( 0 ) ;
+    StringInfoData buf;
+    pq_begintypsend ( &buf );
+    pq_sendint ( &buf, ( uint32 ) p4->lng, 4 );
+    pq_sendint ( &buf, ( uint32 ) p4->lat, 4 );
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
+
+  Datum  spherepoint4_from_point(PG_FUNCTION_ARGS)
+  {
+    SPoint  * p  = ( SPoint * ) PG_GETARG_POINTER ( 0 ) ;
+    SPoint4 * p4 = ( SPoint4 * ) MALLOC ( sizeof ( SPoint4 ) ) ;
+    PG_RETURN_POINTER ( spoint_to_spoint4 ( p4, p ) );
+  }
+
+  Datum  spherepoint4_to_point(PG_FUNCTION_ARGS)
+  {
+    SPoint4 * p4 = ( SPoint4 * ) PG_GETARG_POINTER ( 0 ) ;
+    SPoint  * p  = ( SPoint * ) MALLOC ( sizeof ( SPoint ) ) ;
+    PG_RETURN_POINTER ( spoint4_to_spoint ( p, p4 ) );
+  }
+
+  Datum  spherepoint4_equal(PG_FUNCTION_ARGS)
+  {
+    SPoint p1, p2;
+    spoint4_to_spoint ( &p1, ( SPoint4 * ) PG_GETARG_POINTER ( 0 ) );
+    spoint4_to_spoint ( &p2, ( SPoint4 * ) PG_GETARG_POINTER ( 1 ) );
+    PG_RETURN_BOOL ( spoint_eq ( &p1 , &p2 ) );
+  }
+
+  Datum  spherepoint4_equal_neg(PG_FUNCTION_ARGS)
+  {
+    SPoint p1, p2;
+    spoint4_to_spoint ( &p1, ( SPoint4 * ) PG_GETARG_POINTER ( 0 ) );
+    spoint4_to_spoint ( &p2, ( SPoint4 * ) PG_GETARG_POINTER ( 1 ) );
+    PG_RETURN_BOOL ( ! spoint_eq ( &p1 , &p2 ) );
+  }
+
+  Datum  spherepoint4_distance(PG_FUNCTION_ARGS)
+  {
+    SPoint p1, p2;
+    spoint4_to_spoint ( &p1, ( SPoint4 * ) PG_GETARG_POINTER ( 0 ) );
+    spoint4_to_spoint ( &p2, ( SPoint4 * ) PG_GETARG_POINTER ( 1 ) );
+    PG_RETURN_FLOAT8 ( spoint_dist ( &p1, &p2 ) );
+  }
+
+
+/*!
+  \brief calls a function of spherical points with a converted compact point
+  \param func the function with a spherical point argument
+  \param n    position of compact point argument ( 0 or 1 )
+*/
+#define PGS_POINT4_CALL( func , n ) do { \
+    SPoint p; \
+    spoint4_to_spoint ( &p, ( SPoint4 * ) PG_GETARG_POINTER ( n ) ); \
+    if ( n == 0 ){ \
+      PG_RETURN_DATUM ( DirectFunctionCall2 ( func, PointerGetDatum ( &p ), PG_GETARG_DATUM ( 1 ) ) ); \
+    } else { \
+      PG_RETURN_DATUM ( DirectFunctionCall2 ( func, PG_GETARG_DATUM ( 0 ), PointerGetDatum ( &p ) ) ); \
+    } \
+  } while (0)
+
+
+  Datum  spherepoint4_in_circle(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepoint_in_circle, 0 );
+  }
+
+  Datum  spherepoint4_in_circle_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepoint_in_circle_neg, 0 );
+  }
+
+  Datum  spherepoint4_in_circle_com(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepoint_in_circle_com, 1 );
+  }
+
+  Datum  spherepoint4_in_circle_com_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepoint_in_circle_com_neg, 1 );
+  }
+
+  Datum  sphereline_cont_point4(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( sphereline_cont_point, 1 );
+  }
+
+  Datum  sphereline_cont_point4_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( sphereline_cont_point_neg, 1 );
+  }
+
+  Datum  sphereline_cont_point4_com(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( sphereline_cont_point_com, 0 );
+  }
+
+  Datum  sphereline_cont_point4_com_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( sphereline_cont_point_com_neg, 0 );
+  }
+
+  Datum  spherepath_cont_point4(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepath_cont_point, 1 );
+  }
+
+  Datum  spherepath_cont_point4_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepath_cont_point_neg, 1 );
+  }
+
+  Datum  spherepath_cont_point4_com(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepath_cont_point_com, 0 );
+  }
+
+  Datum  spherepath_cont_point4_com_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepath_cont_point_com_neg, 0 );
+  }
+
+  Datum  spherepoly_cont_point4(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepoly_cont_point, 1 );
+  }
+
+  Datum  spherepoly_cont_point4_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepoly_cont_point_neg, 1 );
+  }
+
+  Datum  spherepoly_cont_point4_com(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepoly_cont_point_com, 0 );
+  }
+
+  Datum  spherepoly_cont_point4_com_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherepoly_cont_point_com_neg, 0 );
+  }
+
+  Datum  sphereellipse_cont_point4(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( sphereellipse_cont_point, 1 );
+  }
+
+  Datum  sphereellipse_cont_point4_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( sphereellipse_cont_point_neg, 1 );
+  }
+
+  Datum  sphereellipse_cont_point4_com(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( sphereellipse_cont_point_com, 0 );
+  }
+
+  Datum  sphereellipse_cont_point4_com_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( sphereellipse_cont_point_com_neg, 0 );
+  }
+
+  Datum  spherebox_cont_point4(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherebox_cont_point, 1 );
+  }
+
+  Datum  spherebox_cont_point4_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherebox_cont_point_neg, 1 );
+  }
+
+  Datum  spherebox_cont_point4_com(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherebox_cont_point_com, 0 );
+  }
+
+  Datum  spherebox_cont_point4_com_neg(PG_FUNCTION_ARGS)
+  {
+    PGS_POINT4_CALL ( spherebox_cont_point_com_neg, 0 );
+  }
@@ -0,0 +1,248 @@
+#ifndef __PGS_POINT4_H__
+#define __PGS_POINT4_H__
+
+#include "box.h"
+
+/*!
+  \file
+  This file contains declarations of the compact spherical
+  point. The compact point keeps the position in two int32
+  values and is converted to a spherical point for all
+  calculations.
+  \brief compact spherical point declarations
+*/
+
+
+  /*!
+    Take the input and stores it as a compact spherical point
+    \return a compact spherical point datum
+    \note Does check the input too.
+   */
+  Datum  spherepoint4_in(PG_FUNCTION_ARGS);
+
+  /*!
+    Reads the binary representation of a compact spherical point
+    \return a compact spherical point datum
+   */
+  Datum  spherepoint4_recv(PG_FUNCTION_ARGS);
+
+  /*!
+    Writes the binary representation of a compact spherical point
+    \return bytea datum
+   */
+  Datum  spherepoint4_send(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief converts a spherical point to a compact spherical point
+    \return a compact spherical point datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_from_point(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief converts a compact spherical point to a spherical point
+    \return a spherical point datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_to_point(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether two compact points are equal
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_equal(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether two compact points are not equal
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_equal_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Calculates the distance between two compact points
+    \return float8 datum in radians
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_distance(PG_FUNCTION_ARGS);
+
+
+/*!
+  \addtogroup PGS_POINT4_REL Compact point relationships
+  The functions call the functions of spherical points, so the
+  results are the same as with spoint values.
+  @{
+*/
+
+  /*!
+    \brief Checks whether a compact point is contained by circle
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_in_circle(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is not contained by circle
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_in_circle_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a circle contains a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_in_circle_com(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a circle does not contain a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoint4_in_circle_com_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a line contains a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  sphereline_cont_point4(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a line does not contain a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  sphereline_cont_point4_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is contained by line
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  sphereline_cont_point4_com(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is not contained by line
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  sphereline_cont_point4_com_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a path contains a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_cont_point4(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a path does not contain a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_cont_point4_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is contained by path
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_cont_point4_com(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is not contained by path
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepath_cont_point4_com_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a polygon contains a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_cont_point4(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a polygon does not contain a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_cont_point4_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is contained by polygon
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_cont_point4_com(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is not contained by polygon
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_cont_point4_com_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether an ellipse contains a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  sphereellipse_cont_point4(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether an ellipse does not contain a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  sphereellipse_cont_point4_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is contained by ellipse
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  sphereellipse_cont_point4_com(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is not contained by ellipse
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  sphereellipse_cont_point4_com_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a box contains a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherebox_cont_point4(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a box does not contain a compact point
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherebox_cont_point4_neg(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is contained by box
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherebox_cont_point4_com(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Checks whether a compact point is not contained by box
+    \return boolean datum
+    \note PostgreSQL function
+  */
+  Datum  spherebox_cont_point4_com_neg(PG_FUNCTION_ARGS);
+
+/* @} */
+
+#endif
@@ -1,4 +1,5 @@
 #include "polygon.h"
+#include "stats.h"
 
 /*!
   \file
@@ -9,6 +10,10 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
   PG_FUNCTION_INFO_V1(spherepoly_in);
+  PG_FUNCTION_INFO_V1(spherepoly_recv);
+  PG_FUNCTION_INFO_V1(spherepoly_send);
+  PG_FUNCTION_INFO_V1(spherepoly_from_arrays);
+  PG_FUNCTION_INFO_V1(spherepoly_from_points);
   PG_FUNCTION_INFO_V1(spherepoly_equal);
   PG_FUNCTION_INFO_V1(spherepoly_equal_neg);
   PG_FUNCTION_INFO_V1(spherepoly_circ);
@@ -58,8 +63,11 @@
   PG_FUNCTION_INFO_V1(spherepoly_overlap_ellipse_com_neg);
   PG_FUNCTION_INFO_V1(spheretrans_poly);
   PG_FUNCTION_INFO_V1(spheretrans_poly_inverse);
+  PG_FUNCTION_INFO_V1(spherepoly_pack);
+  PG_FUNCTION_INFO_V1(spherepoly_unpack);
   PG_FUNCTION_INFO_V1(spherepoly_add_point);
   PG_FUNCTION_INFO_V1(spherepoly_add_points_finalize);
+  PG_FUNCTION_INFO_V1(spherepoly_hull_finalize);
 
 #endif
 
@@ -100,56 +108,497 @@
   }
 
 
+  /*!
+    \brief A polygon edge projected to the tangent plane at the polygon
+           center ( gnomonic projection ). The great circle arcs of the
+           edges are straight line segments there.
+  */
+  typedef struct {
+    float8  a[2];        //!< left ( lexicographically lower ) end point
+    float8  b[2];        //!< right end point
+    float8  sa[2];       //!< left end point snapped for the sweep order
+    float8  sb[2];       //!< right end point snapped for the sweep order
+    uint32  prio;        //!< treap priority
+    int32   up;          //!< parent node in treap, -1 if root
+    int32   child[2];    //!< lower and upper child in treap, -1 if none
+  } PSEGMENT;
+
+  /*!
+    \brief An event of the sweep line
+  */
+  typedef struct {
+    float8  p[2];        //!< event point
+    int32   seg;         //!< index of edge
+    int32   type;        //!< 0 - remove edge, 1 - insert edge
+  } PSWEEPEVENT;
+
+
+  /*!
+    \brief Lexicographical order of two planar points
+  */
+  static int psweep_pt_cmp ( const float8 * a, const float8 * b )
+  {
+    if ( a[0] != b[0] ){
+      return ( ( a[0] < b[0] ) ? -1 : 1 );
+    }
+    if ( a[1] != b[1] ){
+      return ( ( a[1] < b[1] ) ? -1 : 1 );
+    }
+    return 0;
+  }
+
+
+  /*!
+    \brief Order of sweep line events, removals go first at the same point
+  */
+  static int psweep_event_cmp ( const void * a, const void * b )
+  {
+    const PSWEEPEVENT * e1 = ( const PSWEEPEVENT * ) a;
+    const PSWEEPEVENT * e2 = ( const PSWEEPEVENT * ) b;
+    int c = psweep_pt_cmp ( e1->p, e2->p );
+    if ( c != 0 ){
+      return c;
+    }
+    if ( e1->type != e2->type ){
+      return ( e1->type - e2->type );
+    }
+    return ( e1->seg - e2->seg );
+  }
+
+
+  /*!
+    \brief Orientation of point p relative to the line a-b
+    \return 1 if left, -1 if right, 0 if point is on the line
+  */
+  static int psweep_orient ( const float8 * a, const float8 * b, const float8 * p )
+  {
+    float8 dx = b[0] - a[0];
+    float8 dy = b[1] - a[1];
+    float8 o  = dx * ( p[1] - a[1] ) - dy * ( p[0] - a[0] );
+    if ( fabs(o) <= EPSILON * sqrt ( dx*dx + dy*dy ) ){
+      return 0;
+    }
+    return ( ( o > 0.0 ) ? 1 : -1 );
+  }
+
+
+  /*!
+    \brief Checks whether two planar points are equal
+  */
+  static bool psweep_pt_eq ( const float8 * a, const float8 * b )
+  {
+    return ( FPeq ( a[0], b[0] ) && FPeq ( a[1], b[1] ) );
+  }
+
+
+  /*!
+    \brief Checks whether p touches the edge s apart from its end points
+    \note p has to be on the line of s
+  */
+  static bool psweep_touch ( const PSEGMENT * s, const float8 * p )
+  {
+    if ( FPlt ( p[0], min ( s->a[0], s->b[0] ) ) ||
+         FPgt ( p[0], max ( s->a[0], s->b[0] ) ) ||
+         FPlt ( p[1], min ( s->a[1], s->b[1] ) ) ||
+         FPgt ( p[1], max ( s->a[1], s->b[1] ) ) ){
+      return FALSE;
+    }
+    return ( ! psweep_pt_eq ( p, s->a ) && ! psweep_pt_eq ( p, s->b ) );
+  }
+
+
+  /*!
+    \brief Checks the relationship of two polygon edges
+    \return true, if edges are crossing, touching or overlapping. That's
+            the same as sline_sline_pos() returning something else
+            than PGS_LINE_CONNECT or PGS_LINE_AVOID.
+  */
+  static bool psweep_bad ( const PSEGMENT * s, const PSEGMENT * t )
+  {
+    int o1 = psweep_orient ( s->a, s->b, t->a );
+    int o2 = psweep_orient ( s->a, s->b, t->b );
+    int o3 = psweep_orient ( t->a, t->b, s->a );
+    int o4 = psweep_orient ( t->a, t->b, s->b );
+
+    if ( o1 == 0 && o2 == 0 && o3 == 0 && o4 == 0 ){
+      float8 dx = s->b[0] - s->a[0];
+      float8 dy = s->b[1] - s->a[1];
+      float8 l  = dx*dx + dy*dy;
+      float8 ta = dx * ( t->a[0] - s->a[0] ) + dy * ( t->a[1] - s->a[1] );
+      float8 tb = dx * ( t->b[0] - s->a[0] ) + dy * ( t->b[1] - s->a[1] );
+      // at same great circle: connected edges overlap too
+      if ( psweep_pt_eq ( s->b, t->a ) || psweep_pt_eq ( t->b, s->a ) ||
+           psweep_pt_eq ( s->a, t->a ) || psweep_pt_eq ( s->b, t->b ) ){
+        return TRUE;
+      }
+      // the positions of t along s
+      return ( min ( max ( ta, tb ), l ) - max ( min ( ta, tb ), 0.0 ) > EPSILON * sqrt ( l ) );
+    }
+    if ( o1 * o2 < 0 && o3 * o4 < 0 ){
+      return TRUE;
+    }
+    return ( ( o1 == 0 && psweep_touch ( s, t->a ) ) ||
+             ( o2 == 0 && psweep_touch ( s, t->b ) ) ||
+             ( o3 == 0 && psweep_touch ( t, s->a ) ) ||
+             ( o4 == 0 && psweep_touch ( t, s->b ) ) );
+  }
+
+
+  /*!
+    \brief Sweep line order of edge s inserted at its left point
+           relative to an active edge t
+    \return -1 if s is below t, otherwise 1
+  */
+  static int psweep_seg_cmp ( const PSEGMENT * sg, int32 s, int32 t )
+  {
+    const PSEGMENT * ps = &sg[s];
+    const PSEGMENT * pt = &sg[t];
+    float8 y;
+    int    o;
+
+    if ( pt->sa[0] == pt->sb[0] ){
+      y = max ( pt->sa[1], min ( ps->sa[1], pt->sb[1] ) );
+    } else if ( ps->sa[0] == pt->sb[0] ){
+      y = pt->sb[1];
+    } else {
+      y = pt->sa[1] + ( pt->sb[1] - pt->sa[1] ) * ( ps->sa[0] - pt->sa[0] ) / ( pt->sb[0] - pt->sa[0] );
+    }
+    if ( ! FPeq ( ps->sa[1], y ) ){
+      return ( ( ps->sa[1] < y ) ? -1 : 1 );
+    }
+    o = psweep_orient ( pt->sa, pt->sb, ps->sb );
+    if ( o != 0 ){
+      return o;
+    }
+    return ( ( s < t ) ? -1 : 1 );
+  }
+
+
+  /*!
+    \brief Rotates treap node x above its parent
+  */
+  static void psweep_rotate ( PSEGMENT * sg, int32 * root, int32 x )
+  {
+    int32 p   = sg[x].up;
+    int32 g   = sg[p].up;
+    int   dir = ( sg[p].child[1] == x ) ? 1 : 0 ;
+    int32 b   = sg[x].child[1-dir];
+
+    sg[p].child[dir] = b;
+    if ( b >= 0 ){
+      sg[b].up = p;
+    }
+    sg[x].child[1-dir] = p;
+    sg[p].up = x;
+    sg[x].up = g;
+    if ( g < 0 ){
+      *root = x;
+    } else {
+      sg[g].child[ ( sg[g].child[1] == p ) ? 1 : 0 ] = x;
+    }
+  }
+
+
+  /*!
+    \brief Inserts edge s into sweep line status ( treap )
+  */
+  static void psweep_insert ( PSEGMENT * sg, int32 * root, int32 s )
+  {
+    int32 t   = *root;
+    int32 p   = -1;
+    int   dir = 0;
+
+    while ( t >= 0 ){
+      p   = t;
+      dir = ( psweep_seg_cmp ( sg, s, t ) > 0 ) ? 1 : 0 ;
+      t   = sg[t].child[dir];
+    }
+    sg[s].up       = p;
+    sg[s].child[0] = -1;
+    sg[s].child[1] = -1;
+    if ( p < 0 ){
+      *root = s;
+    } else {
+      sg[p].child[dir] = s;
+    }
+    while ( sg[s].up >= 0 && sg[sg[s].up].prio < sg[s].prio ){
+      psweep_rotate ( sg, root, s );
+    }
+  }
+
+
+  /*!
+    \brief Removes edge s from sweep line status ( treap )
+  */
+  static void psweep_remove ( PSEGMENT * sg, int32 * root, int32 s )
+  {
+    int32 l, r, p;
+
+    while ( TRUE ){
+      l = sg[s].child[0];
+      r = sg[s].child[1];
+      if ( l < 0 && r < 0 ){
+        break;
+      } else if ( l < 0 ){
+        psweep_rotate ( sg, root, r );
+      } else if ( r < 0 || sg[l].prio > sg[r].prio ){
+        psweep_rotate ( sg, root, l );
+      } else {
+        psweep_rotate ( sg, root, r );
+      }
+    }
+    p = sg[s].up;
+    if ( p < 0 ){
+      *root = -1;
+    } else {
+      sg[p].child[ ( sg[p].child[1] == s ) ? 1 : 0 ] = -1;
+    }
+  }
+
+
+  /*!
+    \brief Neighbor of edge s in sweep line status
+    \param dir 1 for upper, 0 for lower neighbor
+    \return index of neighbor, -1 if none
+  */
+  static int32 psweep_neighbor ( const PSEGMENT * sg, int32 s, int dir )
+  {
+    int32 t = sg[s].child[dir];
+    if ( t >= 0 ){
+      while ( sg[t].child[1-dir] >= 0 ){
+        t = sg[t].child[1-dir];
+      }
+      return t;
+    }
+    t = s;
+    while ( sg[t].up >= 0 && sg[sg[t].up].child[dir] == t ){
+      t = sg[t].up;
+    }
+    return sg[t].up;
+  }
+
+
+  /*!
+    \brief An edge at an event point, ordered by its direction
+  */
+  typedef struct {
+    float8  angle;       //!< direction of edge to the right
+    int32   seg;         //!< index of edge
+  } PSWEEPDIR;
+
+
+  /*!
+    \brief Order of edges at an event point by their direction
+  */
+  static int psweep_dir_cmp ( const void * a, const void * b )
+  {
+    const PSWEEPDIR * d1 = ( const PSWEEPDIR * ) a;
+    const PSWEEPDIR * d2 = ( const PSWEEPDIR * ) b;
+    if ( d1->angle != d2->angle ){
+      return ( ( d1->angle < d2->angle ) ? -1 : 1 );
+    }
+    return ( d1->seg - d2->seg );
+  }
+
+
+  /*!
+    The sweep orders the events exactly, but psweep_orient and
+    psweep_pt_eq allow EPSILON. A vertex on a vertical edge may
+    then be handled before the edge is inserted. To avoid this,
+    coordinates equal within EPSILON are set to the same value.
+    \brief Snaps the coordinates of planar points
+    \param pt pointer to coordinates of points
+    \param n  count of points
+    \param ev buffer of n events at least
+    \param d  0 for x, 1 for y coordinate of points with equal x
+  */
+  static void psweep_snap ( float8 * pt, int32 n, PSWEEPEVENT * ev, int d )
+  {
+    int32 i, k;
+
+    for ( i=0; i<n; i++ ){
+      memcpy ( (void*) ev[i].p, (void*) &pt[2*i], 2 * sizeof ( float8 ) );
+      ev[i].seg  = i;
+      ev[i].type = 0;
+    }
+    qsort ( (void*) ev, n, sizeof ( PSWEEPEVENT ), psweep_event_cmp );
+    for ( i=0; i<n; i=k ){
+      for ( k=i+1; k<n && ( d == 0 || ev[k].p[0] == ev[i].p[0] ) &&
+                   FPeq ( ev[k].p[d], ev[i].p[d] ); k++ ){
+        pt[2*ev[k].seg+d] = ev[i].p[d];
+      }
+    }
+  }
+
+
+  /*!
+    Edges sharing the event point are bad, if they are on the same
+    great circle. These have the same direction, so only edges next
+    to each other in the order of directions are compared.
+    \brief Checks the edges at an event point
+    \param sg  edges
+    \param ev  events at the point
+    \param n   count of events
+    \param dir buffer of n directions at least
+    \return true if the edges are valid
+  */
+  static bool psweep_check_point ( const PSEGMENT * sg, const PSWEEPEVENT * ev, int32 n, PSWEEPDIR * dir )
+  {
+    int32 i;
+
+    if ( n < 2 ){
+      return TRUE;
+    }
+    for ( i=0; i<n; i++ ){
+      const PSEGMENT * e = &sg[ev[i].seg];
+      dir[i].angle = atan2 ( e->b[1] - e->a[1], e->b[0] - e->a[0] );
+      dir[i].seg   = ev[i].seg;
+    }
+    qsort ( (void*) dir, n, sizeof ( PSWEEPDIR ), psweep_dir_cmp );
+    for ( i=1; i<n; i++ ){
+      if ( psweep_bad ( &sg[dir[i-1].seg], &sg[dir[i].seg] ) ){
+        return FALSE;
+      }
+    }
+    // almost vertical edges are at both ends
+    return ( n < 3 || ! psweep_bad ( &sg[dir[0].seg], &sg[dir[n-1].seg] ) );
+  }
+
+
   /*!
     \brief Checks crossing of line segments
+    
+    All vertices have to be in the hemisphere around the polygon
+    center. Then the edges are projected to the tangent plane at the
+    center, where a sweep line ( Shamos-Hoey ) looks for crossing
+    or overlapping edges in O(n log n).
     \param poly pointer to polygon
-    \return true if crossing
+    \return true if polygon is valid
   */
   static bool spherepoly_check ( const SPOLY * poly )
   {
 
-    int32 i, k ;
-    SLine sli, slk;
-    Vector3D v ;
-    SPoint  p;
-    SEuler se;
-    int8  pos;
+    int32 i, j, s, lo, up ;
+    int32 root = -1;
+    int32 n    = poly->npts;
+    uint32 seed = 1;
+    Vector3D v, c, e1, e2 ;
+    float8   z ;
+    float8       * pt, * ps ;
+    PSEGMENT     * sg ;
+    PSWEEPEVENT  * ev ;
+    PSWEEPDIR    * dir ;
+    bool ret = TRUE;
 
     spherepoly_center ( &v , poly );
     // If 0-vector
     if ( FPzero(v.x) && FPzero(v.y) && FPzero(v.z) ){
       return FALSE;
     }
-    
-    for ( i=0; i<poly->npts; i++ ){
-      spoly_segment   ( &sli , poly , i );
-      for ( k=(i+1); k<poly->npts; k++ ){
-        spoly_segment ( &slk , poly , k );
-        pos = sline_sline_pos( &sli, &slk );
-        if ( ! ( pos == PGS_LINE_CONNECT || pos == PGS_LINE_AVOID ) ) {
-          return FALSE;
-        }
-      }
-    }
-    
-    vector3d_spoint ( &p , &v );
 
-    se.phi_a   = EULER_AXIS_Z  ;
-    se.theta_a = EULER_AXIS_X  ;
-    se.psi_a   = EULER_AXIS_Z  ;
-    se.phi     = -PIH - p.lng  ;
-    se.theta   = p.lat - PIH   ;
-    se.psi     = 0.0           ;
-
-    for ( i=0; i<poly->npts; i++ ){
-      euler_spoint_trans ( &p , &poly->p[i], &se );
+    z   = vector3d_length ( &v );
+    c.x = v.x / z ;
+    c.y = v.y / z ;
+    c.z = v.z / z ;
+
+    // base vectors of tangent plane
+    v.x = v.y = v.z = 0.0;
+    if ( fabs(c.x) <= fabs(c.y) && fabs(c.x) <= fabs(c.z) ){
+      v.x = 1.0;
+    } else if ( fabs(c.y) <= fabs(c.z) ){
+      v.y = 1.0;
+    } else {
+      v.z = 1.0;
+    }
+    vector3d_cross ( &e1, &c, &v );
+    z    = vector3d_length ( &e1 );
+    e1.x /= z ;
+    e1.y /= z ;
+    e1.z /= z ;
+    vector3d_cross ( &e2, &c, &e1 );
+
+    pt = ( float8 * ) MALLOC ( sizeof ( float8 ) * 4 * n );
+    ps = &pt[2*n];
+    for ( i=0; i<n; i++ ){
+      spoint_vector3d ( &v , &poly->p[i] );
+      z = vector3d_scalar ( &v, &c );
       // less _and_ equal are important !!
       // Do not change it!
-      if ( FPle(p.lat,0.0) ) {
+      if ( FPle(z,0.0) ) {
+        FREE ( pt );
         return FALSE;
       }
+      pt[2*i  ] = vector3d_scalar ( &v, &e1 ) / z ;
+      pt[2*i+1] = vector3d_scalar ( &v, &e2 ) / z ;
     }
-    return TRUE ;
+
+    sg  = ( PSEGMENT * )    MALLOC ( sizeof ( PSEGMENT ) * n );
+    ev  = ( PSWEEPEVENT * ) MALLOC ( sizeof ( PSWEEPEVENT ) * 2 * n );
+    dir = ( PSWEEPDIR * )   MALLOC ( sizeof ( PSWEEPDIR ) * 2 * n );
+    // the events are ordered by snapped points, the edges keep
+    // the exact points
+    memcpy ( (void*) ps, (void*) pt, 2 * n * sizeof ( float8 ) );
+    psweep_snap ( ps, n, ev, 0 );
+    psweep_snap ( ps, n, ev, 1 );
+    for ( i=0; i<n; i++ ){
+      int32 a = i;
+      int32 b = (i+1)%n;
+      if ( psweep_pt_cmp ( &ps[2*a], &ps[2*b] ) == 0 ){
+        // edge without length, the sweep cannot order it
+        ret = FALSE;
+      }
+      if ( psweep_pt_cmp ( &ps[2*b], &ps[2*a] ) < 0 ){
+        a = b;
+        b = i;
+      }
+      memcpy ( (void*) sg[i].a,  (void*) &pt[2*a], 2 * sizeof ( float8 ) );
+      memcpy ( (void*) sg[i].b,  (void*) &pt[2*b], 2 * sizeof ( float8 ) );
+      memcpy ( (void*) sg[i].sa, (void*) &ps[2*a], 2 * sizeof ( float8 ) );
+      memcpy ( (void*) sg[i].sb, (void*) &ps[2*b], 2 * sizeof ( float8 ) );
+      seed        = seed * 1103515245 + 12345 ;
+      sg[i].prio  = seed ;
+      memcpy ( (void*) ev[2*i].p, (void*) &ps[2*a], 2 * sizeof ( float8 ) );
+      ev[2*i  ].seg  = i;
+      ev[2*i  ].type = 1;
+      memcpy ( (void*) ev[2*i+1].p, (void*) &ps[2*b], 2 * sizeof ( float8 ) );
+      ev[2*i+1].seg  = i;
+      ev[2*i+1].type = 0;
+    }
+    qsort ( (void*) ev, 2 * n, sizeof ( PSWEEPEVENT ), psweep_event_cmp );
+
+    for ( i=0; ret && i<(2*n); i++ ){
+      // edges removed or inserted at the same point
+      if ( i == 0 || psweep_pt_cmp ( ev[i-1].p, ev[i].p ) != 0 ){
+        for ( j=i+1; j<(2*n) && psweep_pt_cmp ( ev[j].p, ev[i].p ) == 0 ; j++ );
+        ret = psweep_check_point ( sg, &ev[i], j - i, dir );
+        if ( ! ret ){
+          break;
+        }
+      }
+      s = ev[i].seg;
+      if ( ev[i].type == 1 ){
+        psweep_insert ( sg, &root, s );
+        lo = psweep_neighbor ( sg, s, 0 );
+        up = psweep_neighbor ( sg, s, 1 );
+        if ( ( lo >= 0 && psweep_bad ( &sg[lo], &sg[s] ) ) ||
+             ( up >= 0 && psweep_bad ( &sg[s], &sg[up] ) ) ){
+          ret = FALSE;
+        }
+      } else {
+        lo = psweep_neighbor ( sg, s, 0 );
+        up = psweep_neighbor ( sg, s, 1 );
+        psweep_remove ( sg, &root, s );
+        if ( lo >= 0 && up >= 0 && psweep_bad ( &sg[lo], &sg[up] ) ){
+          ret = FALSE;
+        }
+      }
+    }
+
+    FREE ( dir );
+    FREE ( ev );
+    FREE ( sg );
+    FREE ( pt );
+    return ret ;
   }
 
 
@@ -159,7 +608,7 @@
     \param nelem count of elements
     \return pointer to created spherical polygon
   */
-  static SPOLY * spherepoly_from_array ( SPoint * arr, int32 nelem )
+  PGS_KERNEL SPOLY * spherepoly_from_array ( SPoint * arr, int32 nelem )
   {
 
     SPOLY  * poly = NULL;
@@ -169,8 +618,8 @@
       return NULL;
     } else {
 
-      static int32  i;
-      static float8 scheck ;
+      int32  i;
+      float8 scheck ;
       int32      size;
 
       for ( i=0; i<nelem ; i++ ){
@@ -232,34 +681,13 @@
   }
 
 
-  /*!
-    \brief Does a transformation of polygon using Euler transformation 
-    \param se pointer to Euler transformation
-    \param in pointer to polygon
-    \param out pointer to transformed polygon
-    \return pointer to transformed polygon
-  */
-  static SPOLY  * euler_spoly_trans ( SPOLY * out , const SPOLY  * in , const SEuler * se )
-  {
-    int32 i;
-
-    out->size = in->size;
-    out->npts = in->npts;
-    for ( i=0; i<in->npts ; i++ ){
-      euler_spoint_trans ( &out->p[i] , &in->p[i] , se );
-    }
-    return out ;
-  }
-
-
-
   /*!
     \brief Returns the relationship between polygon and circle
     \param circ pointer to circle
     \param poly pointer to polygon
     \return relationship as a \link PGS_CIRCLE_POLY_REL int8 value \endlink (\ref PGS_CIRCLE_POLY_REL )
   */
-  static int8  poly_circle_pos ( const SPOLY * poly, const SCIRCLE * circ )
+  PGS_KERNEL int8  poly_circle_pos ( const SPOLY * poly, const SCIRCLE * circ )
   {
   
      int8    pos = 0;
@@ -315,7 +743,7 @@
     \param poly pointer to polygon
     \return relationship as a \link PGS_ELLIPSE_POLY_REL int8 value \endlink (\ref PGS_ELLIPSE_POLY_REL )
   */
-  static int8  poly_ellipse_pos ( const SPOLY * poly, const SELLIPSE * ell )
+  PGS_KERNEL int8  poly_ellipse_pos ( const SPOLY * poly, const SELLIPSE * ell )
   {
      int8    pos = 0;
      int32     i ;
@@ -386,7 +814,7 @@
     \param recheck swap p1 and p2
     \return relationship as a \link PGS_POLY_REL int8 value \endlink (\ref PGS_POLY_REL )
   */
-  static int8  poly_poly_pos ( const SPOLY * p1, const SPOLY * p2 , bool recheck)
+  PGS_KERNEL int8  poly_poly_pos ( const SPOLY * p1, const SPOLY * p2 , bool recheck)
   {
      int32     i ;
      SLine    sl ;
@@ -474,13 +902,47 @@
   }
 
 
+  /*!
+    Does the same as spoint_at_sline, but with the vectors of
+    the edge.
+    \brief Checks whether a point is on a polygon edge
+    \param p vector of point
+    \param a vector of edge begin
+    \param b vector of edge end
+    \return true, if point is on the edge
+  */
+  static bool spoly_vector_at_edge ( Vector3D * p, Vector3D * a, Vector3D * b )
+  {
+    Vector3D n, t;
+    float8   l, lng;
+
+    vector3d_cross ( &n, a, b );
+    l = vector3d_length ( &n );
+    if ( FPzero ( l ) || ! FPzero ( asin ( vector3d_scalar ( p, &n ) / l ) ) ){
+      return FALSE;
+    }
+    // t is the direction of the edge at its begin
+    vector3d_cross ( &t, &n, a );
+    lng = atan2 ( vector3d_scalar ( p, &t ) / l, vector3d_scalar ( p, a ) );
+    if ( lng < 0.0 ){
+      lng += PID;
+    }
+    return ( FPge ( lng, 0.0 ) && FPle ( lng, atan2 ( l, vector3d_scalar ( a, b ) ) ) );
+  }
+
+
   bool spoly_contains_point ( const SPOLY * pg , const SPoint * sp )
   {
-    static int32   i;
-    static SLine   sl;
-    bool    res = FALSE ;
-    static float8  scp;
-    static Vector3D vc, vp;
+    int32    i, cntr;
+    int32    n = pg->npts;
+    uint32   seed = 1;
+    float8   scp, sa, ca, y;
+    Vector3D vc, vp;
+    Vector3D * v;
+    SEuler   se;
+    SEulerMatrix m;
+
+    PGS_STAT_INC ( PGS_STAT_SPOLY_CONT_POINT );
 
     // First check, if point is outside polygon (behind)
     spherepoly_center  ( &vc , pg );
@@ -491,115 +953,83 @@
     }
 
     // Check whether point is edge
-    for ( i=0; i<pg->npts; i++ ){
+    for ( i=0; i<n; i++ ){
       if ( spoint_eq ( &pg->p[i] , sp ) ){
         return TRUE;
       }
     }
-    
+
     // Check whether point is on a line segment
-    for ( i=0; i<pg->npts; i++ ){
-      spoly_segment ( &sl , pg , i );
-      if ( spoint_at_sline( sp, &sl ) ){
+    v = ( Vector3D * ) MALLOC ( sizeof ( Vector3D ) * n );
+    for ( i=0; i<n; i++ ){
+      spoint_vector3d ( &v[i] , &pg->p[i] );
+    }
+    for ( i=0; i<n; i++ ){
+      if ( spoly_vector_at_edge ( &vp, &v[i], &v[(i+1)%n] ) ){
+        FREE ( v );
         return TRUE;
       }
     }
 
-    do {
-
-      SEuler se, te;
-      SPoint p , lp[2];
-      bool   a1, a2, eqa ;
-      int32  cntr = 0;
-      SPOLY * tmp = ( SPOLY * ) MALLOC ( VARSIZE(pg) );
-
-      /*
-        Make a transformation, so point is (0,0)
-      */
-
-      se.phi_a   = EULER_AXIS_Z  ;
-      se.theta_a = EULER_AXIS_X  ;
-      se.psi_a   = EULER_AXIS_Z  ;
-      se.phi     = PIH - sp->lng ;
-      se.theta   = - sp->lat     ;
-      se.psi     = -PIH          ;
-
-      euler_spoly_trans ( tmp , pg , &se );
-
-      p.lng = 0.0;
-      p.lat = 0.0;
-
-      // Check, whether an edge is on equator.
-      // If yes, rotate randomized around 0,0
-
-      cntr = 0;
-      do {
-        eqa = FALSE;
-        for ( i=0; i<pg->npts; i++ ){
-          if ( FPzero(tmp->p[i].lat) ){
-            if ( FPeq( cos(tmp->p[i].lng) , -1.0 ) ){
-              return false;
-            } else {
-              eqa = TRUE;
-              break;
-            }
-          }
-        }
-        if ( eqa ){
-          SPOLY * ttt = ( SPOLY * ) MALLOC ( VARSIZE(pg) );
-          srand( cntr );
-          se.phi_a   = se.theta_a = se.psi_a = EULER_AXIS_X  ;
-          se.phi     = ( (double) rand() / RAND_MAX ) * PID ;
-          se.theta   = 0.0  ;
-          se.psi     = 0.0  ;
-          euler_spoly_trans ( ttt , tmp , &se );
-          memcpy ( (void*) tmp, (void*) ttt, VARSIZE(pg) );
-          FREE(ttt);
-        }
-        if ( cntr>10000 ){
-          elog(WARNING ,"Bug found in spoly_contains_point");
-          elog(ERROR   ,"Please report it to pg_sphere team!");
-          return false;
-        }
-        cntr++;
-      } while ( eqa );
-
-      // Count line segment crossing "equator"
-
-      cntr = 0;
-      for ( i=0; i<pg->npts; i++ ){
-
-        // create a single line from segment
-        spoly_segment ( &sl , tmp , i );
-
-        sline_begin ( &lp[0], &sl );
-        sline_end   ( &lp[1], &sl );
-
-        a1  = ( FPgt(lp[0].lat,0.0) && FPlt(lp[1].lat,0.0) );
-        a2  = ( FPlt(lp[0].lat,0.0) && FPgt(lp[1].lat,0.0) );
+    /*
+      Make a transformation, so point is (0,0)
+    */
+    se.phi_a   = EULER_AXIS_Z  ;
+    se.theta_a = EULER_AXIS_X  ;
+    se.psi_a   = EULER_AXIS_Z  ;
+    se.phi     = PIH - sp->lng ;
+    se.theta   = - sp->lat     ;
+    se.psi     = -PIH          ;
+    seuler_matrix ( &m , &se );
+    for ( i=0; i<n; i++ ){
+      euler_matrix_vector_trans ( &v[i] , &v[i] , &m );
+    }
 
-        if ( a1 || a2 ){ // if crossing
-          sphereline_to_euler_inv ( &te, &sl );
-          if ( a2 ){ // crossing ascending 
-            p.lng = PID - te.phi;
-          } else {
-            p.lng = PI - te.phi;
-          }
-          spoint_check ( &p );
-          if ( p.lng < PI ){ // crossing between 0 and 180 deg
-            cntr++;
-          }
-        }          
+    // Check, whether an edge is on equator.
+    // If yes, rotate randomized around 0,0
+    for ( cntr=0; ; cntr++ ){
+      for ( i=0; i<n && ! FPzero ( v[i].z ); i++ );
+      if ( i == n ){
+        break;
       }
+      if ( FPeq ( v[i].x , -1.0 ) ){
+        FREE ( v );
+        return false;
+      }
+      if ( cntr>10000 ){
+        FREE ( v );
+        elog(WARNING ,"Bug found in spoly_contains_point");
+        elog(ERROR   ,"Please report it to pg_sphere team!");
+        return false;
+      }
+      PGS_STAT_INC ( PGS_STAT_SPOLY_CONT_RETRY );
+      seed = seed * 1103515245 + 12345 ;
+      sa   = sin ( ( seed / 4294967296.0 ) * PID );
+      ca   = cos ( ( seed / 4294967296.0 ) * PID );
+      for ( i=0; i<n; i++ ){
+        y      = ca * v[i].y - sa * v[i].z ;
+        v[i].z = sa * v[i].y + ca * v[i].z ;
+        v[i].y = y;
+      }
+    }
 
-      FREE ( tmp );
-      if ( cntr % 2 ){
-        res = TRUE;
-      }        
-
-    } while (0);
+    // Count line segment crossing "equator" between 0 and 180 deg
+    cntr = 0;
+    for ( i=0; i<n; i++ ){
+      const Vector3D * a = &v[i];
+      const Vector3D * b = &v[(i+1)%n];
+      if ( ( FPgt ( a->z, 0.0 ) && FPlt ( b->z, 0.0 ) ) ||
+           ( FPlt ( a->z, 0.0 ) && FPgt ( b->z, 0.0 ) ) ){
+        // the crossing point, a positive combination of a and b
+        y = fabs ( a->z ) * b->y + fabs ( b->z ) * a->y ;
+        if ( y > 0.0 || ( y == 0.0 && fabs ( a->z ) * b->x + fabs ( b->z ) * a->x > 0.0 ) ){
+          cntr++;
+        }
+      }
+    }
+    FREE ( v );
 
-    return res;
+    return ( cntr % 2 ) ? TRUE : FALSE ;
   }
 
   /*!
@@ -610,10 +1040,10 @@
   */
   int8  poly_line_pos ( const SPOLY * poly, const SLine * line )
   {
-     static int32     i ;
-     static SLine    sl ;
-     static SPoint   slbeg, slend ;
-     static int8  p1 , p2 , pos , res ;
+     int32     i ;
+     SLine    sl ;
+     SPoint   slbeg, slend ;
+     int8  p1 , p2 , pos , res ;
 
      const static int8 sl_os = ( 1 << PGS_LINE_AVOID      );
      const static int8 sl_cl = ( 1 << PGS_LINE_CONT_LINE  );
@@ -642,7 +1072,7 @@
         }
         // Recheck line crossing
         if ( pos == sl_cr ){
-          static bool bal, eal;
+          bool bal, eal;
           bal = spoint_at_sline(&slbeg, &sl);
           eal = spoint_at_sline(&slend, &sl);
           if ( !bal && !eal )
@@ -669,33 +1099,226 @@
   }  
 
 
+  /*!
+    \brief Writes an offset as zigzag coded integer of variable length
+    \param d pointer to buffer
+    \param v offset
+    \return pointer behind the written bytes
+  */
+  static uchar * spherepoints_put ( uchar * d, int64 v )
+  {
+    uint64 u = ( ( uint64 ) v << 1 ) ^ ( uint64 ) ( v >> 63 );
+    while ( u >= 0x80 ){
+      *d++ = ( uchar ) ( u | 0x80 );
+      u  >>= 7;
+    }
+    *d++ = ( uchar ) u;
+    return d;
+  }
+
+  /*!
+    \brief Reads an offset written by spherepoints_put
+    \param d   pointer to buffer
+    \param end end of buffer
+    \param v   pointer to offset
+    \return pointer behind the read bytes
+  */
+  static const uchar * spherepoints_get ( const uchar * d, const uchar * end, int64 * v )
+  {
+    uint64 u = 0;
+    int    s = 0;
+    do {
+      if ( d >= end || s > 63 ){
+        elog ( ERROR , "spherepoints_unpack: invalid packed value" );
+      }
+      u |= ( uint64 ) ( *d & 0x7F ) << s;
+      s += 7;
+    } while ( *d++ & 0x80 );
+    *v = ( int64 ) ( u >> 1 ) ^ - ( int64 ) ( u & 1 );
+    return d;
+  }
+
+  SPACKED * spherepoints_pack ( const SPoint * p, int32 npts, float8 unit )
+  {
+    SPACKED * pk;
+    uchar   * d;
+    int32     i, size;
+    int64     ql = 0, qb = 0, nl, nb;
+    float8    dl;
+
+    if ( npts < 2 || ! ( unit >= PGS_PACKED_UNIT_MIN ) ){
+      return NULL;
+    }
+    /* an offset has 10 bytes at most */
+    pk = ( SPACKED * ) MALLOC ( offsetof(SPACKED, data[0]) + 20 * ( npts - 1 ) );
+    pk->unit = unit;
+    memcpy ( (void*) &pk->ref, (void*) &p[0], sizeof ( SPoint ) );
+    d = pk->data;
+    for ( i=1; i<npts; i++ ){
+      /* the shorter way around in longitude */
+      dl = p[i].lng - p[0].lng;
+      if ( dl < -PI ){
+        dl += PID;
+      } else if ( dl >= PI ){
+        dl -= PID;
+      }
+      nl = ( int64 ) rint ( dl / unit );
+      nb = ( int64 ) rint ( ( p[i].lat - p[0].lat ) / unit );
+      d  = spherepoints_put ( d, nl - ql );
+      d  = spherepoints_put ( d, nb - qb );
+      ql = nl;
+      qb = nb;
+    }
+
+    size = d - ( uchar * ) pk;
+    if ( size >= offsetof(SPOLY, p[0]) + sizeof(SPoint) * npts ){
+      FREE ( pk );
+      return NULL;
+    }
+#if PG_VERSION_NUM < 80300
+    pk->size = size;
+#else
+    SET_VARSIZE(pk, size);
+#endif
+    pk->npts = npts | PGS_PACKED;
+    return pk;
+  }
+
+  void * spherepoints_unpack ( void * v )
+  {
+    const SPACKED * pk = ( const SPACKED * ) v;
+    const uchar   * d, * end;
+    SPOLY         * sp;
+    int32           i, n, size;
+    int64           ql = 0, qb = 0, dq;
+
+    if ( ! ( pk->npts & PGS_PACKED ) ){
+      return v;
+    }
+    n    = pk->npts & ~PGS_PACKED;
+    size = offsetof(SPOLY, p[0]) + sizeof(SPoint) * n;
+    sp   = ( SPOLY * ) MALLOC ( size );
+#if PG_VERSION_NUM < 80300
+    sp->size = size;
+#else
+    SET_VARSIZE(sp, size);
+#endif
+    sp->npts = n;
+    memcpy ( (void*) &sp->p[0], (void*) &pk->ref, sizeof ( SPoint ) );
+    d   = pk->data;
+    end = ( const uchar * ) pk + VARSIZE(pk);
+    for ( i=1; i<n; i++ ){
+      d  = spherepoints_get ( d, end, &dq );
+      ql += dq;
+      d  = spherepoints_get ( d, end, &dq );
+      qb += dq;
+      sp->p[i].lng = pk->ref.lng + ql * pk->unit;
+      sp->p[i].lat = pk->ref.lat + qb * pk->unit;
+      /* rounding must not move a point across the pole */
+      if ( sp->p[i].lat > PIH ){
+        sp->p[i].lat = PIH;
+      } else if ( sp->p[i].lat < -PIH ){
+        sp->p[i].lat = -PIH;
+      }
+      spoint_check ( &sp->p[i] );
+    }
+    return sp;
+  }
+
+
+#ifndef PGS_CORE
   Datum  spherepoly_in(PG_FUNCTION_ARGS)
   {
     SPOLY * poly ;
     char  * c  = PG_GETARG_CSTRING(0);
-    static int32  i, nelem;
-
-    void sphere_yyparse( void );
-    init_buffer ( c );
-    sphere_yyparse() ;
+    int32  i, nelem;
+    SParseBuffer * pb = sphere_parse ( c );
 
-    nelem = get_path_count( ) ;
+    nelem = get_path_count( pb ) ;
     if ( nelem > 2 ){
       SPoint arr[nelem];
       for ( i = 0; i<nelem ; i++ ){
-         get_path_elem ( i , &arr[i].lng , &arr[i].lat );
+         get_path_elem ( pb, i , &arr[i].lng , &arr[i].lat );
       }
       poly  = spherepoly_from_array ( &arr[0], nelem );
     } else {
-      reset_buffer();
       elog ( ERROR , "spherepoly_in: more than two points needed" );
       PG_RETURN_NULL();
     }
-    reset_buffer();
+    free_buffer ( pb );
+
+    PG_RETURN_POINTER( poly );
+  }
+
+  Datum  spherepoly_recv(PG_FUNCTION_ARGS)
+  {
+    StringInfo buf = ( StringInfo ) PG_GETARG_POINTER(0);
+    SPOLY   * poly ;
+    SPoint   * arr ;
+    int32      i, nelem;
+
+    nelem = pq_getmsgint ( buf, sizeof ( int32 ) );
+    if ( nelem < 0 || nelem > ( buf->len - buf->cursor ) / ( int32 ) ( 2 * sizeof ( float8 ) ) ){
+      elog ( ERROR , "spherepoly_recv: invalid number of points" );
+      PG_RETURN_NULL();
+    }
+    arr = ( SPoint * ) MALLOC ( sizeof ( SPoint ) * max ( nelem, 1 ) );
+    for ( i = 0; i<nelem ; i++ ){
+      arr[i].lng = pgs_getmsgfloat8 ( buf );
+      arr[i].lat = pgs_getmsgfloat8 ( buf );
+    }
+    poly = spherepoly_from_array ( arr, nelem );
+    FREE ( arr );
+
+    PG_RETURN_POINTER( poly );
+  }
+
+  Datum  spherepoly_send(PG_FUNCTION_ARGS)
+  {
+    SPOLY   * poly = PG_GETARG_SPOLY( 0 ) ;
+    StringInfoData buf;
+    int32      i;
+
+    pq_begintypsend ( &buf );
+    pq_sendint ( &buf, poly->npts, sizeof ( int32 ) );
+    for ( i = 0; i<poly->npts ; i++ ){
+      spoint_sendmsg ( &buf, &poly->p[i] );
+    }
+    PG_RETURN_BYTEA_P( pq_endtypsend ( &buf ) );
+  }
+
+  Datum  spherepoly_from_arrays(PG_FUNCTION_ARGS)
+  {
+    ArrayType * lng = PG_GETARG_ARRAYTYPE_P ( 0 );
+    ArrayType * lat = PG_GETARG_ARRAYTYPE_P ( 1 );
+    SPOLY   * poly ;
+    SPoint   * arr ;
+    int32      nelem;
+
+    arr  = spoint_array_from_float8 ( lng, lat, &nelem );
+    poly = spherepoly_from_array ( arr, nelem );
+    if ( arr ){
+      FREE ( arr );
+    }
+    PG_RETURN_POINTER( poly );
+  }
 
+  Datum  spherepoly_from_points(PG_FUNCTION_ARGS)
+  {
+    ArrayType * pts = PG_GETARG_ARRAYTYPE_P ( 0 );
+    SPOLY   * poly ;
+    SPoint   * arr ;
+    int32      nelem;
+
+    arr  = spoint_array_from_spoint ( pts, &nelem );
+    poly = spherepoly_from_array ( arr, nelem );
+    if ( arr ){
+      FREE ( arr );
+    }
     PG_RETURN_POINTER( poly );
   }
 
+
   Datum  spherepoly_equal(PG_FUNCTION_ARGS)
   {
     SPOLY  * p1 = PG_GETARG_SPOLY( 0 ) ;
@@ -1071,6 +1694,27 @@
     PG_RETURN_BOOL ( poly_ellipse_pos ( poly, ell ) == PGS_ELLIPSE_POLY_AVOID );
   }
 
+  /*!
+    \brief Does a transformation of polygon using Euler transformation 
+    \param se pointer to Euler transformation
+    \param in pointer to polygon
+    \param out pointer to transformed polygon
+    \return pointer to transformed polygon
+  */
+  static SPOLY  * euler_spoly_trans ( SPOLY * out , const SPOLY  * in , const SEuler * se )
+  {
+    int32 i;
+    SEulerMatrix m;
+
+    out->size = in->size;
+    out->npts = in->npts;
+    seuler_matrix ( &m , se );
+    for ( i=0; i<in->npts ; i++ ){
+      euler_matrix_spoint_trans ( &out->p[i] , &in->p[i] , &m );
+    }
+    return out ;
+  }
+
   Datum  spheretrans_poly(PG_FUNCTION_ARGS)
   {
     SPOLY   * sp  =  PG_GETARG_SPOLY ( 0 ) ;
@@ -1093,6 +1737,53 @@
     PG_RETURN_DATUM( ret );
   }
 
+  Datum  spherepoly_pack(PG_FUNCTION_ARGS)
+  {
+    SPOLY   * poly = PG_GETARG_SPOLY ( 0 ) ;
+    float8    unit = PG_GETARG_FLOAT8 ( 1 ) ;
+    SPACKED * pk;
+    SPOLY   * up;
+    int32     i;
+    bool      valid;
+
+    if ( ! ( unit > 0.0 ) || isinf ( unit ) ){
+      elog ( ERROR , "spherepoly_pack: precision must be a positive number" );
+    }
+    if ( unit < PGS_PACKED_UNIT_MIN ){
+      elog ( ERROR , "spherepoly_pack: precision must be at least %g", PGS_PACKED_UNIT_MIN );
+    }
+    pk = spherepoints_pack ( poly->p, poly->npts, unit );
+    if ( pk == NULL ){
+      PG_RETURN_POINTER ( poly );
+    }
+
+    /* the unpacked polygon must be valid as the input */
+    up    = ( SPOLY * ) spherepoints_unpack ( pk );
+    valid = TRUE;
+    for ( i=0; i<up->npts && valid; i++ ){
+      const SPoint * prev = &up->p[ ( i > 0 ) ? ( i - 1 ) : ( up->npts - 1 ) ];
+      if ( spoint_eq ( prev, &up->p[i] ) || FPeq ( spoint_dist ( prev, &up->p[i] ), PI ) ){
+        valid = FALSE;
+      }
+    }
+    valid = valid && spherepoly_check ( up );
+    FREE ( up );
+    if ( ! valid ){
+      FREE ( pk );
+      PG_RETURN_POINTER ( poly );
+    }
+    PG_RETURN_POINTER ( pk );
+  }
+
+  Datum  spherepoly_unpack(PG_FUNCTION_ARGS)
+  {
+    PG_RETURN_POINTER ( PG_GETARG_SPOLY ( 0 ) );
+  }
+#endif
+
+#if PG_VERSION_NUM < 80400
+
+#ifndef PGS_CORE
   Datum  spherepoly_add_point(PG_FUNCTION_ARGS)
   {
     SPOLY   * poly  =  ( SPOLY   * ) PG_GETARG_POINTER ( 0 ) ;
@@ -1127,11 +1818,12 @@
     if ( FPeq ( spoint_dist ( p, &poly->p[ poly->npts - 1 ]) , PI ) )
     {
       elog ( NOTICE , "spoly(spoint): Skip point, distance of previous point is 180deg" );
+      PG_RETURN_POINTER ( poly );
     }
 
     size = offsetof(SPOLY, p[0]) + sizeof(SPoint) * ( poly->npts + 1 );
     poly_new = palloc( size );
-    memcpy( (void*) poly , (void*) poly_new, VARSIZE(poly) );
+    memcpy( (void*) poly_new , (void*) poly, VARSIZE(poly) );
     poly_new->npts++;
 
 #if PG_VERSION_NUM < 80300
@@ -1174,3 +1866,217 @@
     }
     PG_RETURN_POINTER ( poly );
   }
+#endif
+
+#else
+
+#ifndef PGS_CORE
+  Datum  spherepoly_add_point(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf = ( PG_ARGISNULL ( 0 ) ) ? NULL : ( SPointBuffer * ) PG_GETARG_POINTER ( 0 ) ;
+    SPoint       * p   = ( PG_ARGISNULL ( 1 ) ) ? NULL : ( SPoint * ) PG_GETARG_POINTER ( 1 ) ;
+
+    if ( p == NULL ){
+      if ( buf == NULL ){
+        PG_RETURN_NULL ( );
+      }
+      PG_RETURN_POINTER ( buf );
+    }
+
+    if ( buf != NULL ){
+      // skip if equal
+      if ( spoint_eq ( p, &buf->p[ buf->npts - 1 ] ) ){
+        PG_RETURN_POINTER ( buf );
+      }
+      // Skip if distance is equal 180deg
+      if ( FPeq ( spoint_dist ( p, &buf->p[ buf->npts - 1 ] ) , PI ) )
+      {
+        elog ( NOTICE , "spoly(spoint): Skip point, distance of previous point is 180deg" );
+        PG_RETURN_POINTER ( buf );
+      }
+    }
+
+    buf = spoint_buffer_add ( fcinfo, buf, p );
+    PG_RETURN_POINTER ( buf );
+  }
+
+
+  Datum  spherepoly_add_points_finalize(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf = ( PG_ARGISNULL ( 0 ) ) ? NULL : ( SPointBuffer * ) PG_GETARG_POINTER ( 0 ) ;
+    SPOLY        * poly ;
+    int32          npts, size ;
+
+    if ( buf == NULL ){
+      PG_RETURN_NULL ( );
+    }
+
+    // remove closing point
+    npts = buf->npts;
+    if ( npts > 1 && spoint_eq ( &buf->p[0], &buf->p[ npts - 1 ] ) ){
+      npts--;
+    }
+
+    if ( npts < 3 ){
+      elog ( NOTICE , "spoly(spoint): At least 3 points required" );
+      PG_RETURN_NULL ( );
+    }
+    // Skip if distance is equal 180deg
+    if ( FPeq ( spoint_dist ( &buf->p[0], &buf->p[ npts - 1 ]) , PI ) )
+    {
+      elog ( NOTICE , "spoly(spoint): Cannot close polygon. Distance between first and last point is 180deg" );
+      PG_RETURN_NULL ( );
+    }
+
+    size = offsetof(SPOLY, p[0]) + sizeof(SPoint) * npts ;
+    poly = ( SPOLY * ) MALLOC ( size );
+    SET_VARSIZE( poly, size );
+    poly->npts = npts;
+    memcpy( (void*) &poly->p[0] , (void*) buf->p, sizeof(SPoint) * npts );
+
+    if ( !spherepoly_check ( poly ) ){
+      elog ( NOTICE , "spoly(spoint): a line segment overlaps or polygon too large" );
+      FREE ( poly ) ;
+      PG_RETURN_NULL();
+    }
+    PG_RETURN_POINTER ( poly );
+  }
+#endif
+
+
+
+  /*!
+    \brief a point projected to the tangent plane
+  */
+  typedef struct {
+    float8  p[2]; //!< plane coordinates
+    int32   i;    //!< index of spherical point
+  } PHULLPOINT;
+
+  /*!
+    \brief order of projected points, by first and second coordinate
+  */
+  static int phull_point_cmp ( const void * a, const void * b )
+  {
+    return psweep_pt_cmp ( ( ( const PHULLPOINT * ) a )->p, ( ( const PHULLPOINT * ) b )->p );
+  }
+
+  /*!
+    \brief checks whether the points a, b, c make a left turn in the plane
+  */
+  static bool phull_left_turn ( const PHULLPOINT * a, const PHULLPOINT * b, const PHULLPOINT * c )
+  {
+    return ( ( b->p[0] - a->p[0] ) * ( c->p[1] - a->p[1] ) -
+             ( b->p[1] - a->p[1] ) * ( c->p[0] - a->p[0] ) ) > 0.0 ;
+  }
+
+
+#ifndef PGS_CORE
+  Datum  spherepoly_hull_finalize(PG_FUNCTION_ARGS)
+  {
+    SPointBuffer * buf = ( SPointBuffer * ) PG_GETARG_POINTER ( 0 );
+    int32          n   = buf->npts;
+    int32          i, k, t, size ;
+    Vector3D     * v, c, e1, e2 ;
+    float8         radius, z ;
+    PHULLPOINT   * pt ;
+    int32        * h ;
+    SPOLY        * poly ;
+
+    // The points are inside a circle smaller than a hemisphere, so
+    // the gnomonic projection around its center maps the spherical
+    // hull to the plane hull.
+    v = ( Vector3D * ) MALLOC ( sizeof ( Vector3D ) * n );
+    for ( i=0; i<n; i++ ){
+      spoint_vector3d ( &v[i], &buf->p[i] );
+    }
+    if ( ! scircle_min_enclosing ( &c, &radius, v, n ) || ! FPlt ( radius, PIH ) ){
+      elog ( NOTICE , "spoly_hull(spoint): points do not fit into a hemisphere" );
+      FREE ( v );
+      PG_RETURN_NULL ( );
+    }
+    FREE ( v );
+
+    e1.x = e1.y = e1.z = 0.0;
+    if ( fabs(c.x) <= fabs(c.y) && fabs(c.x) <= fabs(c.z) ){
+      e1.x = 1.0;
+    } else if ( fabs(c.y) <= fabs(c.z) ){
+      e1.y = 1.0;
+    } else {
+      e1.z = 1.0;
+    }
+    vector3d_cross ( &e2, &c, &e1 );
+    z    = vector3d_length ( &e2 );
+    e2.x /= z ;
+    e2.y /= z ;
+    e2.z /= z ;
+    vector3d_cross ( &e1, &e2, &c );
+
+    pt = ( PHULLPOINT * ) MALLOC ( sizeof ( PHULLPOINT ) * n );
+    for ( i=0; i<n; i++ ){
+      Vector3D p;
+      spoint_vector3d ( &p, &buf->p[i] );
+      z = vector3d_scalar ( &p, &c );
+      pt[i].p[0] = vector3d_scalar ( &p, &e1 ) / z ;
+      pt[i].p[1] = vector3d_scalar ( &p, &e2 ) / z ;
+      pt[i].i    = i;
+    }
+    qsort ( (void*) pt, n, sizeof ( PHULLPOINT ), phull_point_cmp );
+
+    // Andrew's monotone chain, lower hull first, then upper hull
+    h = ( int32 * ) MALLOC ( sizeof ( int32 ) * ( 2 * n + 1 ) );
+    k = 0;
+    for ( i=0; i<n; i++ ){
+      while ( k >= 2 && ! phull_left_turn ( &pt[h[k-2]], &pt[h[k-1]], &pt[i] ) ){
+        k--;
+      }
+      h[k++] = i;
+    }
+    for ( i=n-2, t=k+1; i>=0; i-- ){
+      while ( k >= t && ! phull_left_turn ( &pt[h[k-2]], &pt[h[k-1]], &pt[i] ) ){
+        k--;
+      }
+      h[k++] = i;
+    }
+    // the last point equals the first one
+    k--;
+
+    // drop vertices equal to their predecessor
+    t = 0;
+    for ( i=0; i<k; i++ ){
+      if ( t > 0 && spoint_eq ( &buf->p[pt[h[i]].i], &buf->p[pt[h[t-1]].i] ) ){
+        continue;
+      }
+      h[t++] = h[i];
+    }
+    if ( t > 1 && spoint_eq ( &buf->p[pt[h[0]].i], &buf->p[pt[h[t-1]].i] ) ){
+      t--;
+    }
+
+    if ( t < 3 ){
+      elog ( NOTICE , "spoly_hull(spoint): points are on a line" );
+      FREE ( h );
+      FREE ( pt );
+      PG_RETURN_NULL ( );
+    }
+
+    size = offsetof(SPOLY, p[0]) + sizeof(SPoint) * t ;
+    poly = ( SPOLY * ) MALLOC ( size );
+    SET_VARSIZE( poly, size );
+    poly->npts = t;
+    for ( i=0; i<t; i++ ){
+      memcpy ( (void*) &poly->p[i], (void*) &buf->p[pt[h[i]].i], sizeof ( SPoint ) );
+    }
+    FREE ( h );
+    FREE ( pt );
+
+    if ( !spherepoly_check ( poly ) ){
+      elog ( NOTICE , "spoly_hull(spoint): a line segment overlaps or polygon too large" );
+      FREE ( poly ) ;
+      PG_RETURN_NULL();
+    }
+    PG_RETURN_POINTER ( poly );
+  }
+#endif
+
+#endif
@@ -22,6 +22,36 @@ typedef struct
 } SPOLY;
 
 
+/*!
+  \brief flag of packed polygons and paths in the count of points
+*/
+#define PGS_PACKED 0x40000000
+
+/*!
+  Offsets are at most PI, so with this unit every rounded offset
+  and every difference of two offsets fits into an int64.
+  \brief smallest unit of packed polygons and paths
+*/
+#define PGS_PACKED_UNIT_MIN ( PI / 2305843009213693952.0 )
+
+/*!
+  A packed polygon or path keeps the first point and the offsets
+  of the other points to their predecessors. The offsets are
+  multiples of the unit in longitude and latitude, written as
+  integers of variable length. The values are unpacked by
+  PG_GETARG_SPOLY and PG_GETARG_SPATH, so all functions read them.
+  \brief Packed spherical polygon or path
+*/
+typedef struct
+{
+  int32           size;   //!< total size in bytes
+  int32           npts;   //!< count of points and PGS_PACKED
+  float8          unit;   //!< the unit of offsets in radians
+  SPoint          ref;    //!< the first point
+  uchar           data[1]; //!< variable length array of offsets
+} SPACKED;
+
+
 /*!
   \addtogroup PGS_RELATIONSHIPS
   @{
@@ -70,7 +100,26 @@ typedef struct
 /*! @} */
 
 
-#define PG_GETARG_SPOLY( arg ) ( ( SPOLY  * ) DatumGetPointer( PG_DETOAST_DATUM( PG_GETARG_DATUM ( arg ) ) ) )
+#define PG_GETARG_SPOLY( arg ) ( ( SPOLY  * ) spherepoints_unpack ( DatumGetPointer( PG_DETOAST_DATUM( PG_GETARG_DATUM ( arg ) ) ) ) )
+
+  /*!
+    The points are rounded to multiples of the unit in longitude and
+    latitude relative to the first point, so a point moves by less
+    than the unit.
+    \brief Packs the points of a polygon or path
+    \param p    pointer to array of points
+    \param npts count of points
+    \param unit the unit of offsets in radians, at least PGS_PACKED_UNIT_MIN
+    \return pointer to packed value, NULL if it is not smaller
+  */
+  SPACKED * spherepoints_pack ( const SPoint * p, int32 npts, float8 unit );
+
+  /*!
+    \brief Unpacks a polygon or path
+    \param v pointer to polygon or path, packed or not
+    \return pointer to unpacked value, v if it is not packed
+  */
+  void * spherepoints_unpack ( void * v );
 
   /*!
     \brief Checks, whether two polygons are equal
@@ -113,6 +162,36 @@ typedef struct
   */
   Datum  spherepoly_in(PG_FUNCTION_ARGS);
 
+  /*!
+    \brief binary input function of spherical polygon
+    \return spherical polygon datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_recv(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief binary output function of spherical polygon
+    \return bytea datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_send(PG_FUNCTION_ARGS);
+
+  /*!
+    Creates a spherical polygon from arrays of longitudes
+    and latitudes both in radians
+    \brief polygon created from longitude and latitude arrays
+    \return spherical polygon datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_from_arrays(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief polygon created from an array of spherical points
+    \return spherical polygon datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_from_points(PG_FUNCTION_ARGS);
+
   /*!
     \brief Checks, whether two polygons are equal
     \return bool datum
@@ -456,6 +535,23 @@ typedef struct
   */
   Datum  spheretrans_poly_inverse(PG_FUNCTION_ARGS);
 
+  /*!
+    The polygon is returned unchanged, if the packed polygon is
+    not smaller or if the rounded points do not make a valid
+    polygon.
+    \brief Packs a polygon with a precision
+    \return Polygon datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_pack(PG_FUNCTION_ARGS);
+
+  /*!
+    \brief Unpacks a polygon
+    \return Polygon datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_unpack(PG_FUNCTION_ARGS);
+
   /*!
     State transition function for aggregate function spoly(spoint).
     Do never call this function outside an aggregate function!
@@ -472,4 +568,33 @@ typedef struct
   */
   Datum  spherepoly_add_points_finalize(PG_FUNCTION_ARGS);
 
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    The convex hull is computed in O(n log n) in the tangent
+    plane at the center of the smallest circle containing all
+    points. The result is NULL, if the points do not fit into a
+    hemisphere or if they are on one great circle.
+    \brief final function of spoly_hull aggregate
+    \return Polygon datum
+    \note PostgreSQL function
+  */
+  Datum  spherepoly_hull_finalize(PG_FUNCTION_ARGS);
+
+#endif
+
+#ifdef PGS_CORE
+
+  /*
+    Kernels of polygon.c, which are static in the extension. See
+    PGS_KERNEL and the documentation of the definitions.
+  */
+  SPOLY * spherepoly_from_array ( SPoint * arr, int32 nelem );
+  int8  poly_circle_pos ( const SPOLY * poly, const SCIRCLE * circ );
+  int8  poly_ellipse_pos ( const SPOLY * poly, const SELLIPSE * ell );
+  int8  poly_poly_pos ( const SPOLY * p1, const SPOLY * p2 , bool recheck );
+
+#endif
+
+
 #endif
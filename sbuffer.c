@@ -1,5 +1,6 @@
 #include "pg_sphere.h"
 #include "sbuffer.h"
+#include "stats.h"
 
 /*!
   \file
@@ -7,167 +8,112 @@
 */
 
 
-#define MAX_BUF_ANGLE   20  //!< maximum count of buffered angles
-
-  unsigned char spheretype;   //!< the type of parsed spherical object
-
-  float8 bufangle[MAX_BUF_ANGLE]; //!< the angle buffer
-
-  /*!
-    \brief a simple spherical point
-  */
-  typedef struct {
-    double          lng; //!< longitude
-    double          lat; //!< latitude
-  } bpoint;
-
-  //! spherical point buffer
-  struct {
-    int           m; //! count of buffered points
-    bpoint       *p; //! pointer to array of points
-  } bufpoints;
-
-  //! ID of line's length angle
-  int  bufline ;
-
-  /*!
-    First element is the ID of spherical point ( center ).
-    Second element is the ID of radius angle.
-    \brief Buffer of circle
-  */
-  int  bufcircle[2];
-
-  /*!
-    \brief Buffer of ellipse
-  */
-  int  bufellipse[5];
-
-  /*!
-    \brief Buffer of ID's of Euler transformation values
-  */
-  int  bufeuler[3];
-
-  //!  Structure to buffer the axes of Euler transformation
-  struct { 
-   unsigned char phi , //! first axis
-                theta, //! second axis
-                 psi ; //! third axis
-  } bufeulertype ;
-
-  //! Current angle ID
-  int bufapos ;
-
-  //! Current point ID
-  int bufspos ;
-
-  //! Pointer to input buffer
-  char * parse_buffer;
-
-  void set_spheretype ( unsigned char st )
+  SParseBuffer * sphere_parse ( const char * buffer )
   {
-    spheretype   = st;
+    SParseBuffer * pb = ( SParseBuffer * ) MALLOC ( sizeof ( SParseBuffer ) );
+
+    pb->input        = buffer ;
+    pb->spheretype   = STYPE_UNKNOWN;
+    pb->bufapos      = 0;
+    pb->bufspos      = 0;
+    pb->maxpoints    = MIN_BUF_POINTS;
+    pb->bufpoints    = pb->pointbuf;
+    pb->bufeulertype[0] = pb->bufeulertype[2] = EULER_AXIS_Z;
+    pb->bufeulertype[1] = EULER_AXIS_X;
+
+    PGS_STAT_INC ( PGS_STAT_PARSER );
+    sphere_yyparse ( pb );
+    return pb;
   }
 
 
-  void init_buffer ( char * buffer )
+  void free_buffer ( SParseBuffer * pb )
   {
-
-    spheretype   = STYPE_UNKNOWN;
-    parse_buffer = buffer ;
-
-    bufapos      = 0;
-    bufspos      = 0;
-    bufeulertype.phi   = bufeulertype.psi = EULER_AXIS_Z;
-    bufeulertype.theta = EULER_AXIS_X;
-    
-    bufpoints.m  = 2;
-    bufpoints.p  = ( bpoint * ) MALLOC (  bufpoints.m * sizeof ( bpoint ) );
-
+    if ( pb->bufpoints != pb->pointbuf ){
+      FREE ( pb->bufpoints );
+    }
+    FREE ( pb );
   }
 
 
-  void reset_buffer( void )
+  void set_spheretype ( SParseBuffer * pb, unsigned char st )
   {
-    sphere_flush_scanner_buffer();
-    FREE ( bufpoints.p );
-    bufpoints.p = NULL;
-    bufpoints.m = 0;
-    init_buffer( NULL );
+    pb->spheretype   = st;
   }
 
 
-  int  set_angle_sign ( int apos   , int s )
+  int  set_angle_sign ( SParseBuffer * pb, int apos   , int s )
   {
-    if ( bufangle[apos] > 0 && s<0 ){
-      bufangle[apos] *= -1;
+    if ( pb->bufangle[apos] > 0 && s<0 ){
+      pb->bufangle[apos] *= -1;
     }
-    if ( bufangle[apos] < 0 && s>0 ){
-      bufangle[apos] *= -1;
+    if ( pb->bufangle[apos] < 0 && s>0 ){
+      pb->bufangle[apos] *= -1;
     }
     return apos;
   }
 
-  int set_angle ( unsigned char is_deg , float8 a )
+  int set_angle ( SParseBuffer * pb, unsigned char is_deg , float8 a )
   {
     if ( is_deg ){
       a /= RADIANS ;
     }
-    bufangle[bufapos] = a;
-    bufapos++;
-    return ( bufapos - 1 );
+    pb->bufangle[pb->bufapos] = a;
+    pb->bufapos++;
+    return ( pb->bufapos - 1 );
   }
 
-  int set_point ( int lngpos , int latpos )
+  int set_point ( SParseBuffer * pb, int lngpos , int latpos )
   {
 
-      if ( bufspos >= bufpoints.m ){
-      	bpoint * p = bufpoints.p;
-      	int      i = ( bufpoints.m * 2 ) ;
-      	bufpoints.p = ( bpoint * ) MALLOC ( i * sizeof (bpoint) );
-          memcpy ( (void*) bufpoints.p, (void*) p, bufpoints.m * sizeof (bpoint) );
-          bufpoints.m = i;
+      if ( pb->bufspos >= pb->maxpoints ){
+        bpoint * p = pb->bufpoints;
+        int      i = ( pb->maxpoints * 2 ) ;
+        pb->bufpoints = ( bpoint * ) MALLOC ( i * sizeof (bpoint) );
+        memcpy ( (void*) pb->bufpoints, (void*) p, pb->maxpoints * sizeof (bpoint) );
+        pb->maxpoints = i;
+        if ( p != pb->pointbuf ){
           FREE( p );
+        }
       }
-      bufpoints.p[bufspos].lng         = bufangle[lngpos];
-      bufpoints.p[bufspos].lat         = bufangle[latpos];
-      bufspos++;
-      lngpos  = 0;
-      latpos  = 0;
-      if ( ( bufapos + 3 ) > MAX_BUF_ANGLE ){
-        bufapos = 0;
+      pb->bufpoints[pb->bufspos].lng   = pb->bufangle[lngpos];
+      pb->bufpoints[pb->bufspos].lat   = pb->bufangle[latpos];
+      pb->bufspos++;
+      if ( ( pb->bufapos + 3 ) > MAX_BUF_ANGLE ){
+        pb->bufapos = 0;
       }
-      return ( bufspos - 1 );
+      return ( pb->bufspos - 1 );
   }
 
-  void set_circle ( int spos , int rpos )
+  void set_circle ( SParseBuffer * pb, int spos , int rpos )
   {
-      bufcircle[0] = spos;
-      bufcircle[1] = rpos;
+      pb->bufcircle[0] = spos;
+      pb->bufcircle[1] = rpos;
   }
 
 
-  void set_ellipse ( int r1, int r2, int sp , int inc )
+  void set_ellipse ( SParseBuffer * pb, int r1, int r2, int sp , int inc )
   {
-      bufellipse[0] = r1;
-      bufellipse[1] = r2;
-      bufellipse[2] = sp;
-      bufellipse[3] = inc;
+      pb->bufellipse[0] = r1;
+      pb->bufellipse[1] = r2;
+      pb->bufellipse[2] = sp;
+      pb->bufellipse[3] = inc;
   }          
 
 
-  void set_line ( int length )
+  void set_line ( SParseBuffer * pb, int length )
   {
-      bufline = length;
+      pb->bufline = length;
   }
 
-  void set_euler ( int phi, int theta , int psi , char * etype )
+  void set_euler ( SParseBuffer * pb, int phi, int theta , int psi , char * etype )
   {
       int i ;
       unsigned char t = 0 ;
       
-      bufeuler[0] = phi;
-      bufeuler[1] = theta;
-      bufeuler[2] = psi;
+      pb->bufeuler[0] = phi;
+      pb->bufeuler[1] = theta;
+      pb->bufeuler[2] = psi;
       for ( i=0; i<3; i++ ){
         switch ( etype[i] ){
           case 'x': 
@@ -177,100 +123,88 @@
           case 'z':
           case 'Z': t = EULER_AXIS_Z; break; 
         }
-        switch ( i ){
-          case 0:  bufeulertype.phi   = t; break;
-          case 1:  bufeulertype.theta = t; break;
-          case 2:  bufeulertype.psi   = t; break;
-        }
+        pb->bufeulertype[i] = t;
       }
   }
 
-  int  get_point ( double * lng , double * lat )
+  int  get_point ( const SParseBuffer * pb, double * lng , double * lat )
   {
 
-      if ( spheretype == STYPE_POINT )
+      if ( pb->spheretype == STYPE_POINT )
       {
-        *lng =  bufpoints.p[0].lng ;
-        *lat =  bufpoints.p[0].lat ;
+        *lng =  pb->bufpoints[0].lng ;
+        *lat =  pb->bufpoints[0].lat ;
         return 1;
       } else {
         return 0;
       }
   }
 
-  int get_line ( double * phi , double * theta ,
+  int get_line ( const SParseBuffer * pb, double * phi , double * theta ,
     double * psi , unsigned char * etype, double * length )
   {
 
       int i;
 
-      if (  spheretype != STYPE_LINE ){
+      if (  pb->spheretype != STYPE_LINE ){
         return 0;
       }
 
-      *phi   =  bufangle[bufeuler[0]] ;
-      *theta =  bufangle[bufeuler[1]] ;
-      *psi   =  bufangle[bufeuler[2]] ;
+      *phi   =  pb->bufangle[pb->bufeuler[0]] ;
+      *theta =  pb->bufangle[pb->bufeuler[1]] ;
+      *psi   =  pb->bufangle[pb->bufeuler[2]] ;
       for ( i=0; i<3; i++ ){
-        switch ( i ){
-          case 0:  etype[i] = bufeulertype.phi  ; break;
-          case 1:  etype[i] = bufeulertype.theta; break;
-          case 2:  etype[i] = bufeulertype.psi  ; break;
-        }
+        etype[i] = pb->bufeulertype[i];
       }
-      *length = bufangle[bufline];
+      *length = pb->bufangle[pb->bufline];
       return 1;
   }
       
 
-  int  get_euler  ( double * phi , double * theta ,
+  int  get_euler  ( const SParseBuffer * pb, double * phi , double * theta ,
     double * psi , unsigned char * etype )
   {
 
       int i;
 
-      if (  spheretype != STYPE_EULER ){
+      if (  pb->spheretype != STYPE_EULER ){
         return 0;
       }
-      *phi   =  bufangle[bufeuler[0]] ;
-      *theta =  bufangle[bufeuler[1]] ;
-      *psi   =  bufangle[bufeuler[2]] ;
+      *phi   =  pb->bufangle[pb->bufeuler[0]] ;
+      *theta =  pb->bufangle[pb->bufeuler[1]] ;
+      *psi   =  pb->bufangle[pb->bufeuler[2]] ;
       for ( i=0; i<3; i++ ){
-        switch ( i ){
-          case 0:  etype[i] = bufeulertype.phi  ; break;
-          case 1:  etype[i] = bufeulertype.theta; break;
-          case 2:  etype[i] = bufeulertype.psi  ; break;
-        }
+        etype[i] = pb->bufeulertype[i];
       }
           
       return 1;
   }
 
-  int  get_circle ( double * lng , double * lat , double * radius )
+  int  get_circle ( const SParseBuffer * pb, double * lng , double * lat , double * radius )
   {
 
-      if ( spheretype == STYPE_CIRCLE )
+      if ( pb->spheretype == STYPE_CIRCLE )
       {
-        *lng    =  bufpoints.p[bufcircle[0]].lng ;
-        *lat    =  bufpoints.p[bufcircle[0]].lat ;
-        *radius =  bufangle[bufcircle[1]] ;
+        *lng    =  pb->bufpoints[pb->bufcircle[0]].lng ;
+        *lat    =  pb->bufpoints[pb->bufcircle[0]].lat ;
+        *radius =  pb->bufangle[pb->bufcircle[1]] ;
         return 1;
       } else {
         return 0;
       }
   }
 
-  int  get_ellipse ( double * lng , double * lat ,
+  int  get_ellipse ( const SParseBuffer * pb, double * lng , double * lat ,
     double * r1, double * r2, double * inc )
   {
 
-      if ( spheretype == STYPE_ELLIPSE )
+      if ( pb->spheretype == STYPE_ELLIPSE )
       {
-        *lng    =  bufpoints.p[bufellipse[2]].lng ;
-        *lat    =  bufpoints.p[bufellipse[2]].lat ;
-        *r1     =  bufangle[bufellipse[0]] ;
-        *r2     =  bufangle[bufellipse[1]] ;
-        *inc    =  bufangle[bufellipse[3]] ;
+        *lng    =  pb->bufpoints[pb->bufellipse[2]].lng ;
+        *lat    =  pb->bufpoints[pb->bufellipse[2]].lat ;
+        *r1     =  pb->bufangle[pb->bufellipse[0]] ;
+        *r2     =  pb->bufangle[pb->bufellipse[1]] ;
+        *inc    =  pb->bufangle[pb->bufellipse[3]] ;
         return 1;
       } else {
         return 0;
@@ -278,17 +212,17 @@
 
   }
 
-  int  get_path_count  ( void )
+  int  get_path_count  ( const SParseBuffer * pb )
   {
-      return ( bufspos );
+      return ( pb->bufspos );
   }
 
-  int  get_path_elem     ( int spos, double * lng , double * lat )
+  int  get_path_elem     ( const SParseBuffer * pb, int spos, double * lng , double * lat )
   {
-      if ( spheretype == STYPE_PATH )
+      if ( pb->spheretype == STYPE_PATH )
       {
-        *lng =  bufpoints.p[spos].lng ;
-        *lat =  bufpoints.p[spos].lat ;
+        *lng =  pb->bufpoints[spos].lng ;
+        *lat =  pb->bufpoints[spos].lat ;
         return 1;
       } else {
         return 0;
@@ -296,37 +230,171 @@
   }
 
 
-  int  get_box ( double * lng1 , double * lat1, double * lng2 , double * lat2 )
+  int  get_box ( const SParseBuffer * pb, double * lng1 , double * lat1, double * lng2 , double * lat2 )
   {
-      if ( spheretype == STYPE_BOX )
+      if ( pb->spheretype == STYPE_BOX )
       {
-        *lng1 =  bufpoints.p[0].lng ;
-        *lat1 =  bufpoints.p[0].lat ;
-        *lng2 =  bufpoints.p[1].lng ;
-        *lat2 =  bufpoints.p[1].lat ;
+        *lng1 =  pb->bufpoints[0].lng ;
+        *lat1 =  pb->bufpoints[0].lat ;
+        *lng2 =  pb->bufpoints[1].lng ;
+        *lat2 =  pb->bufpoints[1].lat ;
         return 1;
       }
       return 0;
   }
 
 
-  int get_buffer( char * buf , int offset )
+  /*!
+    \brief Skips the white space characters of the scanner
+    \param s pointer to input
+    \return pointer to next other character
+  */
+  static const char * fast_skip ( const char * s )
+  {
+    while ( *s == ' ' || *s == '\n' || *s == '\t' ){
+      s++;
+    }
+    return s;
+  }
+
+  /*!
+    Reads an unsigned number as the scanner does. Numbers the
+    scanner splits into several tokens ( e.g. "1." or "1e5" )
+    and integers atoi() can not hold are rejected.
+    \brief Reads an unsigned number
+    \param s pointer to input
+    \param a pointer to value
+    \return pointer behind the number or NULL
+  */
+  static const char * fast_number ( const char * s, float8 * a )
   {
+    const char * p = s;
+    char       * e ;
+    int         nd = 0, nf = -1;
 
-    int slen = 0 ;
+    while ( *p >= '0' && *p <= '9' ){
+      p++; nd++;
+    }
+    if ( *p == '.' ){
+      p++; nf = 0;
+      while ( *p >= '0' && *p <= '9' ){
+        p++; nf++;
+      }
+      if ( nf == 0 ){
+        return NULL;
+      }
+    } else if ( nd == 0 ){
+      return NULL;
+    }
+    if ( *p == 'e' || *p == 'E' ){
+      p++;
+      if ( *p != '+' && *p != '-' ){
+        return NULL;
+      }
+      p++;
+      if ( !( *p >= '0' && *p <= '9' ) ){
+        return NULL;
+      }
+      while ( *p >= '0' && *p <= '9' ){
+        p++;
+      }
+    } else if ( nf < 0 && nd > 9 ){
+      return NULL;
+    }
+    *a = strtod ( s, &e );
+    return ( e == p )?( p ):( NULL );
+  }
 
-    slen = strlen( parse_buffer );
+  /*!
+    Reads an angle in radians or degrees, optionally signed.
+    Degrees with minutes and seconds and hours are rejected.
+    \brief Reads an angle
+    \param s pointer to input
+    \param with_sign allow a sign
+    \param a pointer to angle in radians
+    \return pointer to next non-space character behind the angle or NULL
+  */
+  static const char * fast_angle ( const char * s, bool with_sign, float8 * a )
+  {
+    int sign = 1;
 
-    if ( ! parse_buffer || ! ( slen > 0 ) ){
-      return 0 ;
+    s = fast_skip ( s );
+    if ( with_sign && ( *s == '+' || *s == '-' ) ){
+      sign = ( *s == '-' )?( -1 ):( 1 );
+      s    = fast_skip ( s + 1 );
+    }
+    s = fast_number ( s, a );
+    if ( ! s ){
+      return NULL;
+    }
+    s = fast_skip ( s );
+    if ( *s == 'd' ){
+      *a /= RADIANS ;
+      s   = fast_skip ( s + 1 );
+    }
+    if ( sign < 0 && *a > 0 ){
+      *a *= -1;
     }
-     
-    if ( slen >= offset ){
-      slen = offset;
-    } 
-    memcpy ( ( void * ) buf, ( void * ) parse_buffer , slen );
-    parse_buffer += slen;
+    return s;
+  }
 
-    return slen;
+  /*!
+    \brief Reads a spherical point
+    \param s pointer to input
+    \param lng pointer to longitude value
+    \param lat pointer to latitude value
+    \return pointer to next non-space character behind the point or NULL
+  */
+  static const char * fast_point ( const char * s, float8 * lng, float8 * lat )
+  {
+    s = fast_skip ( s );
+    if ( *s != '(' ){
+      return NULL;
+    }
+    s = fast_angle ( s + 1, TRUE, lng );
+    if ( ! s || *s != ',' ){
+      return NULL;
+    }
+    s = fast_angle ( s + 1, TRUE, lat );
+    if ( ! s || *s != ')' ){
+      return NULL;
+    }
+    return fast_skip ( s + 1 );
+  }
+
+  int  parse_fast_point ( const char * str, double * lng, double * lat )
+  {
+    float8 a, b;
+    const char * s = fast_point ( str, &a, &b );
+    if ( ! s || *s != '\0' ){
+      return 0;
+    }
+    *lng = a;
+    *lat = b;
+    return 1;
+  }
 
+  int  parse_fast_circle ( const char * str, double * lng, double * lat, double * radius )
+  {
+    float8 a, b, r;
+    const char * s = fast_skip ( str );
+    if ( *s != '<' ){
+      return 0;
+    }
+    s = fast_point ( s + 1, &a, &b );
+    if ( ! s || *s != ',' ){
+      return 0;
+    }
+    s = fast_angle ( s + 1, FALSE, &r );
+    if ( ! s || *s != '>' ){
+      return 0;
+    }
+    s = fast_skip ( s + 1 );
+    if ( *s != '\0' ){
+      return 0;
+    }
+    *lng    = a;
+    *lat    = b;
+    *radius = r;
+    return 1;
   }
@@ -27,109 +27,168 @@
 #define EULER_AXIS_Z 3  //!< z - axis for Euler transformation
 /*! @} */
 
-  int  sphere_yylex();
-  void sphere_yyerror( const char *str );
-  void sphere_flush_scanner_buffer(void) ;
+
+#define MAX_BUF_ANGLE   20  //!< maximum count of buffered angles
+#define MIN_BUF_POINTS   4  //!< count of points buffered without allocation
 
   /*!
-   \brief Sets the data type
-   \return type number
+    \brief a simple spherical point
+  */
+  typedef struct {
+    double          lng; //!< longitude
+    double          lat; //!< latitude
+  } bpoint;
+
+  /*!
+    The complete state of one parser run. The buffer is allocated
+    in the current memory context, so the parser does not keep any
+    global state and does not need to be reset after an error.
+    \brief State of the input parser
+  */
+  typedef struct {
+    const char    * input;                 //!< current position of scanner
+    unsigned char   spheretype;            //!< the type of parsed spherical object
+    float8          bufangle[MAX_BUF_ANGLE]; //!< the angle buffer
+    int             bufapos;               //!< current angle ID
+    int             bufspos;               //!< current point ID
+    int             maxpoints;             //!< size of point buffer
+    bpoint        * bufpoints;             //!< point buffer
+    bpoint          pointbuf[MIN_BUF_POINTS]; //!< initial point buffer
+    int             bufline;               //!< ID of line's length angle
+    int             bufcircle[2];          //!< IDs of circle's center and radius
+    int             bufellipse[5];         //!< IDs of ellipse values
+    int             bufeuler[3];           //!< IDs of Euler transformation angles
+    unsigned char   bufeulertype[3];       //!< axes of Euler transformation
+  } SParseBuffer;
+
+  /*!
+    \brief the scanner
+    \param lval pointer to semantic value of token
+    \param pb   pointer to parser buffer
+    \return token
+  */
+  int  sphere_yylex      ( void * lval, SParseBuffer * pb );
+
+  /*!
+    \brief reports a parser error
+    \param pb  pointer to parser buffer
+    \param str error message
   */
-  void set_spheretype    ( unsigned char st );
+  void sphere_yyerror    ( SParseBuffer * pb, const char *str );
 
   /*!
-   \brief Initialize the input buffer
-   \param buffer pointer to input buffer
+    \brief the parser created by bison
+    \param pb pointer to parser buffer
+    \return 0 , if parsing was successful
   */
-  void init_buffer       ( char * buffer );
+  int  sphere_yyparse    ( SParseBuffer * pb );
 
   /*!
-   \brief Resets the input buffer
+    Allocates a parser buffer in the current memory context
+    and parses the input.
+    \brief Parses the input
+    \param buffer input string
+    \return pointer to parser buffer
   */
-  void reset_buffer      ( void );
+  SParseBuffer * sphere_parse ( const char * buffer );
 
   /*!
-   \brief Read the input
-   \param buf pointer to buffer
-   \param offset number of bytes
-   \return count of read bytes
+   \brief Frees the parser buffer
+   \param pb pointer to parser buffer
   */
-  int  get_buffer        ( char * buf , int offset );
+  void free_buffer       ( SParseBuffer * pb );
+
+  /*!
+   \brief Sets the data type
+   \param pb pointer to parser buffer
+   \param st type number
+  */
+  void set_spheretype    ( SParseBuffer * pb, unsigned char st );
 
   /*!
    \brief input of a angle
+   \param pb pointer to parser buffer
    \param is_deg >0 if a in degrees
    \param a value of angle
    \return a unique ID ( position) of angle
   */
-  int  set_angle         ( unsigned char is_deg , double a );
+  int  set_angle         ( SParseBuffer * pb, unsigned char is_deg , double a );
 
   /*!
    \brief set the sign of an angle
+   \param pb pointer to parser buffer
    \param apos the angle ID
    \param s sign of angle ( <0 .. - , >0 .. + )
    \return the unique ID ( position) of angle
   */
-  int  set_angle_sign    ( int apos   , int s );
+  int  set_angle_sign    ( SParseBuffer * pb, int apos   , int s );
 
   /*!
    \brief Creates a spherical point
+   \param pb pointer to parser buffer
    \param lngpos the ID of longitude angle
    \param latpos the ID of latitude angle
    \return the unique ID ( position) of spherical point
   */
-  int  set_point         ( int lngpos , int latpos );
+  int  set_point         ( SParseBuffer * pb, int lngpos , int latpos );
 
   /*!
    \brief Creates a spherical circle
+   \param pb pointer to parser buffer
    \param spos the ID of spherical point
    \param rpos the ID of radius angle
   */
-  void set_circle        ( int spos , int rpos );
+  void set_circle        ( SParseBuffer * pb, int spos , int rpos );
 
   /*!
    \brief Sets the length of spherical line
+   \param pb pointer to parser buffer
    \param length the ID of length angle
   */
-  void set_line          ( int length );
+  void set_line          ( SParseBuffer * pb, int length );
 
   /*!
    \brief Creates an Euler transformation
+   \param pb pointer to parser buffer
    \param phi the ID of first angle
    \param theta the ID of second angle
    \param psi the ID of  third angle
    \param etype three letter code of Euler transformation axes
   */
-  void set_euler         ( int phi, int theta , int psi , char * etype );
+  void set_euler         ( SParseBuffer * pb, int phi, int theta , int psi , char * etype );
 
   /*!
    \brief Creates a spherical ellipse
+   \param pb pointer to parser buffer
    \param r1 ID of first radius angle
    \param r2 ID of second radius angle
    \param sp ID of spherical point ( center )
    \param inc ID  of inclination angle
   */
-  void set_ellipse       ( int r1, int r2, int sp , int inc );
+  void set_ellipse       ( SParseBuffer * pb, int r1, int r2, int sp , int inc );
 
   /*!
    \brief Returns the point parameters
+   \param pb pointer to parser buffer
    \param lng pointer to longitude value
    \param lat pointer to latitude value
    \return <>0 , if user input is spherical point
   */
-  int  get_point         ( double * lng , double * lat );
+  int  get_point         ( const SParseBuffer * pb, double * lng , double * lat );
 
   /*!
    \brief Returns the circle parameters
+   \param pb pointer to parser buffer
    \param lng pointer to longitude value of center
    \param lat pointer to latitude value of center
    \param radius pointer to radius value
    \return <>0 , if user input is spherical circle
   */
-  int  get_circle        ( double * lng , double * lat , double * radius );
+  int  get_circle        ( const SParseBuffer * pb, double * lng , double * lat , double * radius );
 
   /*!
    \brief Returns the ellipse parameters
+   \param pb pointer to parser buffer
    \param lng pointer to longitude value of center
    \param lat pointer to latitude value of center
    \param r1 pointer to first radius value
@@ -137,10 +196,11 @@
    \param inc pointer to inclination angle
    \return <>0 , if user input is spherical ellipse
   */
-  int  get_ellipse       ( double * lng , double * lat , double * r1,
+  int  get_ellipse       ( const SParseBuffer * pb, double * lng , double * lat , double * r1,
                                   double * r2, double * inc );
   /*!
    \brief Returns the line parameters
+   \param pb pointer to parser buffer
    \param phi   pointer to first angle of Euler transformation
    \param theta pointer to second angle of Euler transformation
    \param psi   pointer to third angle of Euler transformation
@@ -148,41 +208,70 @@
    \param length pointer to length value
    \return <>0 , if user input is spherical line
   */
-  int  get_line          ( double * phi , double * theta , double * psi ,
+  int  get_line          ( const SParseBuffer * pb, double * phi , double * theta , double * psi ,
                                  unsigned char * etype, double * length );
   /*!
    \brief Returns the Euler transformation parameters
+   \param pb pointer to parser buffer
    \param phi   pointer to first angle of Euler transformation
    \param theta pointer to second angle of Euler transformation
    \param psi   pointer to third angle of Euler transformation
    \param etype pointer to axes value of Euler transformation
    \return <>0 , if user input is an Euler transformation
   */
-  int  get_euler         ( double * phi , double * theta , 
+  int  get_euler         ( const SParseBuffer * pb, double * phi , double * theta ,
                                  double * psi , unsigned char * etype );
   /*!
    \brief Returns the count of path elements
+   \param pb pointer to parser buffer
    \return count of points
   */
-  int  get_path_count    ( void );
+  int  get_path_count    ( const SParseBuffer * pb );
 
   /*!
    \brief Returns the elements of path
+   \param pb pointer to parser buffer
    \param spos number of element
    \param lng the ID of longitude angle
    \param lat the ID of latitude angle
    \return <>0 , if user input is an path or polygon and spos is valid
   */
-  int  get_path_elem     ( int spos, double * lng , double * lat );
+  int  get_path_elem     ( const SParseBuffer * pb, int spos, double * lng , double * lat );
 
   /*!
    \brief Returns the elements of box
+   \param pb pointer to parser buffer
    \param lng1 the ID of first longitude angle
    \param lat1 the ID of first latitude angle
    \param lng2 the ID of second longitude angle
    \param lat2 the ID of second latitude angle
    \return <>0 , if user input is a box
   */
-  int  get_box ( double * lng1 , double * lat1, double * lng2 , double * lat2 );
+  int  get_box ( const SParseBuffer * pb, double * lng1 , double * lat1, double * lng2 , double * lat2 );
+
+  /*!
+    Parses the common point input "(lng,lat)" with plain
+    numbers in radians or degrees without the flex/bison parser.
+    \brief Fast path of spherical point input
+    \param str input string
+    \param lng pointer to longitude value
+    \param lat pointer to latitude value
+    \return <>0 , if the input was parsed, 0 if the input has to be
+            passed to the parser
+  */
+  int  parse_fast_point  ( const char * str, double * lng, double * lat );
+
+  /*!
+    Parses the common circle input "<(lng,lat),radius>" with plain
+    numbers in radians or degrees without the flex/bison parser.
+    \brief Fast path of spherical circle input
+    \param str input string
+    \param lng pointer to longitude value of center
+    \param lat pointer to latitude value of center
+    \param radius pointer to radius value
+    \return <>0 , if the input was parsed, 0 if the input has to be
+            passed to the parser
+  */
+  int  parse_fast_circle ( const char * str, double * lng, double * lat, double * radius );
 
 #endif
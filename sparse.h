@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,64 +31,70 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_SPHERE_YY_SPARSE_H_INCLUDED
+# define YY_SPHERE_YY_SPARSE_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int sphere_yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     HOUR = 258,
-     DEG = 259,
-     MIN = 260,
-     SEC = 261,
-     COMMA = 262,
-     OPENCIRC = 263,
-     CLOSECIRC = 264,
-     OPENPOINT = 265,
-     CLOSEPOINT = 266,
-     OPENARR = 267,
-     CLOSEARR = 268,
-     SIGN = 269,
-     INT = 270,
-     FLOAT = 271,
-     EULERAXIS = 272
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    HOUR = 258,                    /* HOUR  */
+    DEG = 259,                     /* DEG  */
+    MIN = 260,                     /* MIN  */
+    SEC = 261,                     /* SEC  */
+    COMMA = 262,                   /* COMMA  */
+    OPENCIRC = 263,                /* OPENCIRC  */
+    CLOSECIRC = 264,               /* CLOSECIRC  */
+    OPENPOINT = 265,               /* OPENPOINT  */
+    CLOSEPOINT = 266,              /* CLOSEPOINT  */
+    OPENARR = 267,                 /* OPENARR  */
+    CLOSEARR = 268,                /* CLOSEARR  */
+    SIGN = 269,                    /* SIGN  */
+    INT = 270,                     /* INT  */
+    FLOAT = 271,                   /* FLOAT  */
+    EULERAXIS = 272                /* EULERAXIS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
-#define HOUR 258
-#define DEG 259
-#define MIN 260
-#define SEC 261
-#define COMMA 262
-#define OPENCIRC 263
-#define CLOSECIRC 264
-#define OPENPOINT 265
-#define CLOSEPOINT 266
-#define OPENARR 267
-#define CLOSEARR 268
-#define SIGN 269
-#define INT 270
-#define FLOAT 271
-#define EULERAXIS 272
-
-
-
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 36 "sparse.y"
-{ 
+union YYSTYPE
+{
+#line 42 "sparse.y"
+ 
  int    i;
  double d;
  char   c[3];
-}
-/* Line 1529 of yacc.c.  */
-#line 89 "sparse.h"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+
+#line 87 "sparse.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
-extern YYSTYPE sphere_yylval;
 
+
+
+int sphere_yyparse (SParseBuffer * pb);
+
+
+#endif /* !YY_SPHERE_YY_SPARSE_H_INCLUDED  */
@@ -5,17 +5,19 @@
 #include "utils/elog.h"
 #include "sbuffer.h"
 
-void sphere_yyerror(const char *str)
+#define YYMALLOC palloc
+#define YYFREE   pfree
+
+void sphere_yyerror( SParseBuffer * pb, const char *str )
 {
-  reset_buffer();
   elog( ERROR, "parsing: %s",str);
 }
 
-static double human2dec ( double d , double m, double s ){
+static double human2dec ( SParseBuffer * pb, double d , double m, double s ){
   if ( m<0 || m>=60 || s<0 || s>=60 ){
     char err[255];
     sprintf(err, "minutes or seconds invalid (min:%f sec:%f)", m, s );
-    sphere_yyerror(err);
+    sphere_yyerror(pb, err);
     return 0;
   } else {
     if ( d<0 ){
@@ -29,6 +31,10 @@ static double human2dec ( double d , double m, double s ){
 
 %}
 
+%define api.pure full
+%parse-param { SParseBuffer * pb }
+%lex-param   { SParseBuffer * pb }
+
 %token HOUR DEG MIN SEC COMMA 
 %token OPENCIRC CLOSECIRC OPENPOINT CLOSEPOINT 
 %token OPENARR CLOSEARR
@@ -61,19 +67,19 @@ commands: /* empty */
 	;
 
 command:
-  spherepoint   { set_spheretype ( STYPE_POINT   ); } 
+  spherepoint   { set_spheretype ( pb, STYPE_POINT   ); } 
   | 
-  spherecircle  { set_spheretype ( STYPE_CIRCLE  ); }
+  spherecircle  { set_spheretype ( pb, STYPE_CIRCLE  ); }
   | 
-  sphereline    { set_spheretype ( STYPE_LINE    ); }
+  sphereline    { set_spheretype ( pb, STYPE_LINE    ); }
   | 
-  eulertrans    { set_spheretype ( STYPE_EULER   ); }
+  eulertrans    { set_spheretype ( pb, STYPE_EULER   ); }
   |
-  spherepath    { set_spheretype ( STYPE_PATH    ); }
+  spherepath    { set_spheretype ( pb, STYPE_PATH    ); }
   |
-  sphereellipse { set_spheretype ( STYPE_ELLIPSE ); }
+  sphereellipse { set_spheretype ( pb, STYPE_ELLIPSE ); }
   |
-  spherebox     { set_spheretype ( STYPE_BOX     ); }
+  spherebox     { set_spheretype ( pb, STYPE_BOX     ); }
   ;
 
 /* unsigned number */
@@ -87,46 +93,46 @@ number :
 /* unsigned longitude */
 
 angle_lat_us :
-	number                      { $$ = set_angle( 0, $1 ) ;                  } |
-  FLOAT DEG                   { $$ = set_angle( 1, human2dec($1,0 ,0) )  ; } |
-  INT DEG                     { $$ = set_angle( 1, human2dec($1,0 ,0) )  ; } |
-  INT DEG number              { $$ = set_angle( 1, human2dec($1,$3,0) )  ; } |
-  INT DEG FLOAT MIN           { $$ = set_angle( 1, human2dec($1,$3,0) )  ; } |
-  INT DEG INT MIN             { $$ = set_angle( 1, human2dec($1,$3,0) )  ; } |
-  INT DEG INT MIN number      { $$ = set_angle( 1, human2dec($1,$3,$5) ) ; } |
-  INT DEG INT MIN number SEC  { $$ = set_angle( 1, human2dec($1,$3,$5) ) ; }
+	number                      { $$ = set_angle( pb, 0, $1 ) ;                  } |
+  FLOAT DEG                   { $$ = set_angle( pb, 1, human2dec(pb,$1,0 ,0) )  ; } |
+  INT DEG                     { $$ = set_angle( pb, 1, human2dec(pb,$1,0 ,0) )  ; } |
+  INT DEG number              { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,0) )  ; } |
+  INT DEG FLOAT MIN           { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,0) )  ; } |
+  INT DEG INT MIN             { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,0) )  ; } |
+  INT DEG INT MIN number      { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,$5) ) ; } |
+  INT DEG INT MIN number SEC  { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,$5) ) ; }
   ;
 
 /* unsigned latitude */
 
 angle_long_us :
-  number                      { $$ = set_angle( 0, $1 ) ;                  } |
-  FLOAT DEG                   { $$ = set_angle( 1, human2dec($1,0 ,0) )  ; } |
-  INT DEG                     { $$ = set_angle( 1, human2dec($1,0 ,0) )  ; } |
-  INT DEG number              { $$ = set_angle( 1, human2dec($1,$3,0) )  ; } |
-  INT DEG FLOAT MIN           { $$ = set_angle( 1, human2dec($1,$3,0) )  ; } |
-  INT DEG INT MIN             { $$ = set_angle( 1, human2dec($1,$3,0) )  ; } |
-  INT DEG INT MIN number      { $$ = set_angle( 1, human2dec($1,$3,$5) ) ; } |
-  INT DEG INT MIN number SEC  { $$ = set_angle( 1, human2dec($1,$3,$5) ) ; } |
-  INT HOUR number             { $$ = set_angle( 1,15*human2dec($1,$3,0)) ; } |
-  INT HOUR INT MIN number     { $$ = set_angle( 1,15*human2dec($1,$3,$5)); } |
-  INT HOUR INT MIN number SEC { $$ = set_angle( 1,15*human2dec($1,$3,$5)); } 
+  number                      { $$ = set_angle( pb, 0, $1 ) ;                  } |
+  FLOAT DEG                   { $$ = set_angle( pb, 1, human2dec(pb,$1,0 ,0) )  ; } |
+  INT DEG                     { $$ = set_angle( pb, 1, human2dec(pb,$1,0 ,0) )  ; } |
+  INT DEG number              { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,0) )  ; } |
+  INT DEG FLOAT MIN           { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,0) )  ; } |
+  INT DEG INT MIN             { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,0) )  ; } |
+  INT DEG INT MIN number      { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,$5) ) ; } |
+  INT DEG INT MIN number SEC  { $$ = set_angle( pb, 1, human2dec(pb,$1,$3,$5) ) ; } |
+  INT HOUR number             { $$ = set_angle( pb, 1,15*human2dec(pb,$1,$3,0)) ; } |
+  INT HOUR INT MIN number     { $$ = set_angle( pb, 1,15*human2dec(pb,$1,$3,$5)); } |
+  INT HOUR INT MIN number SEC { $$ = set_angle( pb, 1,15*human2dec(pb,$1,$3,$5)); } 
   ;
 
 /* longitude */
 
 angle_long :
-  angle_long_us      { $$ = set_angle_sign( $1,  1 ) ; }
+  angle_long_us      { $$ = set_angle_sign( pb, $1,  1 ) ; }
   |
-  SIGN angle_long_us { $$ = set_angle_sign( $2, $1 ) ; }
+  SIGN angle_long_us { $$ = set_angle_sign( pb, $2, $1 ) ; }
   ;
 
 /* latitude */
 
 angle_lat :
-  angle_lat_us       { $$ = set_angle_sign( $1,  1 ) ; }
+  angle_lat_us       { $$ = set_angle_sign( pb, $1,  1 ) ; }
   |
-  SIGN angle_lat_us  { $$ = set_angle_sign( $2, $1 ) ; }
+  SIGN angle_lat_us  { $$ = set_angle_sign( pb, $2, $1 ) ; }
   ;
 
 
@@ -135,7 +141,7 @@ angle_lat :
 spherepoint:
   OPENPOINT angle_long COMMA angle_lat CLOSEPOINT
     {
-     $$ = set_point( $2 , $4 );
+     $$ = set_point( pb, $2 , $4 );
     }
   ;
 
@@ -145,7 +151,7 @@ spherepoint:
 spherecircle:
    OPENCIRC spherepoint COMMA angle_lat_us CLOSECIRC     
    {
-     set_circle( $2, $4 );
+     set_circle( pb, $2, $4 );
    }
   ;
 
@@ -154,10 +160,10 @@ spherecircle:
 
 eulertrans :
   angle_long COMMA angle_long COMMA angle_long
-    { set_euler ( $1 , $3 , $5 , "ZXZ" ) ; }
+    { set_euler ( pb, $1 , $3 , $5 , "ZXZ" ) ; }
   |
   angle_long COMMA angle_long COMMA angle_long COMMA EULERAXIS
-    { set_euler ( $1 , $3 , $5 , $7 ) ; }
+    { set_euler ( pb, $1 , $3 , $5 , $7 ) ; }
   ;
 
 /* spherical line */
@@ -165,7 +171,7 @@ eulertrans :
 sphereline :
   OPENPOINT eulertrans CLOSEPOINT COMMA angle_long_us
   {
-    set_line ( $5 ) ;
+    set_line ( pb, $5 ) ;
   }
   ;
 
@@ -184,7 +190,7 @@ spherepath :
 
 sphereellipse:
   OPENCIRC OPENARR angle_lat_us COMMA angle_lat_us CLOSEARR COMMA spherepoint COMMA angle_lat CLOSECIRC
-  { set_ellipse ( $3 , $5 , $8 , $10 ) ; }
+  { set_ellipse ( pb, $3 , $5 , $8 , $10 ) ; }
   ;
 
 /* boxes */
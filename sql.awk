@@ -1,28 +1,38 @@
 BEGIN {
   do_print=1;
+  depth=0;
+  pg_vnum = substr(pg_version,2) + 0;
 }
 {
-  if( match($0,"^--ifversion") ){  
-    if( $2 == "<" && pg_version < $3 ){
-      do_print = 1; next;
+  if( match($0,"^--ifversion") ){
+    vnum = substr($3,2) + 0;
+    cond = 0;
+    if( $2 == "<" && pg_vnum < vnum ){
+      cond = 1;
     } else
-    if( $2 == "<=" && pg_version <= $3 ){
-      do_print = 1; next;
+    if( $2 == "<=" && pg_vnum <= vnum ){
+      cond = 1;
     } else
-    if( $2 == ">" && pg_version > $3 ){
-      do_print = 1; next;
+    if( $2 == ">" && pg_vnum > vnum ){
+      cond = 1;
     } else
-    if( $2 == ">=" && pg_version >= $3 ){
-      do_print = 1; next;
-    } else {
-      do_print = 0; next;
+    if( $2 == ">=" && pg_vnum >= vnum ){
+      cond = 1;
     }
+    # blocks may be nested, remember the state of the outer one
+    depth++;
+    outer[depth] = do_print;
+    taken[depth] = cond;
+    do_print = outer[depth] && cond;
+    next;
   } else
   if( match($0,"^--elseversion") ){
-    do_print = 1 - do_print; next;
-  } else  
+    do_print = outer[depth] && ! taken[depth]; next;
+  } else
   if( match($0,"^--endifversion") ){
-    do_print = 1;next;
+    do_print = ( depth > 0 ) ? outer[depth] : 1;
+    if( depth > 0 ) depth--;
+    next;
   }
   if( do_print ){
     print $0;
@@ -0,0 +1,59 @@
+--
+-- binary input and output
+--
+
+SELECT encode ( spoint_send ( spoint '(10d,20d)' ) , 'hex' );
+SELECT encode ( strans_send ( strans '10d,20d,30d,XYZ' ) , 'hex' );
+SELECT encode ( scircle_send ( scircle '<(10d,20d),5d>' ) , 'hex' );
+SELECT encode ( sline_send ( sline '( 10d, 20d, 30d, XYZ ), 40d' ) , 'hex' );
+SELECT encode ( sellipse_send ( sellipse '<{ 10d, 5d },(20d,30d),40d>' ) , 'hex' );
+SELECT encode ( spoly_send ( spoly '{(0d,0d),(10d,0d),(10d,10d)}' ) , 'hex' );
+SELECT encode ( spath_send ( spath '{(0d,0d),(10d,0d)}' ) , 'hex' );
+SELECT encode ( sbox_send ( sbox '((10d,20d),(30d,40d))' ) , 'hex' );
+
+-- round trip of binary copy
+
+CREATE TABLE spherebin1 ( LIKE spheretmp1 );
+\copy spheretmp1 to 'results/binary.bin' with binary
+\copy spherebin1 from 'results/binary.bin' with binary
+SELECT count(*) FROM spheretmp1 a, spherebin1 b WHERE a.ctid = b.ctid AND a.p = b.p ;
+
+CREATE TABLE spherebin2 ( LIKE spheretmp2 );
+\copy spheretmp2 to 'results/binary.bin' with binary
+\copy spherebin2 from 'results/binary.bin' with binary
+SELECT count(*) FROM spheretmp2 a, spherebin2 b WHERE a.ctid = b.ctid AND a.c = b.c ;
+
+CREATE TABLE spherebin3 ( LIKE spheretmp3 );
+\copy spheretmp3 to 'results/binary.bin' with binary
+\copy spherebin3 from 'results/binary.bin' with binary
+SELECT count(*) FROM spheretmp3 a, spherebin3 b WHERE a.ctid = b.ctid AND a.b = b.b ;
+
+CREATE TABLE spherebin4 ( LIKE spheretmp4 );
+\copy spheretmp4 to 'results/binary.bin' with binary
+\copy spherebin4 from 'results/binary.bin' with binary
+SELECT count(*) FROM spheretmp4 a, spherebin4 b WHERE a.ctid = b.ctid AND a.l = b.l ;
+
+CREATE TABLE spherebin5 ( LIKE spheretmp5 );
+\copy spheretmp5 to 'results/binary.bin' with binary
+\copy spherebin5 from 'results/binary.bin' with binary
+SELECT count(*) FROM spheretmp5 a, spherebin5 b WHERE a.id = b.id AND a.p = b.p ;
+
+CREATE TABLE spherebin6 ( LIKE spheretmp6 );
+\copy spheretmp6 to 'results/binary.bin' with binary
+\copy spherebin6 from 'results/binary.bin' with binary
+SELECT count(*) FROM spheretmp6 a, spherebin6 b WHERE a.id = b.id AND a.p = b.p ;
+
+CREATE TABLE spherebin7 ( LIKE spheretmp7 );
+\copy spheretmp7 to 'results/binary.bin' with binary
+\copy spherebin7 from 'results/binary.bin' with binary
+SELECT count(*) FROM spheretmp7 a, spherebin7 b WHERE a.ctid = b.ctid AND a.e = b.e ;
+
+CREATE TABLE spherebin8 ( t strans );
+INSERT INTO spherebin8 VALUES ( strans '10d,20d,30d,XYZ' );
+INSERT INTO spherebin8 VALUES ( strans '-10d,200d,-30d,ZXZ' );
+INSERT INTO spherebin8 VALUES ( strans '350d,0d,720d,YZY' );
+\copy spherebin8 to 'results/binary.bin' with binary
+CREATE TABLE spherebin9 ( LIKE spherebin8 );
+\copy spherebin9 from 'results/binary.bin' with binary
+SELECT count(*) FROM spherebin8 a, spherebin9 b WHERE a.ctid = b.ctid AND a.t = b.t ;
+
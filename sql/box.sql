@@ -434,3 +434,40 @@ SELECT sbox '((170d,-50d),(190d,-40d))' && sline ( spoint '(180d, -41d)', spoint
 SELECT sbox '((170d,-50d),(190d,-40d))'  ~ sline ( spoint '(170d, -40d)', spoint '(190d, -40d)' ) ;
 
 -- wide spherical boxes
+
+-- bounding box aggregate
+
+SELECT sbox_bound(p) = sbox '((350d,-10d),(10d,10d))' FROM ( VALUES ( spoint '(350d,10d)' ), ( spoint '(10d,-10d)' ), ( spoint '(0d,0d)' ) ) AS t(p);
+
+SELECT sbox_bound(p) = sbox '((10d,10d),(200d,90d))' FROM ( VALUES ( spoint '(0d,90d)' ), ( spoint '(10d,10d)' ), ( spoint '(130d,10d)' ), ( spoint '(200d,10d)' ) ) AS t(p);
+
+SELECT sbox_bound(p) = sbox '((30d,10d),(30d,10d))' FROM ( VALUES ( spoint '(30d,10d)' ), ( NULL ) ) AS t(p);
+
+SELECT sbox_bound(b) = sbox '((350d,-20d),(190d,30d))' FROM ( VALUES ( sbox '((170d,-20d),(190d,0d))' ), ( sbox '((350d,0d),(20d,30d))' ) ) AS t(b);
+
+SELECT count(*) FROM spheretmp3, ( SELECT sbox_bound(b) AS bb FROM spheretmp3 ) AS t WHERE NOT b @ bb;
+
+-- aggregates in parallel mode
+
+CREATE TABLE spheretmp_agg AS
+  SELECT spoint( 1 + 0.2 * sin(i), 0.5 + 0.1 * cos(3 * i) ) AS p FROM generate_series(1,20000) AS i;
+
+CREATE TABLE spheretmp_agg_res AS
+  SELECT spoint_centroid(p) AS p, scircle_bound(p) AS c, sbox_bound(p) AS b FROM spheretmp_agg;
+
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+SET max_parallel_workers_per_gather = 2;
+
+EXPLAIN (COSTS OFF) SELECT spoint_centroid(p), scircle_bound(p), sbox_bound(p) FROM spheretmp_agg;
+
+SELECT a.p = r.p AS centroid, radius(a.c) < 0.3 AS circle, a.b = r.b AS box
+  FROM ( SELECT spoint_centroid(p) AS p, scircle_bound(p) AS c, sbox_bound(p) AS b FROM spheretmp_agg ) AS a, spheretmp_agg_res AS r;
+
+SELECT count(*) FROM spheretmp_agg, ( SELECT scircle_bound(p) AS c, sbox_bound(p) AS b FROM spheretmp_agg ) AS a WHERE NOT ( p @ a.c AND p @ a.b );
+
+RESET max_parallel_workers_per_gather;
+RESET min_parallel_table_scan_size;
+RESET parallel_tuple_cost;
+RESET parallel_setup_cost;
@@ -290,3 +290,73 @@ SELECT '< (0d 0m 0s, 0d),  3.5d >'::scircle ~ '(3d 30m 0s,+1d    )'::spoint;
 SELECT '< (1h 0m 0s,+90d), 1.0d >'::scircle ~ '(1h 0m  0s,+88.99d)'::spoint;
 
 SELECT '< (1h 0m 0s,-90d), 1.0d >'::scircle ~ '(1h 0m  0s,-88.99d)'::spoint;
+
+-- near the border the server gives the answers of the core library,
+-- see bench/pgs_check.c
+
+CREATE TABLE spheretmp_check ( p spoint, c scircle, inside bool );
+
+\copy spheretmp_check from 'data/test_spherecheck.data'
+
+SELECT count(*), sum( inside::int ), count( NULLIF( ( p @ c ) = inside, true ) ) AS differ FROM spheretmp_check;
+
+DROP TABLE spheretmp_check;
+
+-- bounding circle aggregate
+
+SELECT scircle_bound(p) = scircle '<(5d,0d),5d>' FROM ( VALUES ( spoint '(0d,0d)' ), ( spoint '(10d,0d)' ), ( NULL ) ) AS t(p);
+
+SELECT scircle_bound(c) = scircle '<(5d,0d),6d>' FROM ( VALUES ( scircle '<(0d,0d),1d>' ), ( scircle '<(10d,0d),1d>' ), ( scircle '<(4d,0d),2d>' ) ) AS t(c);
+
+SELECT scircle_bound(p) = scircle '<(10d,20d),0>' FROM ( VALUES ( spoint '(10d,20d)' ) ) AS t(p);
+
+SELECT count(*) FROM (
+  SELECT spoint( 1 + 0.1 * sin(i), 0.5 + 0.1 * cos(3 * i) ) AS p FROM generate_series(1,1000) AS i
+) AS t, (
+  SELECT scircle_bound( spoint( 1 + 0.1 * sin(i), 0.5 + 0.1 * cos(3 * i) ) ) AS c FROM generate_series(1,1000) AS i
+) AS b WHERE NOT p @ c;
+
+-- larger than a hemisphere
+SELECT scircle_bound(p) IS NULL FROM spheretmp1;
+SELECT scircle_bound(p) IS NULL FROM spheretmp1 WHERE false;
+
+-- smallest enclosing circle aggregate
+
+SELECT scircle_enclosing(p) = scircle '<(5d,0d),5d>' FROM ( VALUES ( spoint '(0d,0d)' ), ( spoint '(10d,0d)' ), ( spoint '(5d,1d)' ), ( NULL ) ) AS t(p);
+
+SELECT scircle_enclosing(p) = scircle '<(10d,20d),0>' FROM ( VALUES ( spoint '(10d,20d)' ), ( spoint '(10d,20d)' ) ) AS t(p);
+
+SELECT scircle_enclosing(p) = scircle '<(0d,90d),10d>' FROM ( VALUES ( spoint '(0d,80d)' ), ( spoint '(120d,80d)' ), ( spoint '(240d,80d)' ), ( spoint '(30d,85d)' ) ) AS t(p);
+
+SELECT count(*), bool_and( p @ c ), abs( max( dist( center(c), p ) ) - radius(c) ) < 1e-12, radius(c) < radius(b) FROM (
+  SELECT spoint( 1 + 0.1 * sin(i), 0.5 + 0.1 * cos(3 * i) ) AS p FROM generate_series(1,1000) AS i
+) AS t, (
+  SELECT scircle_enclosing( spoint( 1 + 0.1 * sin(i), 0.5 + 0.1 * cos(3 * i) ) ) AS c,
+         scircle_bound( spoint( 1 + 0.1 * sin(i), 0.5 + 0.1 * cos(3 * i) ) ) AS b FROM generate_series(1,1000) AS i
+) AS a GROUP BY radius(c), radius(b);
+
+-- a point outside by less than EPSILON is enclosed too
+SELECT abs( max( dist( center(c), p ) ) - radius(c) ) < 1e-12 FROM (
+  VALUES ( spoint '(0d,0d)' ), ( spoint '(10d,0d)' ), ( spoint( radians(5), radians(5) + 5e-10 ) )
+) AS t(p), (
+  SELECT scircle_enclosing(p) AS c FROM ( VALUES ( spoint '(0d,0d)' ), ( spoint '(10d,0d)' ), ( spoint( radians(5), radians(5) + 5e-10 ) ) ) AS t(p)
+) AS a GROUP BY radius(c);
+
+-- not inside a hemisphere
+SELECT scircle_enclosing(p) IS NULL FROM spheretmp1;
+SELECT scircle_enclosing(p) IS NULL FROM spheretmp1 WHERE false;
+
+-- points of an array inside a circle
+
+SELECT spoint_cone( ARRAY[ spoint '(0d,0d)', spoint '(1d,0d)', spoint '(2d,0d)', spoint '(0d,1d)' ], scircle '<(0d,0d),1d>' );
+
+SELECT spoint_cone( '[0:2]={"(0,0)","(1,0)","(0.001,0)"}'::spoint[], scircle '<(0d,0d),1d>' );
+
+SELECT spoint_cone( '{}'::spoint[], scircle '<(0d,0d),1d>' );
+
+SELECT spoint_cone_count( ARRAY[ spoint '(0d,0d)', spoint '(1d,0d)', spoint '(0d,-89d)' ], scircle '<(180d,0d),90d>' );
+
+SELECT spoint_cone_count( a, scircle '<(1,0.5),0.7>' ) = ( SELECT count(*) FROM spheretmp1 WHERE p @ scircle '<(1,0.5),0.7>' )
+  FROM ( SELECT array_agg(p) AS a FROM spheretmp1 WHERE p IS NOT NULL ) AS t;
+
+SELECT spoint_cone( ARRAY[ spoint '(0d,0d)', NULL ], scircle '<(0d,0d),1d>' );
@@ -16,6 +16,16 @@ SELECT count(*) FROM spheretmp4 WHERE l @  scircle '<(1,1),0.3>';
 
 SELECT count(*) FROM spheretmp4 WHERE l && scircle '<(1,1),0.3>';
 
+SELECT count(*) FROM spheretmp1 WHERE p @ sellipse '<{0.5,0.01},(1,0.5),0.3>';
+
+SELECT count(*) FROM spheretmp2 WHERE c && sellipse '<{0.6,0.05},(1,1),0.3>';
+
+SELECT count(*) FROM spheretmp7 WHERE e && scircle '<(1,1),0.3>';
+
+SELECT count(*) FROM spheretmp7 WHERE spoint '(1,0.5)' @ e;
+
+SELECT count(*) FROM spheretmp7 WHERE e && sellipse '<{0.5,0.01},(1,0.5),0.3>';
+
 
 -- create idx
 
@@ -27,6 +37,8 @@ CREATE INDEX cccidx ON spheretmp3 USING gist ( b );
 
 CREATE INDEX dddidx ON spheretmp4 USING gist ( l );
 
+CREATE INDEX eeeidx ON spheretmp7 USING gist ( e );
+
 --with idx
 
 SET enable_seqscan = OFF ;
@@ -47,3 +59,54 @@ SELECT count(*) FROM spheretmp4 WHERE l @  scircle '<(1,1),0.3>' ;
 
 SELECT count(*) FROM spheretmp4 WHERE l && scircle '<(1,1),0.3>' ;
 
+SELECT count(*) FROM spheretmp1 WHERE p @ sellipse '<{0.5,0.01},(1,0.5),0.3>' ;
+
+SELECT count(*) FROM spheretmp2 WHERE c && sellipse '<{0.6,0.05},(1,1),0.3>' ;
+
+SELECT count(*) FROM spheretmp7 WHERE e && scircle '<(1,1),0.3>' ;
+
+SELECT count(*) FROM spheretmp7 WHERE spoint '(1,0.5)' @ e ;
+
+SELECT count(*) FROM spheretmp7 WHERE e && sellipse '<{0.5,0.01},(1,0.5),0.3>' ;
+
+-- index inspection
+
+SELECT level, pages, tuples, fill > 0 AND fill <= 1 AS fill, extent_min <= extent_median AND extent_median <= extent_max AS extent FROM pg_sphere_index_stats('aaaidx') ORDER BY level;
+
+SELECT tuples = ( SELECT count(c) FROM spheretmp2 ) FROM pg_sphere_index_stats('bbbidx') ORDER BY level DESC LIMIT 1;
+
+SELECT level, pages, tuples FROM pg_sphere_index_stats('eeeidx') ORDER BY level;
+
+-- compact points
+
+CREATE TABLE spheretmp1c AS SELECT p::spoint4 AS p FROM spheretmp1;
+
+CREATE INDEX aaacidx ON spheretmp1c USING gist ( p );
+
+SELECT count(*) FROM spheretmp1c WHERE p = spoint '(3.09 , 1.25)'::spoint4 ;
+
+SELECT count(*) FROM spheretmp1c WHERE p @ scircle '<(1,1),0.3>' ;
+
+SELECT count(*) FROM spheretmp1c WHERE p @ sellipse '<{0.5,0.01},(1,0.5),0.3>' ;
+
+SELECT count(*) FROM spheretmp1c WHERE p @ sbox '((0.5,0.5),(1,1))' ;
+
+SELECT ( SELECT count(*) FROM spheretmp1c WHERE p @ scircle '<(1,1),0.3>' ) =
+       ( SELECT count(*) FROM spheretmp1  WHERE p @ scircle '<(1,1),0.3>' ) ;
+
+DROP TABLE spheretmp1c;
+
+-- vector points
+
+CREATE TABLE spheretmp1v AS SELECT p::spoint3 AS p FROM spheretmp1;
+
+CREATE INDEX aaavidx ON spheretmp1v USING gist ( p );
+
+SELECT count(*) FROM spheretmp1v WHERE p = spoint '(3.09 , 1.25)'::spoint3 ;
+
+SELECT count(*) FROM spheretmp1v WHERE p @ scircle '<(1,1),0.3>' ;
+
+SELECT ( SELECT count(*) FROM spheretmp1v WHERE p @ scircle '<(1,1),0.3>' ) =
+       ( SELECT count(*) FROM spheretmp1  WHERE p @ scircle '<(1,1),0.3>' ) ;
+
+DROP TABLE spheretmp1v;
@@ -62,4 +62,9 @@ SELECT sline ( spoint '(0,   0d)', spoint '(0.000001d, 0d)' )   #
 
 SELECT sline ( spoint '(0,   0d)', spoint '(0.000001d, 0d)' )   #
        sline ( spoint '(0.000001d,  0d)', spoint '(0.000001d, 0.0000005d)' ) ;
-       
\ No newline at end of file
+       
+-- line of zero length and circle
+
+SELECT sline(spoint '(0.5,0.2)', spoint '(0.5,0.2)') @ scircle '<(0.5,0.2),0.1>';
+
+SELECT sline(spoint '(0.5,0.2)', spoint '(0.5,0.2)') @ scircle '<(2,0.2),0.1>';
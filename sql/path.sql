@@ -93,8 +93,31 @@ SELECT spath '{(0.11,0.15),(0.12,0.15),(0.13,0.15)}' @ :poly;
 -- create path
 SELECT spath(data.p) FROM ( SELECT spoint '(0,1)' as p UNION ALL SELECT spoint '(1,1)' UNION ALL SELECT '(1,0)' ) AS data ;
 
+-- create path with many points
+SELECT npoints( spath(data.p) ) FROM (
+  SELECT spoint( i * pi() / 100000 , 0.5 * sin( i * pi() / 1000 ) ) AS p
+  FROM generate_series(0,99999) AS i ORDER BY i ) AS data ;
+
 SELECT set_sphere_output( 'DEG' );
 
 -- test stored data
 SELECT spoint(p,2) FROM spheretmp6 WHERE id=2;
 
+
+-- create path from arrays
+SELECT spath( ARRAY[ 0, 1, 1 ], ARRAY[ 1, 1, 0 ] ) = spath '{(0,1),(1,1),(1,0)}';
+SELECT spath( ARRAY[ spoint '(0,1)', spoint '(1,1)', spoint '(1,0)' ] ) = spath '{(0,1),(1,1),(1,0)}';
+SELECT npoints( spath(
+  ARRAY( SELECT i * pi() / 100000 FROM generate_series(0,99999) AS i ORDER BY i ),
+  ARRAY( SELECT 0.5 * sin( i * pi() / 1000 ) FROM generate_series(0,99999) AS i ORDER BY i ) ) );
+SELECT spath( ARRAY[ 0, 1 ], ARRAY[ 1 ] );
+SELECT spath( ARRAY[ 0 ], ARRAY[ 1 ] );
+SELECT spath( ARRAY[ spoint '(0,1)', NULL ] );
+
+-- packed paths
+SELECT spath_pack( spath '{(359.9d,-10d),(0.1d,-10d),(0.2d,-10.3d)}', 1e-9 ) = spath '{(359.9d,-10d),(0.1d,-10d),(0.2d,-10.3d)}';
+SELECT pg_column_size( spath_pack( spath '{(359.9d,-10d),(0.1d,-10d),(0.2d,-10.3d)}', 1e-9 ) ) < pg_column_size( spath '{(359.9d,-10d),(0.1d,-10d),(0.2d,-10.3d)}' );
+SELECT spath_unpack( spath_pack( spath '{(0d,0d),(0.5d,0d),(1d,0.5d)}', 1e-6 ) );
+SELECT abs( length( spath_pack( spath '{(0d,0d),(0.5d,0d),(1d,0.5d)}', 1e-9 ) ) - length( spath '{(0d,0d),(0.5d,0d),(1d,0.5d)}' ) ) < 1e-8, spoint( spath_pack( spath '{(0d,0d),(0.5d,0d),(1d,0.5d)}', 1e-9 ), 2 ) = spoint '(0.5d,0d)';
+SELECT spath_pack( spath '{(0d,0d),(0.5d,0d)}', -1 );
+SELECT spath_pack( spath '{(0d,0d),(0.5d,0d)}', 1e-300 );
@@ -76,6 +76,17 @@ SELECT '( 0.625d , -0.04166666667d)'::spoint;
 
 SELECT '(0.0109083078249646 , -0.000727220521664407)'::spoint;
 
+-- forms the fast input path has to pass to the parser
+SELECT '( - 0.625d , + 0.04166666667 d )'::spoint = '(-0.625d,0.04166666667d)'::spoint;
+
+SELECT '(1.,2)'::spoint = '(1,2)'::spoint;
+
+SELECT '(.5e+1,2.5E-1)'::spoint = '(5,0.25)'::spoint;
+
+SELECT '(10d 30m, 5)'::spoint = '(10.5d,5)'::spoint;
+
+SELECT '<(10d,20d),1d 30m>'::scircle = '<(10d,20d),1.5d>'::scircle;
+
 -- functions for point --------------
 
 -- spoint(float8, float8)
@@ -230,3 +241,181 @@ SELECT '( 0h 2m 30s , 90d 0m 0s)'::spoint<->'( 12h 2m 30s , 90d 0m 0s)'::spoint;
 
 SELECT '( 0h 2m 30s , -90d 0m 0s)'::spoint<->'( 12h 2m 30s , -90d 0m 0s)'::spoint;
 
+
+-- spoint arrays ------------
+
+SELECT spoint( ARRAY[ 0, 1, 2 ], ARRAY[ 0, 0.5, -0.5 ] )::text = ARRAY[ spoint(0,0), spoint(1,0.5), spoint(2,-0.5) ]::text;
+
+SELECT array_length( spoint( ARRAY[ 0, 1 ], ARRAY[ 0, 0.5 ] ), 1 );
+
+SELECT spoint( '{}'::float8[], '{}'::float8[] );
+
+SELECT spoint( ARRAY[ 0, 1 ], ARRAY[ 0 ] );
+
+SELECT spoint( ARRAY[ 0, NULL ], ARRAY[ 0, 1 ] );
+
+SELECT spoint( ARRAY[ 0, 'Infinity' ]::float8[], ARRAY[ 0, 1 ] );
+
+
+-- distances to array elements ------------
+
+SELECT dist( spoint '(0d,0d)', ARRAY[ spoint '(0d,0d)', spoint '(1d,0d)', spoint '(180d,0d)', spoint '(0d,1e-7d)', spoint '(90d,90d)' ] );
+
+SELECT dist( spoint '(0d,0d)', '{}'::spoint[] );
+
+SELECT max( abs( d - dist( a[i], spoint '(0.3,0.2)' ) ) ) < 1e-12
+  FROM ( SELECT array_agg(p) AS a FROM spheretmp1 WHERE p IS NOT NULL ) AS t,
+       unnest( dist( spoint '(0.3,0.2)', a ) ) WITH ORDINALITY AS u(d,i);
+
+SELECT dist( spoint '(0d,0d)', ARRAY[ spoint '(0d,0d)', NULL ] );
+
+-- near 180 degrees the distance along the equator is the longitude
+SELECT abs( d - l ) < 1e-15 FROM unnest(
+  dist( spoint '(0d,0d)', ARRAY[ spoint( pi() - 1e-9, 0 ), spoint( pi() - 1e-6, 0 ), spoint( pi() - 1e-3, 0 ) ] ),
+  ARRAY[ pi() - 1e-9, pi() - 1e-6, pi() - 1e-3 ] ) AS u(d,l);
+
+-- centroid aggregate ------------
+
+SELECT spoint_centroid(p) = spoint '(5d,0d)' FROM ( VALUES ( spoint '(0d,0d)' ), ( spoint '(10d,0d)' ) ) AS t(p);
+
+SELECT spoint_centroid(p) = spoint '(0d,90d)' FROM ( VALUES ( spoint '(0d,45d)' ), ( spoint '(90d,45d)' ), ( spoint '(180d,45d)' ), ( spoint '(270d,45d)' ) ) AS t(p);
+
+SELECT spoint_centroid(p) IS NULL FROM ( VALUES ( spoint '(0d,0d)' ), ( spoint '(180d,0d)' ) ) AS t(p);
+
+SELECT spoint_centroid(p) IS NULL FROM ( VALUES ( spoint '(0d,0d)' ), ( NULL ) ) AS t(p) WHERE p IS NULL;
+
+
+-- friends-of-friends clustering ------------
+
+CREATE TABLE spheretmp_fof ( id int, p spoint );
+
+INSERT INTO spheretmp_fof SELECT i, spoint( radians( ( i / 10 ) * 2 + ( i % 10 ) * 0.05 ), radians( 10 + ( i % 3 ) * 0.01 ) ) FROM generate_series(1,50) AS i;
+
+INSERT INTO spheretmp_fof VALUES ( 100, spoint '(0d,90d)' ), ( 101, spoint '(180d,89.98d)' ), ( 102, spoint '(90d,89.995d)' ), ( 103, NULL ),
+                                 ( 104, spoint '(359.99d,-30d)' ), ( 105, spoint '(0.02d,-30d)' ), ( 106, spoint '(0.06d,-30d)' );
+
+SELECT cluster, count(*), min(id), max(id) FROM spoint_fof( 'SELECT id, p FROM spheretmp_fof', radians(0.06) ) GROUP BY cluster ORDER BY cluster;
+
+SELECT id, cluster FROM spoint_fof( 'SELECT id, p FROM spheretmp_fof WHERE id > 99', radians(0.035) ) ORDER BY id;
+
+SELECT count(*) FROM spoint_fof( 'SELECT id, p FROM spheretmp_fof WHERE false', 0.1 );
+
+SELECT count(*) FROM spoint_fof( 'SELECT id, p FROM spheretmp_fof', 0 );
+
+SELECT count(*) FROM spoint_fof( 'SELECT id, p FROM spheretmp_fof', 1e-300 );
+
+SELECT count(*), count( DISTINCT cluster ) FROM spoint_fof( 'SELECT id, p FROM spheretmp_fof', 1e-9 );
+
+SELECT count(*) FROM spoint_fof( 'SELECT NULL::int, p FROM spheretmp_fof', 0.1 );
+
+DROP TABLE spheretmp_fof;
+
+
+-- distance condition ------------
+
+SELECT spoint_dwithin(spoint '(0d,0d)', spoint '(1d,0d)', radians(1.0)), spoint_dwithin(spoint '(0d,0d)', spoint '(1d,0d)', radians(0.99));
+
+SELECT spoint_dwithin(spoint '(0d,89d)', spoint '(180d,89d)', radians(2.0)), spoint_dwithin(spoint '(0d,0d)', spoint '(180d,0d)', pi());
+
+CREATE TABLE spheretmp_dwithin AS SELECT p FROM spheretmp1 WHERE p IS NOT NULL;
+
+CREATE INDEX spheretmp_dwithin_idx ON spheretmp_dwithin USING gist (p);
+
+ANALYZE spheretmp_dwithin;
+
+SELECT count(*) FROM spheretmp_dwithin WHERE spoint_dwithin(p, spoint '(180d,0d)', 0.5);
+
+SELECT count(*) FROM spheretmp_dwithin WHERE dist(p, spoint '(180d,0d)') <= 0.5;
+
+SET enable_seqscan = OFF;
+
+EXPLAIN (COSTS OFF) SELECT count(*) FROM spheretmp_dwithin WHERE spoint_dwithin(spoint '(180d,0d)', p, 0.5);
+
+SELECT count(*) FROM spheretmp_dwithin WHERE spoint_dwithin(spoint '(180d,0d)', p, 0.5);
+
+SELECT count(*) FROM spheretmp_dwithin WHERE spoint_dwithin(p, spoint '(180d,0d)', 3.0);
+
+RESET enable_seqscan;
+
+DROP TABLE spheretmp_dwithin;
+
+
+-- text output precision ------------
+
+SELECT set_sphere_output( 'RAD' );
+
+SET extra_float_digits = 0;
+
+SELECT spoint(0.1::float8 + 0.2, 1e-7), spoint(1::float8 / 3, -0.5);
+
+SET extra_float_digits = 1;
+
+SELECT spoint(0.1::float8 + 0.2, 1e-7), spoint(1::float8 / 3, -0.5);
+
+SET extra_float_digits = 3;
+
+SELECT spoint(0.1::float8 + 0.2, 1e-7), spoint(1::float8 / 3, -0.5);
+
+SELECT spoint_send(spoint(0.1::float8 + 0.2, 1e-7)::text::spoint) = spoint_send(spoint(0.1::float8 + 0.2, 1e-7));
+
+SELECT set_sphere_output_precision(3);
+
+SELECT spoint(0.1::float8 + 0.2, -1e-7);
+
+SELECT set_sphere_output( 'DMS' );
+
+SELECT spoint(0.1::float8 + 0.2, -1e-7);
+
+SELECT set_sphere_output_precision(-1);
+
+SELECT set_sphere_output( 'RAD' );
+
+RESET extra_float_digits;
+
+
+-- compact points ---------------------
+
+SELECT set_sphere_output_precision(12);
+
+SELECT spoint4 '(10d,20d)', spoint4 '(0d,90d)', spoint4 '(359.99999999999d,-90d)', spoint4 '(180d,-45d)';
+
+SELECT spoint(spoint4 '(10.123456789d,-20.987654321d)') <-> spoint '(10.123456789d,-20.987654321d)' < 1e-9 AS close;
+
+SELECT spoint4(spoint(spoint4 '(1.234,0.5)')) = spoint4 '(1.234,0.5)';
+
+SELECT pg_column_size(spoint4 '(10d,20d)');
+
+SELECT spoint4 '(10d,20d)' = spoint4 '(10d,20d)', spoint4 '(10d,20d)' <> spoint4 '(10d,20d)', spoint4 '(10d,20d)' = spoint '(10d,20d)';
+
+SELECT dist(spoint4 '(0d,0d)', spoint4 '(1d,0d)') BETWEEN radians(1) - 1e-8 AND radians(1) + 1e-8;
+
+SELECT long(spoint4 '(10d,20d)'), lat(spoint4 '(10d,20d)');
+
+SELECT spoint4 '(10d,20d)' @ scircle '<(10d,20d),1d>', scircle '<(10d,20d),1d>' ~ spoint4 '(10.5d,20d)', spoint4 '(10d,20d)' !@ scircle '<(12d,20d),1d>';
+
+SELECT spoint4 '(0.5d,0.5d)' @ spoly '{(0d,0d),(1d,0d),(1d,1d)}', spoint4 '(0.5d,0.5d)' @ sbox '((0d,0d),(1d,1d))', spoint4 '(0.5d,0d)' @ sline '( 0d, 0d, 0d ), 1d', spoint4 '(0.5d,0d)' @ spath '{(0d,0d),(1d,0d)}', spoint4 '(0d,0d)' @ sellipse '<{ 10d, 5d},(0d,0d),0d>';
+
+SELECT set_sphere_output_precision(-1);
+
+SELECT spoint4_send((spoint4 '(1.234,0.5)')::text::spoint4) = spoint4_send(spoint4 '(1.234,0.5)');
+
+
+-- vector points ----------------------
+
+SELECT spoint3 '(10d,20d)', spoint3 '(0d,90d)', spoint3 '(180d,-45d)';
+
+SELECT spoint(spoint3 '(10.123456789d,-20.987654321d)') = spoint '(10.123456789d,-20.987654321d)';
+
+SELECT pg_column_size(spoint3 '(10d,20d)');
+
+SELECT spoint3 '(10d,20d)' = spoint3 '(10d,20d)', spoint3 '(10d,20d)' <> spoint3 '(10d,20d)', spoint3 '(10d,20d)' = spoint '(10d,20d)';
+
+SELECT dist(spoint3 '(0d,0d)', spoint3 '(1d,0d)') BETWEEN radians(1) - 1e-12 AND radians(1) + 1e-12, dist(spoint3 '(0d,0d)', spoint3 '(180d,0d)') = pi(), dist(spoint3 '(1d,1d)', spoint3 '(1d,1d)');
+
+SELECT spoint3 '(10d,20d)' @ scircle '<(10d,20d),1d>', scircle '<(10d,20d),1d>' ~ spoint3 '(10.5d,20d)', spoint3 '(10d,20d)' !@ scircle '<(12d,20d),1d>', scircle '<(12d,20d),1d>' !~ spoint3 '(10d,20d)';
+
+SELECT spoint3 '(1d,0d)' @ scircle '<(0d,0d),1d>', spoint3 '(90d,0d)' @ scircle '<(0d,0d),90d>', spoint3 '(0d,-1d)' @ scircle '<(0d,90d),90d>';
+
+SELECT spoint3 '(0.5d,0.5d)' @ spoly '{(0d,0d),(1d,0d),(1d,1d)}', spoint3 '(0.5d,0.5d)' @ sbox '((0d,0d),(1d,1d))';
+
+SELECT spoint3_send(spoint3 '(1.234,0.5)') = spoint3_send((spoint3 '(1.234,0.5)')::text::spoint3);
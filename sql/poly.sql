@@ -588,3 +588,101 @@ SELECT npoints( spoly '{
   (1.5121581120647 , -1.93925472462553e-05),
   (1.51214841579108 , -1.93925472462553e-05)
 }');
+
+-- self-crossing and overlapping edges
+SELECT spoly '{(0d,0d),(10d,10d),(10d,0d),(0d,10d)}';
+SELECT spoly '{(0d,0d),(10d,0d),(5d,0d),(5d,5d)}';
+SELECT npoints( spoly '{(0d,0d),(10d,0d),(10d,10d),(0d,0d),(-10d,-1d),(-5d,-10d)}' );
+SELECT spoly '{(0d,0d),(10d,0d),(10d,10d),(0d,0d),(-10d,10d),(-10d,-10d)}';
+SELECT spoly '{(0d,2d),(0d,0d),(1d,0d),(0d,-2d),(0d,0d),(-1d,1d)}';
+SELECT spoly '{(1d,1d),(-2d,1d),(-2d,-1d),(-1d,-1d),(-2d,0d)}';
+SELECT npoints( ( '{' || array_to_string( ARRAY(
+  SELECT '(0d,0d),(' || 5 * cos( ( i + 0.1 ) * 2 * pi() / 999 ) || 'd,' || 5 * sin( ( i + 0.1 ) * 2 * pi() / 999 ) || 'd),(' ||
+                        5 * cos( ( i + 0.45 ) * 2 * pi() / 999 ) || 'd,' || 5 * sin( ( i + 0.45 ) * 2 * pi() / 999 ) || 'd)'
+  FROM generate_series(0,998) AS i ), ',' ) || '}' )::spoly );
+
+-- polygon with many vertices
+SELECT npoints( ( '{' || array_to_string( ARRAY(
+  SELECT '(' || ( ( 1 + 0.1 * ( i % 2 ) ) * cos( i * pi() / 2500 ) / 10 ) ||
+         ','  || ( ( 1 + 0.1 * ( i % 2 ) ) * sin( i * pi() / 2500 ) / 10 ) || ')'
+  FROM generate_series(0,4999) AS i ), ',' ) || '}' )::spoly );
+
+-- polygon with many vertices as aggregate
+SELECT npoints( spoly(data.p) ) FROM (
+  SELECT spoint( ( 1 + 0.1 * ( i % 2 ) ) * cos( i * pi() / 2500 ) / 10 ,
+                 ( 1 + 0.1 * ( i % 2 ) ) * sin( i * pi() / 2500 ) / 10 ) AS p
+  FROM generate_series(0,4999) AS i ORDER BY i ) AS data ;
+
+-- polygon from arrays
+SELECT spoly( ARRAY[ radians(0), radians(10), radians(10) ], ARRAY[ radians(0), radians(0), radians(10) ] ) =
+       spoly '{(0d,0d),(10d,0d),(10d,10d)}';
+SELECT spoly( ARRAY[ spoint '(0d,0d)', spoint '(10d,0d)', spoint '(10d,10d)' ] ) =
+       spoly '{(0d,0d),(10d,0d),(10d,10d)}';
+SELECT spoly( spoint( ARRAY[ radians(0), radians(10), radians(10) ], ARRAY[ radians(0), radians(0), radians(10) ] ) ) =
+       spoly '{(0d,0d),(10d,0d),(10d,10d)}';
+SELECT npoints( spoly(
+  ARRAY( SELECT ( 1 + 0.1 * ( i % 2 ) ) * cos( i * pi() / 2500 ) / 10 FROM generate_series(0,4999) AS i ORDER BY i ),
+  ARRAY( SELECT ( 1 + 0.1 * ( i % 2 ) ) * sin( i * pi() / 2500 ) / 10 FROM generate_series(0,4999) AS i ORDER BY i ) ) );
+SELECT spoly( ARRAY[ 0, 0.1, 0.1 ], ARRAY[ 0, 0 ] );
+SELECT spoly( ARRAY[ 0, 0.1 ], ARRAY[ 0, 0 ] );
+SELECT spoly( ARRAY[ 0, 0.1, NULL ], ARRAY[ 0, 0, 0.1 ] );
+SELECT spoly( ARRAY[ 0, 0.1, 'NaN' ]::float8[], ARRAY[ 0, 0, 0.1 ] );
+SELECT spoly( ARRAY[ [ 0, 0.1 ], [ 0.1, 0 ] ], ARRAY[ [ 0, 0 ], [ 0.1, 0.1 ] ] );
+SELECT spoly( '{}'::float8[], '{}'::float8[] );
+SELECT spoly( ARRAY[ spoint '(0d,0d)', NULL, spoint '(10d,10d)' ] );
+
+-- convex hull aggregate
+SELECT spoly_hull(p) = spoly '{(0d,0d),(10d,0d),(10d,10d),(0d,10d)}' FROM ( VALUES
+  ( spoint '(0d,0d)' ), ( spoint '(5d,5d)' ), ( spoint '(10d,0d)' ), ( spoint '(5d,0d)' ),
+  ( spoint '(10d,10d)' ), ( spoint '(3d,7d)' ), ( spoint '(0d,10d)' ), ( NULL ), ( spoint '(0d,0d)' ) ) AS t(p);
+SELECT npoints( spoly_hull(p) ) FROM ( SELECT spoint( radians(i), radians( 80 + ( i % 7 ) ) ) AS p FROM generate_series(0,359) AS i ) AS t;
+SELECT count(*), bool_and( p @ h ) FROM (
+  SELECT spoint( 1 + 0.1 * sin(i), 0.5 + 0.1 * cos(3 * i) ) AS p FROM generate_series(1,1000) AS i
+) AS t, (
+  SELECT spoly_hull( spoint( 1 + 0.1 * sin(i), 0.5 + 0.1 * cos(3 * i) ) ) AS h FROM generate_series(1,1000) AS i
+) AS a;
+SELECT spoly_hull(p) FROM ( VALUES ( spoint '(0d,0d)' ), ( spoint '(10d,0d)' ), ( spoint '(20d,0d)' ) ) AS t(p);
+SELECT spoly_hull(p) FROM ( VALUES ( spoint '(0d,0d)' ), ( spoint '(180d,0d)' ), ( spoint '(90d,10d)' ) ) AS t(p);
+
+-- planner costs: cheap conditions first
+EXPLAIN (COSTS OFF) SELECT * FROM spheretmp1 WHERE p @ spoly '{(0,0),(1,0),(1,1),(0.5,1.5),(0,1)}' AND p @ spoly '{(0,0),(1,0),(1,1)}';
+EXPLAIN (COSTS OFF) SELECT * FROM spheretmp1 WHERE p @ spoly '{(0,0),(1,0),(1,1)}' AND p @ sellipse '<{10d,5d},(0d,0d),30d>' AND p = spoint '(0,0)';
+-- a packed polygon is costed by its count of vertices, not by its size
+EXPLAIN (COSTS OFF) SELECT * FROM spheretmp1 WHERE p @ spoly_pack( spoly '{(0,0),(0.001,0),(0.0018,0.0004),(0.002,0.001),(0.0016,0.0017),(0.001,0.002),(0.0003,0.0016),(0,0.001)}', 1e-9 ) AND p @ spoly '{(0,0),(1,0),(1,1),(0.5,1.5),(0,1)}';
+
+-- runtime counters
+SELECT pg_sphere_stats_reset();
+SELECT count(*) FROM pg_sphere_stats() WHERE value <> 0;
+SELECT count(*) FROM spheretmp1 WHERE p @ spoly '{(0,0),(1,0),(1,1),(0.5,1.5),(0,1)}';
+SELECT count(*) FROM ( VALUES ( spoly '{(0,0),(1,0),(1,1)}' ) ) AS t(s);
+SELECT name, value FROM pg_sphere_stats() WHERE name IN ( 'spoly_contains_point.calls', 'parser.calls' ) ORDER BY name;
+CREATE TABLE spheretmp_stats AS SELECT p FROM spheretmp1 WHERE p IS NOT NULL;
+CREATE INDEX spheretmp_stats_idx ON spheretmp_stats USING gist (p);
+SET enable_seqscan = OFF;
+SELECT count(*) FROM spheretmp_stats WHERE p @ spoly '{(0,0),(1,0),(1,1),(0.5,1.5),(0,1)}';
+RESET enable_seqscan;
+SELECT name, value > 0 FROM pg_sphere_stats() WHERE name LIKE 'gist.%' OR name LIKE 'gq_cache.%' ORDER BY name;
+DROP TABLE spheretmp_stats;
+SELECT pg_sphere_stats_reset();
+SELECT count(*) FROM pg_sphere_stats() WHERE value <> 0;
+
+-- packed polygons
+SELECT spoly_pack( spoly '{(10d,20d),(10.1d,20d),(10.1d,20.1d),(10d,20.1d)}', 1e-9 ) = spoly '{(10d,20d),(10.1d,20d),(10.1d,20.1d),(10d,20.1d)}';
+SELECT pg_column_size( spoly_pack( spoly '{(10d,20d),(10.1d,20d),(10.1d,20.1d),(10d,20.1d)}', 1e-9 ) ) < pg_column_size( spoly '{(10d,20d),(10.1d,20d),(10.1d,20.1d),(10d,20.1d)}' );
+SELECT spoly_pack( spoly '{(359.99d,89.9d),(0.05d,89.9d),(180d,89.95d)}', 1e-9 ) = spoly '{(359.99d,89.9d),(0.05d,89.9d),(180d,89.95d)}';
+SELECT npoints( spoly_pack( spoly '{(0d,0d),(1d,0d),(1d,1d)}', 1e-6 ) ), abs( area( spoly_pack( spoly '{(0d,0d),(1d,0d),(1d,1d)}', 1e-9 ) ) - area( spoly '{(0d,0d),(1d,0d),(1d,1d)}' ) ) < 1e-10;
+SELECT spoly_pack( spoly '{(0d,0d),(1d,0d),(1d,1d)}', 1e-9 ) ~ spoint '(0.9d,0.1d)', spoly_pack( spoly '{(0d,0d),(1d,0d),(1d,1d)}', 1e-9 ) && spoly_pack( spoly '{(0.5d,0d),(1.5d,0d),(1.5d,1d)}', 1e-9 );
+-- too coarse, returned unpacked
+SELECT pg_column_size( spoly_pack( spoly '{(0d,0d),(1d,0d),(1d,1d)}', 1 ) ) = pg_column_size( spoly '{(0d,0d),(1d,0d),(1d,1d)}' );
+SELECT spoly_pack( spoly '{(0d,0d),(1d,0d),(1d,1d)}', 0 );
+SELECT spoly_pack( spoly '{(0d,0d),(1d,0d),(1d,1d)}', 1e-300 );
+SELECT spoly_pack( spoly '{(0d,0d),(170d,0d),(170d,-80d)}', 1.4e-18 ) = spoly '{(0d,0d),(170d,0d),(170d,-80d)}';
+SELECT pg_column_size( spoly_unpack( spoly_pack( spoly '{(0d,0d),(1d,0d),(1d,1d)}', 1e-9 ) ) ) = pg_column_size( spoly '{(0d,0d),(1d,0d),(1d,1d)}' );
+CREATE TABLE spheretmp_pack AS SELECT spoly_pack( p, 1e-9 ) AS p FROM ( SELECT spoly( ARRAY[ spoint( x, y ), spoint( x + 0.01, y ), spoint( x + 0.01, y + 0.01 ), spoint( x, y + 0.01 ) ] ) AS p FROM generate_series( 0, 60 ) AS x, generate_series( -1, 1 ) AS y ) AS s;
+CREATE INDEX spheretmp_pack_idx ON spheretmp_pack USING gist (p);
+SET enable_seqscan = OFF;
+SELECT count(*) FROM spheretmp_pack WHERE p && scircle '<(1,0),1.1>';
+SELECT count(*) FROM spheretmp_pack WHERE p = spoly_pack( spoly '{(1,0),(1.01,0),(1.01,0.01),(1,0.01)}', 1e-9 );
+RESET enable_seqscan;
+SELECT count(*) FROM spheretmp_pack WHERE p && scircle '<(1,0),1.1>';
+DROP TABLE spheretmp_pack;
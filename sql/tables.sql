@@ -27,3 +27,7 @@ CREATE TABLE spheretmp5 (id int PRIMARY KEY , p spoly );
 CREATE TABLE spheretmp6 (id int PRIMARY KEY , p spath );
 \copy spheretmp6 from 'data/test_spherepath.data'
 
+CREATE TABLE spheretmp7 AS
+  SELECT sellipse ( spoint ( 0.37*i , asin ( sin ( 0.91*i ) ) ) ,
+                    0.01 + 0.6*abs( sin( 1.3*i ) ) , 0.01*abs( sin( 1.7*i ) ) , 0.23*i ) AS e
+  FROM generate_series ( 1 , 5000 ) AS i;
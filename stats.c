@@ -0,0 +1,127 @@
+#include "stats.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "utils/tuplestore.h"
+
+/*!
+  \file
+  \brief Runtime counters
+*/
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#if PG_VERSION_NUM >= 80400
+  PG_FUNCTION_INFO_V1(pg_sphere_stats);
+#endif
+  PG_FUNCTION_INFO_V1(pg_sphere_stats_reset);
+
+#endif
+
+uint64 pgs_stat_counter[PGS_STAT_COUNT];
+
+uint64 pgs_stat_gist[PGS_TYPE_SBOX + 1][PGS_STAT_MAX_STRATEGY + 1][PGS_STAT_GIST_COUNT];
+
+/*!
+  \brief names of event counters
+  \see PGS_STAT_COUNTERS
+*/
+static const char * const pgs_stat_names[PGS_STAT_COUNT] = {
+  "gq_cache.hit",
+  "gq_cache.miss",
+  "spoly_contains_point.calls",
+  "spoly_contains_point.retries",
+  "sellipse_ellipse_pos.calls",
+  "sellipse_ellipse_pos.iterations",
+  "parser.calls"
+};
+
+/*!
+  \brief names of GiST operator classes
+  \see PGS_DATA_TYPES
+*/
+static const char * const pgs_stat_opclasses[PGS_TYPE_SBOX + 1] = {
+  NULL, "spoint", "scircle", "sellipse", "sline", "spath", "spoly", "sbox"
+};
+
+/*!
+  \brief names of GiST consistent counters
+  \see PGS_STAT_GIST
+*/
+static const char * const pgs_stat_gist_names[PGS_STAT_GIST_COUNT] = {
+  "inner", "leaf", "recheck"
+};
+
+
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    \brief appends a counter to the result set
+    \param out  result set
+    \param desc row descriptor
+    \param name counter name
+    \param val  counter value
+  */
+  static void pgs_stat_put ( Tuplestorestate * out, TupleDesc desc, const char * name, uint64 val )
+  {
+    Datum  values[2];
+    bool   nulls[2] = { false, false };
+
+    values[0] = CStringGetTextDatum ( name );
+    values[1] = Int64GetDatum ( ( int64 ) val );
+    tuplestore_putvalues ( out, desc, values, nulls );
+  }
+
+
+  Datum  pg_sphere_stats(PG_FUNCTION_ARGS)
+  {
+    ReturnSetInfo    * rsinfo = ( ReturnSetInfo * ) fcinfo->resultinfo;
+    MemoryContext      oldctx;
+    Tuplestorestate  * out;
+    TupleDesc          desc;
+    char               name[64];
+    int                t, s, c;
+
+    if ( rsinfo == NULL || ! IsA ( rsinfo, ReturnSetInfo ) ||
+         ( rsinfo->allowedModes & SFRM_Materialize ) == 0 ){
+      elog ( ERROR , "pg_sphere_stats: set-valued function called in context that cannot accept a set" );
+    }
+    if ( get_call_result_type ( fcinfo, NULL, &desc ) != TYPEFUNC_COMPOSITE ){
+      elog ( ERROR , "pg_sphere_stats: return type must be a row type" );
+    }
+
+    oldctx = MemoryContextSwitchTo ( rsinfo->econtext->ecxt_per_query_memory );
+    desc   = CreateTupleDescCopy ( desc );
+    out    = tuplestore_begin_heap ( false, false, work_mem );
+
+    for ( c = 0; c < PGS_STAT_COUNT; c++ ){
+      pgs_stat_put ( out, desc, pgs_stat_names[c], pgs_stat_counter[c] );
+    }
+    // only strategies in use
+    for ( t = PGS_TYPE_SPoint; t <= PGS_TYPE_SBOX; t++ ){
+      for ( s = 0; s <= PGS_STAT_MAX_STRATEGY; s++ ){
+        if ( pgs_stat_gist[t][s][PGS_STAT_GIST_INNER] == 0 && pgs_stat_gist[t][s][PGS_STAT_GIST_LEAF] == 0 ){
+          continue;
+        }
+        for ( c = 0; c < PGS_STAT_GIST_COUNT; c++ ){
+          snprintf ( name, sizeof ( name ), "gist.%s.%d.%s", pgs_stat_opclasses[t], s, pgs_stat_gist_names[c] );
+          pgs_stat_put ( out, desc, name, pgs_stat_gist[t][s][c] );
+        }
+      }
+    }
+    MemoryContextSwitchTo ( oldctx );
+
+    rsinfo->returnMode = SFRM_Materialize;
+    rsinfo->setResult  = out;
+    rsinfo->setDesc    = desc;
+    return ( Datum ) 0;
+  }
+
+#endif
+
+
+  Datum  pg_sphere_stats_reset(PG_FUNCTION_ARGS)
+  {
+    memset ( pgs_stat_counter, 0, sizeof ( pgs_stat_counter ) );
+    memset ( pgs_stat_gist, 0, sizeof ( pgs_stat_gist ) );
+    PG_RETURN_VOID ( );
+  }
@@ -0,0 +1,108 @@
+#ifndef __PGS_STATS_H__
+#define __PGS_STATS_H__
+
+#include "types.h"
+
+/*!
+  \file
+  \brief Runtime counters
+*/
+
+/*!
+  \addtogroup PGS_STAT_COUNTERS
+  \brief Event counters
+  @{
+*/
+#define PGS_STAT_GQ_CACHE_HIT        0   //!< query key found in GiST query cache
+#define PGS_STAT_GQ_CACHE_MISS       1   //!< query key computed and stored in cache
+#define PGS_STAT_SPOLY_CONT_POINT    2   //!< crossing tests of spoly_contains_point
+#define PGS_STAT_SPOLY_CONT_RETRY    3   //!< random rotations of spoly_contains_point
+#define PGS_STAT_SELLIPSE_POS        4   //!< calls of sellipse_ellipse_pos
+#define PGS_STAT_SELLIPSE_POS_ITER   5   //!< boundary steps and root iterations of sellipse_ellipse_pos
+#define PGS_STAT_PARSER              6   //!< calls of the input parser
+#define PGS_STAT_COUNT               7   //!< count of event counters
+/* @} */
+
+/*!
+  \brief highest strategy number of the GiST operator classes
+*/
+#define PGS_STAT_MAX_STRATEGY       37
+
+/*!
+  \addtogroup PGS_STAT_GIST
+  \brief Counters of GiST consistent calls
+  @{
+*/
+#define PGS_STAT_GIST_INNER          0   //!< consistent calls on inner keys
+#define PGS_STAT_GIST_LEAF           1   //!< consistent calls on leaf keys
+#define PGS_STAT_GIST_RECHECK        2   //!< leaf keys returned for recheck
+#define PGS_STAT_GIST_COUNT          3   //!< count of consistent counters
+/* @} */
+
+/*!
+  \brief event counters of this backend
+*/
+extern uint64 pgs_stat_counter[PGS_STAT_COUNT];
+
+/*!
+  The first index is the \link PGS_DATA_TYPES type \endlink of the
+  operator class, the second one is the strategy number.
+  \brief GiST consistent counters of this backend
+*/
+extern uint64 pgs_stat_gist[PGS_TYPE_SBOX + 1][PGS_STAT_MAX_STRATEGY + 1][PGS_STAT_GIST_COUNT];
+
+/*!
+  \brief increments an event counter
+  \param c \link PGS_STAT_COUNTERS counter \endlink
+*/
+#define PGS_STAT_INC( c )  ( pgs_stat_counter[c]++ )
+
+/*!
+  \brief adds a value to an event counter
+  \param c \link PGS_STAT_COUNTERS counter \endlink
+  \param n value to add
+*/
+#define PGS_STAT_ADD( c , n )  ( pgs_stat_counter[c] += ( n ) )
+
+/*!
+  \brief counts a call of a GiST consistent method
+  \param type     \link PGS_DATA_TYPES type \endlink of operator class
+  \param strategy strategy number
+  \param leaf     true, if the key is a leaf key
+  \param result   result of the consistent method
+*/
+#define PGS_STAT_GIST( type , strategy , leaf , result ) do { \
+  if ( ( strategy ) <= PGS_STAT_MAX_STRATEGY ){ \
+    uint64 * gc = pgs_stat_gist[PGS_TYPE_##type][strategy]; \
+    if ( leaf ){ \
+      gc[PGS_STAT_GIST_LEAF]++; \
+      if ( result ) gc[PGS_STAT_GIST_RECHECK]++; \
+    } else { \
+      gc[PGS_STAT_GIST_INNER]++; \
+    } \
+  } \
+} while (0)
+
+
+#if PG_VERSION_NUM >= 80400
+
+  /*!
+    Returns the counters of the current backend as rows of name and
+    value. Counters of parallel workers are not included.
+    \brief runtime counters
+    \return set of ( name, value )
+    \note PostgreSQL function
+  */
+  Datum  pg_sphere_stats(PG_FUNCTION_ARGS);
+
+#endif
+
+  /*!
+    \brief sets all counters of the current backend to zero
+    \return void
+    \note PostgreSQL function
+  */
+  Datum  pg_sphere_stats_reset(PG_FUNCTION_ARGS);
+
+
+#endif
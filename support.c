@@ -0,0 +1,290 @@
+#include "support.h"
+
+#if PG_VERSION_NUM >= 120000
+
+#include "access/htup_details.h"
+#include "catalog/pg_type.h"
+#include "nodes/makefuncs.h"
+#include "nodes/nodeFuncs.h"
+#include "nodes/pathnodes.h"
+#include "nodes/supportnodes.h"
+#include "optimizer/cost.h"
+#include "optimizer/optimizer.h"
+#include "parser/parse_func.h"
+#include "parser/parsetree.h"
+#include "utils/lsyscache.h"
+#include "utils/syscache.h"
+#include "polygon.h"
+
+/*!
+  \file
+  \brief Planner support functions
+*/
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  PG_FUNCTION_INFO_V1(spherepoint_dwithin_support);
+  PG_FUNCTION_INFO_V1(pgs_cost_support);
+
+#endif
+
+/*!
+  \brief strategy number of spoint @ scircle in the spoint GiST operator class
+*/
+#define PGS_SPOINT_IN_CIRCLE_STRATEGY  11
+
+/*!
+  The costs are multiples of cpu_operator_cost. They were measured
+  relative to an integer comparison: a point-in-polygon test needs
+  about 50 times longer per vertex, most ellipse operations about
+  25 times longer.
+  \brief cost per vertex of a polygon or path
+*/
+#define PGS_VERTEX_COST    50.0
+
+/*!
+  \brief cost of an ellipse argument
+*/
+#define PGS_ELLIPSE_COST   25.0
+
+/*!
+  \brief count of vertices, if nothing is known about a polygon or path
+*/
+#define PGS_DEFAULT_NPTS    8.0
+
+/*!
+  The offsets of a packed vertex take 4 bytes each with a unit
+  of 1e-9 radians and vertices less than a degree apart.
+  \brief typical size of a packed vertex in bytes
+*/
+#define PGS_PACKED_VERTEX_SIZE  8.0
+
+
+  /*!
+    \brief returns the radius of spoint_dwithin, if it is a usable constant
+    \param n radius argument
+    \param r pointer to radius
+    \return true, if the radius is a constant between 0 and 90 degrees
+  */
+  static bool pgs_dwithin_radius ( Node * n, float8 * r )
+  {
+    Const * c;
+
+    if ( ! IsA ( n, Const ) ){
+      return FALSE;
+    }
+    c = ( Const * ) n;
+    if ( c->constisnull || c->consttype != FLOAT8OID ){
+      return FALSE;
+    }
+    *r = DatumGetFloat8 ( c->constvalue );
+    return ( *r >= 0.0 && *r <= PIH );
+  }
+
+
+  /*!
+    \brief creates the index condition p @ scircle ( center, r )
+    \param req index condition request of spoint_dwithin
+    \return list of index conditions or NIL
+  */
+  static List * pgs_dwithin_index_condition ( SupportRequestIndexCondition * req )
+  {
+    FuncExpr  * fe;
+    Node      * ip, * op, * rad;
+    Oid         nsp, ptype, ctype, opoid, fnoid;
+    Oid         argtypes[2];
+    Relids      varnos;
+    float8      r;
+    Expr      * circle;
+
+    if ( ! is_funcclause ( req->node ) || req->indexarg > 1 ){
+      return NIL;
+    }
+    fe = ( FuncExpr * ) req->node;
+    if ( list_length ( fe->args ) != 3 ){
+      return NIL;
+    }
+    ip  = ( Node * ) list_nth ( fe->args, req->indexarg );
+    op  = ( Node * ) list_nth ( fe->args, 1 - req->indexarg );
+    rad = ( Node * ) lthird ( fe->args );
+
+    if ( ! pgs_dwithin_radius ( rad, &r ) ){
+      return NIL;
+    }
+
+    // the center must be known before scanning the index
+#if PG_VERSION_NUM >= 140000
+    varnos = pull_varnos ( req->root, op );
+#else
+    varnos = pull_varnos ( op );
+#endif
+    if ( bms_is_member ( req->index->rel->relid, varnos ) || contain_volatile_functions ( op ) ){
+      return NIL;
+    }
+
+    // all objects of pg_sphere are in the schema of this function
+    nsp   = get_func_namespace ( req->funcid );
+    ptype = exprType ( ip );
+    ctype = GetSysCacheOid2 ( TYPENAMENSP, Anum_pg_type_oid,
+                              CStringGetDatum ( "scircle" ), ObjectIdGetDatum ( nsp ) );
+    if ( ! OidIsValid ( ctype ) ){
+      return NIL;
+    }
+    opoid = get_opfamily_member ( req->opfamily, ptype, ctype, PGS_SPOINT_IN_CIRCLE_STRATEGY );
+    if ( ! OidIsValid ( opoid ) ){
+      return NIL;
+    }
+    argtypes[0] = ptype;
+    argtypes[1] = FLOAT8OID;
+    fnoid = LookupFuncName ( list_make2 ( makeString ( get_namespace_name ( nsp ) ), makeString ( "scircle" ) ),
+                             2, argtypes, true );
+    if ( ! OidIsValid ( fnoid ) ){
+      return NIL;
+    }
+
+    circle = ( Expr * ) makeFuncExpr ( fnoid, ctype,
+                                       list_make2 ( copyObject ( op ), copyObject ( rad ) ),
+                                       InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL );
+    req->lossy = TRUE;
+    return list_make1 ( make_opclause ( opoid, BOOLOID, false, ( Expr * ) copyObject ( ip ), circle,
+                                        InvalidOid, InvalidOid ) );
+  }
+
+
+  Datum  spherepoint_dwithin_support(PG_FUNCTION_ARGS)
+  {
+    Node * rawreq = ( Node * ) PG_GETARG_POINTER ( 0 );
+    Node * ret    = NULL;
+
+    if ( IsA ( rawreq, SupportRequestIndexCondition ) ){
+      ret = ( Node * ) pgs_dwithin_index_condition ( ( SupportRequestIndexCondition * ) rawreq );
+    } else if ( IsA ( rawreq, SupportRequestSelectivity ) ){
+      SupportRequestSelectivity * req = ( SupportRequestSelectivity * ) rawreq;
+      float8                      r;
+
+      if ( list_length ( req->args ) == 3 && pgs_dwithin_radius ( ( Node * ) lthird ( req->args ), &r ) ){
+        // fraction of the sphere covered by the circle
+        req->selectivity = ( 1.0 - cos ( r ) ) / 2.0;
+        ret = ( Node * ) req;
+      }
+    }
+    PG_RETURN_POINTER ( ret );
+  }
+
+
+  /*!
+    \brief returns the object id of a pg_sphere type
+    \param nsp  namespace of pg_sphere
+    \param name type name
+    \return type oid or InvalidOid
+  */
+  static Oid pgs_type_oid ( Oid nsp, const char * name )
+  {
+    return GetSysCacheOid2 ( TYPENAMENSP, Anum_pg_type_oid,
+                             CStringGetDatum ( name ), ObjectIdGetDatum ( nsp ) );
+  }
+
+
+  /*!
+    Polygons and paths have the same layout, hence the count of
+    vertices of a constant is read from its header. For a column
+    only the average width is known. It may hold packed values,
+    so the larger of the counts for unpacked and packed vertices
+    is used.
+    \brief estimates the count of vertices of a polygon or path
+    \param root planner infrastructure, may be NULL
+    \param n    argument expression, may be NULL
+    \return count of vertices
+  */
+  static float8 pgs_cost_npts ( PlannerInfo * root, Node * n )
+  {
+    float8  size = 0.0;
+
+    if ( n && IsA ( n, Const ) && ! ( ( Const * ) n )->constisnull ){
+      SPOLY * sp = ( SPOLY * ) PG_DETOAST_DATUM ( ( ( Const * ) n )->constvalue );
+
+      return Max ( ( float8 ) ( sp->npts & ~PGS_PACKED ), 2.0 );
+    } else if ( root && n && IsA ( n, Var ) && ( ( Var * ) n )->varlevelsup == 0 ){
+      Var           * v   = ( Var * ) n;
+      RangeTblEntry * rte = planner_rt_fetch ( v->varno, root );
+
+      if ( rte->rtekind == RTE_RELATION && v->varattno > 0 ){
+        size = ( float8 ) get_attavgwidth ( rte->relid, v->varattno );
+      }
+    }
+    if ( size > offsetof ( SPACKED, data ) ){
+      float8 npts = ( size - offsetof ( SPOLY, p ) ) / sizeof ( SPoint );
+
+      npts = Max ( npts, ( size - offsetof ( SPACKED, data ) ) / PGS_PACKED_VERTEX_SIZE + 1.0 );
+      return Max ( npts, 2.0 );
+    } else if ( size > offsetof ( SPOLY, p ) ){
+      return Max ( ( size - offsetof ( SPOLY, p ) ) / sizeof ( SPoint ), 2.0 );
+    }
+    return PGS_DEFAULT_NPTS;
+  }
+
+
+  /*!
+    \brief estimates the cost of one call of a geometric function
+    \param req cost request
+    \return true, if the function has polygon, path or ellipse arguments
+  */
+  static bool pgs_cost_estimate ( SupportRequestCost * req )
+  {
+    List     * args  = NIL;
+    Oid      * types = NULL;
+    Oid        nsp, poly, path, ellipse;
+    int        nargs = 0, i;
+    float8     npts  = 1.0, cost = 1.0;
+    bool       found = FALSE;
+
+    if ( req->node && IsA ( req->node, FuncExpr ) ){
+      args = ( ( FuncExpr * ) req->node )->args;
+    } else if ( req->node && IsA ( req->node, OpExpr ) ){
+      args = ( ( OpExpr * ) req->node )->args;
+    }
+    get_func_signature ( req->funcid, &types, &nargs );
+    if ( args != NIL && list_length ( args ) != nargs ){
+      return FALSE;
+    }
+
+    nsp     = get_func_namespace ( req->funcid );
+    poly    = pgs_type_oid ( nsp, "spoly" );
+    path    = pgs_type_oid ( nsp, "spath" );
+    ellipse = pgs_type_oid ( nsp, "sellipse" );
+
+    for ( i = 0; i < nargs; i++ ){
+      Node * arg = ( args != NIL ) ? ( Node * ) list_nth ( args, i ) : NULL;
+      Oid    typ = arg ? exprType ( arg ) : types[i];
+
+      if ( typ == poly || typ == path ){
+        // operations of two polygons or paths compare all edges
+        npts  *= pgs_cost_npts ( req->root, arg );
+        found  = TRUE;
+      } else if ( typ == ellipse ){
+        cost  += PGS_ELLIPSE_COST;
+        found  = TRUE;
+      }
+    }
+    if ( found ){
+      if ( npts > 1.0 ){
+        cost += PGS_VERTEX_COST * npts;
+      }
+      req->startup   = 0;
+      req->per_tuple = cost * cpu_operator_cost;
+    }
+    return found;
+  }
+
+
+  Datum  pgs_cost_support(PG_FUNCTION_ARGS)
+  {
+    Node * rawreq = ( Node * ) PG_GETARG_POINTER ( 0 );
+
+    if ( IsA ( rawreq, SupportRequestCost ) && pgs_cost_estimate ( ( SupportRequestCost * ) rawreq ) ){
+      PG_RETURN_POINTER ( rawreq );
+    }
+    PG_RETURN_POINTER ( NULL );
+  }
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef __PGS_SUPPORT_H__
+#define __PGS_SUPPORT_H__
+
+#include "point.h"
+
+/*!
+  \file
+  \brief Planner support functions
+*/
+
+
+#if PG_VERSION_NUM >= 120000
+
+  /*!
+    Handles the planner requests for spoint_dwithin ( p1, p2, r ).
+    If one point is an indexed column and the other point does not
+    depend on its table, the index condition p1 @ scircle ( p2, r )
+    is added. The selectivity is the area of the circle divided by
+    the area of the sphere.
+    \brief planner support of spoint_dwithin
+    \return pointer to answered request or NULL
+    \note PostgreSQL function
+  */
+  Datum  spherepoint_dwithin_support(PG_FUNCTION_ARGS);
+
+  /*!
+    Estimates the evaluation cost of functions with polygon, path
+    or ellipse arguments. The cost of polygons and paths grows with
+    the count of vertices, which is taken from constants, from the
+    column statistics or is a default. Ellipses have a fixed cost.
+    \brief planner cost estimation of geometric functions
+    \return pointer to answered request or NULL
+    \note PostgreSQL function
+  */
+  Datum  pgs_cost_support(PG_FUNCTION_ARGS);
+
+#endif
+
+
+#endif
@@ -0,0 +1,76 @@
+\echo -- sellipse && sellipse, sellipse @ sellipse
+-- sellipse && sellipse, sellipse @ sellipse
+
+\echo -- ellipse pairs have to be created using
+-- ellipse pairs have to be created using
+
+\echo -- ./gen_ellipse.pl 10000 10 | psql pgsphere_test
+-- ./gen_ellipse.pl 10000 10 | psql pgsphere_test
+
+\echo -- ./gen_ellipse.pl 10000 60 2 | sed 's/sellipse_pair_data/sellipse_pair_data2/' | psql pgsphere_test
+-- ./gen_ellipse.pl 10000 60 2 | sed 's/sellipse_pair_data/sellipse_pair_data2/' | psql pgsphere_test
+
+\echo -- scripts. Switch timing on in psql to benchmark the queries.
+-- scripts. Switch timing on in psql to benchmark the queries.
+
+\echo 
+
+
+\echo -- should be "true"
+-- should be "true"
+
+\echo SELECT '<{10d,5d},(0d,0d),0d>'::sellipse && '<{10d,5d},(15d,0d),0d>'::sellipse;
+SELECT '<{10d,5d},(0d,0d),0d>'::sellipse && '<{10d,5d},(15d,0d),0d>'::sellipse;
+
+\echo SELECT '<{10d,5d},(0d,0d),90d>'::sellipse && '<{10d,5d},(0d,12d),90d>'::sellipse;
+SELECT '<{10d,5d},(0d,0d),90d>'::sellipse && '<{10d,5d},(0d,12d),90d>'::sellipse;
+
+\echo SELECT '<{10d,5d},(0d,0d),0d>'::sellipse && '<{10d,5d},(0d,9d),90d>'::sellipse;
+SELECT '<{10d,5d},(0d,0d),0d>'::sellipse && '<{10d,5d},(0d,9d),90d>'::sellipse;
+
+\echo SELECT '<{10d,5d},(0d,0d),0d>'::sellipse ~ '<{3d,1d},(5d,0d),0d>'::sellipse;
+SELECT '<{10d,5d},(0d,0d),0d>'::sellipse ~ '<{3d,1d},(5d,0d),0d>'::sellipse;
+
+\echo -- should be "false"
+-- should be "false"
+
+\echo SELECT '<{10d,5d},(0d,0d),0d>'::sellipse && '<{10d,5d},(0d,12d),0d>'::sellipse;
+SELECT '<{10d,5d},(0d,0d),0d>'::sellipse && '<{10d,5d},(0d,12d),0d>'::sellipse;
+
+\echo SELECT '<{10d,5d},(0d,0d),0d>'::sellipse && '<{10d,5d},(21d,0d),0d>'::sellipse;
+SELECT '<{10d,5d},(0d,0d),0d>'::sellipse && '<{10d,5d},(21d,0d),0d>'::sellipse;
+
+\echo SELECT '<{10d,5d},(0d,0d),0d>'::sellipse ~ '<{3d,1d},(8d,0d),0d>'::sellipse;
+SELECT '<{10d,5d},(0d,0d),0d>'::sellipse ~ '<{3d,1d},(8d,0d),0d>'::sellipse;
+
+\echo 
+
+
+\echo select count(id) from sellipse_pair_data where e1 && e2;
+select count(id) from sellipse_pair_data where e1 && e2;
+
+\echo select count(id) from sellipse_pair_data where e1 !&& e2;
+select count(id) from sellipse_pair_data where e1 !&& e2;
+
+\echo select count(id) from sellipse_pair_data where e1 ~ e2;
+select count(id) from sellipse_pair_data where e1 ~ e2;
+
+\echo select count(id) from sellipse_pair_data where e1 @ e2;
+select count(id) from sellipse_pair_data where e1 @ e2;
+
+\echo 
+
+
+\echo select count(id) from sellipse_pair_data2 where e1 && e2;
+select count(id) from sellipse_pair_data2 where e1 && e2;
+
+\echo select count(id) from sellipse_pair_data2 where e1 !&& e2;
+select count(id) from sellipse_pair_data2 where e1 !&& e2;
+
+\echo select count(id) from sellipse_pair_data2 where e1 ~ e2;
+select count(id) from sellipse_pair_data2 where e1 ~ e2;
+
+\echo select count(id) from sellipse_pair_data2 where e1 @ e2;
+select count(id) from sellipse_pair_data2 where e1 @ e2;
+
+\echo 
@@ -0,0 +1,56 @@
+\echo -- Euler transformation of many points
+-- Euler transformation of many points
+
+\echo -- A path of 100000 points is transformed 100 times, that are
+-- A path of 100000 points is transformed 100 times, that are
+
+\echo -- 10 million transformed points per query. Switch timing on
+-- 10 million transformed points per query. Switch timing on
+
+\echo -- in psql to benchmark the queries. Divide the number of points
+-- in psql to benchmark the queries. Divide the number of points
+
+\echo -- by the time of the query to get the points per second.
+-- by the time of the query to get the points per second.
+
+\echo 
+
+
+\echo CREATE TABLE euler_path_data AS SELECT spath(p) AS p FROM ( SELECT spoint( 0.003*i, 0.5*sin(0.0001*i) ) AS p FROM generate_series(1,100000) AS i ) AS t;
+CREATE TABLE euler_path_data AS SELECT spath(p) AS p FROM ( SELECT spoint( 0.003*i, 0.5*sin(0.0001*i) ) AS p FROM generate_series(1,100000) AS i ) AS t;
+
+\echo SELECT npoints(p) FROM euler_path_data;
+SELECT npoints(p) FROM euler_path_data;
+
+\echo 
+
+
+\echo SELECT count(*) FROM euler_path_data, generate_series(1,100) AS i WHERE npoints( p + strans( 0.01*i, 0.2, 0.3 ) ) = 100000;
+SELECT count(*) FROM euler_path_data, generate_series(1,100) AS i WHERE npoints( p + strans( 0.01*i, 0.2, 0.3 ) ) = 100000;
+
+\echo SELECT count(*) FROM euler_path_data, generate_series(1,100) AS i WHERE npoints( p - strans( 0.01*i, 0.2, 0.3, 'XYZ' ) ) = 100000;
+SELECT count(*) FROM euler_path_data, generate_series(1,100) AS i WHERE npoints( p - strans( 0.01*i, 0.2, 0.3, 'XYZ' ) ) = 100000;
+
+\echo 
+
+
+\echo -- transformation and inverse transformation should return the input path
+-- transformation and inverse transformation should return the input path
+
+\echo SELECT count(*) FROM euler_path_data, generate_series(1,10) AS i WHERE ( p + strans( 0.1*i, 0.2, 0.3 ) ) - strans( 0.1*i, 0.2, 0.3 ) = p;
+SELECT count(*) FROM euler_path_data, generate_series(1,10) AS i WHERE ( p + strans( 0.1*i, 0.2, 0.3 ) ) - strans( 0.1*i, 0.2, 0.3 ) = p;
+
+\echo 
+
+
+\echo -- single points, 1 million transformations
+-- single points, 1 million transformations
+
+\echo SELECT count(*) FROM generate_series(1,1000000) AS i WHERE spoint( 0.001*i, 0.0 ) + strans( 0.1, 0.2, 0.3 ) <> spoint( 0.001*i, 0.0 );
+SELECT count(*) FROM generate_series(1,1000000) AS i WHERE spoint( 0.001*i, 0.0 ) + strans( 0.1, 0.2, 0.3 ) <> spoint( 0.001*i, 0.0 );
+
+\echo 
+
+
+\echo DROP TABLE euler_path_data;
+DROP TABLE euler_path_data;
@@ -0,0 +1,65 @@
+#!/usr/bin/perl
+
+my $count=$ARGV[0];
+my $seed=$ARGV[1];
+if ($#ARGV == -1) {
+	print "gen_copy.pl: pg_sphere COPY throughput data generator\n";
+	print "usage:\n\tgen_copy.pl <count> [seed] | psql pgsphere_db\n\n";
+
+	print "Program generates \"count\" rows of spherical points and\n";
+	print "circles and SQL script to load them into existing database\n";
+	print "with COPY. Most values use the plain forms \"(lng, lat)\"\n";
+	print "in radians or degrees, every tenth row is written with\n";
+	print "degrees, minutes and seconds or hours, minutes and seconds.\n";
+	print "The \"seed\" of random generator defaults to 1, so the\n";
+	print "same dataset is generated on each run.\n\n";
+	print "Example: \"gen_copy.pl 1000000 > copy.sql\" writes\n";
+	print "one million rows. Run the script with timing switched on\n";
+	print "in psql and divide the number of rows by the time of\n";
+	print "the COPY command to get the rows per second.\n\n";
+	print "Program automatically creates \"spoint_copy_data\" table\n";
+	print "but does not DROP an existing table with this name.\n\n";
+	exit(0);
+}
+
+my $pi=3.1415926535897932;
+
+if ($count <= 0) {$count = 1000000;}
+if (!defined($seed)) {$seed = 1;}
+srand($seed);
+
+
+print <<END ;
+CREATE TABLE spoint_copy_data (id int, p spoint, c scircle);
+
+COPY spoint_copy_data (id, p, c) FROM stdin;
+END
+
+
+for (my $i=1; $i<=$count; $i++) {
+    my $lng = 360.0*rand();
+    my $lat = 180.0*rand() - 90.0;
+    my $rad = 10.0*rand();
+    if ($i % 10 == 0) {
+	my $h = int($lng/15.0);
+	my $m = int(($lng/15.0 - $h)*60.0);
+	my $s = (($lng/15.0 - $h)*60.0 - $m)*60.0;
+	my $sign = ($lat < 0) ? "-" : "+";
+	my $d = int(abs($lat));
+	my $dm = int((abs($lat) - $d)*60.0);
+	my $ds = ((abs($lat) - $d)*60.0 - $dm)*60.0;
+	if ($s  >= 59.9995) {$s  = 59.999;}
+	if ($ds >= 59.995)  {$ds = 59.99;}
+	printf("%d\t(%dh %dm %.3fs, %s%dd %d' %.2f\")\t<(%dh %dm %.3fs, %s%dd %d' %.2f\"), %.6fd>\n",
+	       $i, $h, $m, $s, $sign, $d, $dm, $ds, $h, $m, $s, $sign, $d, $dm, $ds, $rad);
+    } elsif ($i % 2 == 0) {
+	printf("%d\t(%.8fd, %.8fd)\t<(%.8fd, %.8fd), %.6fd>\n",
+	       $i, $lng, $lat, $lng, $lat, $rad);
+    } else {
+	printf("%d\t(%.15f, %.15f)\t<(%.15f, %.15f), %.15f>\n",
+	       $i, $lng*$pi/180.0, $lat*$pi/180.0, $lng*$pi/180.0, $lat*$pi/180.0, $rad*$pi/180.0);
+    }
+}
+
+print "\\.\n\n";
+print "SELECT count(*) FROM spoint_copy_data;\n";
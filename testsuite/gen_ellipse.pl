@@ -0,0 +1,70 @@
+#!/usr/bin/perl
+
+my $count=$ARGV[0];
+my $radius=$ARGV[1];
+my $seed=$ARGV[2];
+if ($#ARGV <= 0) {
+	print "gen_ellipse.pl: Generic pg_sphere \"sellipse\" pair generator\n";
+	print "usage:\n\tgen_ellipse.pl <count> <radius> [seed] | psql pgsphere_db\n\n";
+
+	print "Program generates pairs of random spherical ellipses\n";
+	print "and SQL script to load them into existing database.\n";
+	print "Major axes are chosen between 0 and \"radius\" in degrees,\n";
+	print "minor axes between 0 and the major axis. The center of\n";
+	print "the second ellipse is placed within the sum of both major\n";
+	print "axes around the center of the first one, so most pairs\n";
+	print "overlap or nearly touch each other.\n";
+	print "The radius should be between 0 and 90.\n";
+	print "The \"seed\" of random generator defaults to 1, so the\n";
+	print "same dataset is generated on each run.\n\n";
+	print "Example: \"gen_ellipse.pl 10000 10\" generates 10000\n";
+	print "pairs of ellipses with major axes up to 10 degrees.\n\n";
+	print "Program automatically creates \"sellipse_pair_data\" table\n";
+	print "but does not DROP an table with this name.\n\n";
+	exit(0);
+}
+
+my $pi=3.1415926535897932;
+my $degra=$pi/180.0;
+
+if ($count <= 0) {$count = 10000;}
+if (($radius > 90)||($radius<=0)) {
+	print STDERR "incorrect radius, using 10 degrees instead.\n";
+	$radius = 10;
+}
+if (!defined($seed)) {$seed = 1;}
+srand($seed);
+
+
+print <<END ;
+CREATE TABLE sellipse_pair_data (id int, e1 sellipse, e2 sellipse);
+
+COPY sellipse_pair_data (id, e1, e2) FROM stdin;
+END
+
+
+for (my $i=1; $i<=$count; $i++) {
+    my $a1 = $radius*(0.01+0.99*rand());
+    my $b1 = $a1*(0.01+0.98*rand());
+    my $a2 = $radius*(0.01+0.99*rand());
+    my $b2 = $a2*(0.01+0.98*rand());
+    my $lng = 360*rand();
+    my $lat = 180/$pi*asin_(2*rand()-1);
+    # center of second ellipse: random direction and distance
+    my $d = ($a1+$a2)*rand()*$degra;
+    my $p = 2*$pi*rand();
+    my $lat1 = $lat*$degra;
+    my $lat2 = asin_(sin($lat1)*cos($d)+cos($lat1)*sin($d)*cos($p));
+    my $lng2 = $lng*$degra+atan2(sin($p)*sin($d)*cos($lat1),cos($d)-sin($lat1)*sin($lat2));
+    $lng2 = $lng2/$degra;
+    $lat2 = $lat2/$degra;
+    printf "%d\t<{ %.10fd , %.10fd }, (%.10fd , %.10fd) , %.10fd>\t<{ %.10fd , %.10fd }, (%.10fd , %.10fd) , %.10fd>\n",
+	$i, $a1, $b1, $lng, $lat, 180*rand(), $a2, $b2, $lng2, $lat2, 180*rand();
+}
+
+print "\\.\n\n";
+
+sub asin_ {
+    my $x = shift;
+    return atan2($x, sqrt(1-$x*$x));
+}
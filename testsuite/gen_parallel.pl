@@ -0,0 +1,70 @@
+#!/usr/bin/perl
+
+my $count=$ARGV[0];
+my $seed=$ARGV[1];
+if ($#ARGV == -1) {
+	print "gen_parallel.pl: pg_sphere parallel sequential scan benchmark generator\n";
+	print "usage:\n\tgen_parallel.pl <count> [seed] | psql pgsphere_db\n\n";
+
+	print "Program generates \"count\" random spherical points and\n";
+	print "SQL script to load them into existing database. The \"seed\"\n";
+	print "of random generator defaults to 1, so the same dataset is\n";
+	print "generated on each run. The script runs the same queries\n";
+	print "without an index with 0, 1, 2 and 4 parallel workers.\n";
+	print "PostgreSQL 9.6 or later is needed.\n\n";
+	print "Example: \"gen_parallel.pl 5000000 > parallel.sql\" writes\n";
+	print "five million points. Run the script with timing switched\n";
+	print "on in psql and compare the times per worker count.\n\n";
+	print "Program automatically creates \"spoint_par_data\" table\n";
+	print "but does not DROP an existing table with this name.\n\n";
+	exit(0);
+}
+
+my $pi=3.1415926535897932;
+
+if ($count <= 0) {$count = 1000000;}
+if (!defined($seed)) {$seed = 1;}
+srand($seed);
+
+
+print <<END ;
+CREATE TABLE spoint_par_data (id int, p spoint);
+
+COPY spoint_par_data (id, p) FROM stdin;
+END
+
+
+for (my $i=1; $i<=$count; $i++) {
+    my $lng = 2.0*$pi*rand();
+    my $lat = asin(2.0*rand() - 1.0);
+    printf("%d\t(%.15f,%.15f)\n", $i, $lng, $lat);
+}
+
+print "\\.\n\n";
+
+print <<END ;
+ANALYZE spoint_par_data;
+
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+
+END
+
+foreach my $workers (0, 1, 2, 4) {
+    print <<END ;
+SET max_parallel_workers_per_gather = $workers;
+EXPLAIN (COSTS OFF) SELECT count(*) FROM spoint_par_data WHERE p @ scircle '<(1,0.5),0.3>';
+SELECT count(*) FROM spoint_par_data WHERE p @ scircle '<(1,0.5),0.3>';
+SELECT count(*) FROM spoint_par_data WHERE p @ spoly '{(0,0),(1,0),(1,1),(0,1)}';
+SELECT count(*) FROM spoint_par_data WHERE p @ sellipse '<{0.5,0.1},(2,-0.5),0.7>';
+SELECT sum(p <-> spoint '(1,0.5)') FROM spoint_par_data;
+
+END
+}
+
+print "RESET max_parallel_workers_per_gather;\n";
+
+sub asin {
+    atan2($_[0], sqrt(1 - $_[0] * $_[0]));
+}
@@ -0,0 +1,84 @@
+#!/usr/bin/perl
+
+my $count=$ARGV[0];
+my $N=$ARGV[1];
+my $seed=$ARGV[2];
+if ($#ARGV == -1) {
+	print "gen_poly_out.pl: pg_sphere \"spoly\" output benchmark generator\n";
+	print "usage:\n\tgen_poly_out.pl <count> [N] [seed] | psql pgsphere_db\n\n";
+
+	print "Program generates \"count\" spherical N-side polygons with\n";
+	print "random centers and sizes and SQL script to load them into\n";
+	print "existing database. N defaults to 100, the \"seed\" of random\n";
+	print "generator defaults to 1, so the same dataset is generated on\n";
+	print "each run. The script writes all polygons as text in each of\n";
+	print "the output modes, first with the default output, then with\n";
+	print "extra_float_digits = 3 and with fixed output precision.\n\n";
+	print "Example: \"gen_poly_out.pl 10000 100 > poly_out.sql\" writes\n";
+	print "ten thousand polygons with one million vertices. Run the\n";
+	print "script with timing switched on in psql.\n\n";
+	print "Program automatically creates \"spoly_out_data\" table\n";
+	print "but does not DROP an existing table with this name.\n\n";
+	exit(0);
+}
+
+my $pi=3.1415926535897932;
+
+if ($count <= 0) {$count = 10000;}
+if (!defined($N) || $N < 3) {$N = 100;}
+if (!defined($seed)) {$seed = 1;}
+srand($seed);
+
+
+print <<END ;
+CREATE TABLE spoly_out_data (id int, p spoly);
+
+COPY spoly_out_data (id, p) FROM stdin;
+END
+
+
+for (my $i=1; $i<=$count; $i++) {
+    my $lng = 360.0*rand();
+    my $lat = 160.0*rand() - 80.0;
+    my $r   = 0.01 + 5.0*rand();
+    my $spoly = "{";
+    for (my $nn=0; $nn<$N; $nn++) {
+	my $a = 2.0*$pi*$nn/$N;
+	$spoly .= sprintf("(%.15f,%.15f)",
+			  ($lng + $r*sin($a)/cos($lat*$pi/180.0))*$pi/180.0,
+			  ($lat + $r*cos($a))*$pi/180.0);
+	$spoly .= "," unless ($nn >= ($N-1));
+    }
+    $spoly .= "}";
+    print "$i\t$spoly\n";
+}
+
+print "\\.\n\n";
+
+print <<END ;
+SELECT count(*) FROM spoly_out_data;
+
+SET extra_float_digits = 0;
+SELECT set_sphere_output_precision(-1);
+SELECT set_sphere_output('RAD');
+SELECT sum(length(p::text)) FROM spoly_out_data;
+SELECT set_sphere_output('DEG');
+SELECT sum(length(p::text)) FROM spoly_out_data;
+SELECT set_sphere_output('DMS');
+SELECT sum(length(p::text)) FROM spoly_out_data;
+SELECT set_sphere_output('HMS');
+SELECT sum(length(p::text)) FROM spoly_out_data;
+
+SET extra_float_digits = 3;
+SELECT set_sphere_output('RAD');
+SELECT sum(length(p::text)) FROM spoly_out_data;
+
+SELECT set_sphere_output_precision(8);
+SELECT sum(length(p::text)) FROM spoly_out_data;
+SELECT set_sphere_output('DMS');
+SELECT sum(length(p::text)) FROM spoly_out_data;
+
+RESET extra_float_digits;
+SELECT set_sphere_output_precision(-1);
+SELECT set_sphere_output('RAD');
+END
@@ -9,9 +9,9 @@
 */
 
 /*
-  box was the last added data type
+  the vector point was the last added data type
 */
-#include "box.h"
+#include "point3.h"
 
 /*! \defgroup PGS_DATA_TYPES Data type IDs */
 /*!
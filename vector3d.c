@@ -1,4 +1,9 @@
 #include "vector3d.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /*!
   \file
@@ -36,3 +41,40 @@
   float8 vector3d_length ( const Vector3D * v ){
     return sqrt( sqr(v->x) + sqr(v->y) + sqr(v->z) );
   }
+
+
+  void vector3d_dist2_batch ( float8 * out, const Vector3D * c, const float8 * x, const float8 * y, const float8 * z, int32 n )
+  {
+    int32 i = 0;
+
+#if defined(__AVX__)
+    __m256d cx = _mm256_set1_pd ( c->x );
+    __m256d cy = _mm256_set1_pd ( c->y );
+    __m256d cz = _mm256_set1_pd ( c->z );
+    for ( ; i + 4 <= n; i += 4 ){
+      __m256d dx = _mm256_sub_pd ( _mm256_loadu_pd ( &x[i] ), cx );
+      __m256d dy = _mm256_sub_pd ( _mm256_loadu_pd ( &y[i] ), cy );
+      __m256d dz = _mm256_sub_pd ( _mm256_loadu_pd ( &z[i] ), cz );
+      __m256d d2 = _mm256_add_pd ( _mm256_add_pd ( _mm256_mul_pd ( dx, dx ), _mm256_mul_pd ( dy, dy ) ), _mm256_mul_pd ( dz, dz ) );
+      _mm256_storeu_pd ( &out[i], d2 );
+    }
+#elif defined(__SSE2__)
+    __m128d cx = _mm_set1_pd ( c->x );
+    __m128d cy = _mm_set1_pd ( c->y );
+    __m128d cz = _mm_set1_pd ( c->z );
+    for ( ; i + 2 <= n; i += 2 ){
+      __m128d dx = _mm_sub_pd ( _mm_loadu_pd ( &x[i] ), cx );
+      __m128d dy = _mm_sub_pd ( _mm_loadu_pd ( &y[i] ), cy );
+      __m128d dz = _mm_sub_pd ( _mm_loadu_pd ( &z[i] ), cz );
+      __m128d d2 = _mm_add_pd ( _mm_add_pd ( _mm_mul_pd ( dx, dx ), _mm_mul_pd ( dy, dy ) ), _mm_mul_pd ( dz, dz ) );
+      _mm_storeu_pd ( &out[i], d2 );
+    }
+#endif
+    // scalar rest, the same operations in the same order
+    for ( ; i < n; i++ ){
+      float8 dx = x[i] - c->x;
+      float8 dy = y[i] - c->y;
+      float8 dz = z[i] - c->z;
+      out[i] = dx * dx + dy * dy + dz * dz;
+    }
+  }
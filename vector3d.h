@@ -54,4 +54,19 @@ float8 vector3d_scalar ( Vector3D * v1 , Vector3D * v2 );
 */
 float8 vector3d_length ( const Vector3D * v );
 
+/*!
+  Calculates the squared distances of unit vectors to a unit vector,
+  i.e. the squared chord lengths. The vectors are given as separate
+  arrays of coordinates, so the loop runs on SSE2 or AVX registers
+  when the compiler targets them.
+  \brief squared distances of many vectors to one vector
+  \param out pointer to n results
+  \param c   pointer to vector
+  \param x   pointer to n x values
+  \param y   pointer to n y values
+  \param z   pointer to n z values
+  \param n   count of vectors
+*/
+void vector3d_dist2_batch ( float8 * out, const Vector3D * c, const float8 * x, const float8 * y, const float8 * z, int32 n );
+
 #endif